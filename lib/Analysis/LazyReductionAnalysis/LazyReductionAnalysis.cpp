@@ -0,0 +1,153 @@
+#include "lib/Analysis/LazyReductionAnalysis/LazyReductionAnalysis.h"
+
+#include <cstdint>
+
+#include "lib/Dialect/ModArith/IR/ModArithOps.h"
+#include "lib/Dialect/ModArith/IR/ModArithTypes.h"
+#include "llvm/include/llvm/ADT/APInt.h"                   // from @llvm-project
+#include "llvm/include/llvm/ADT/STLExtras.h"               // from @llvm-project
+#include "llvm/include/llvm/ADT/TypeSwitch.h"              // from @llvm-project
+#include "llvm/include/llvm/Support/Debug.h"               // from @llvm-project
+#include "llvm/include/llvm/Support/MathExtras.h"          // from @llvm-project
+#include "mlir/include/mlir/Analysis/DataFlowFramework.h"  // from @llvm-project
+#include "mlir/include/mlir/Dialect/Linalg/IR/Linalg.h"    // from @llvm-project
+#include "mlir/include/mlir/Dialect/Tensor/IR/Tensor.h"    // from @llvm-project
+#include "mlir/include/mlir/IR/Operation.h"                // from @llvm-project
+#include "mlir/include/mlir/IR/TypeUtilities.h"            // from @llvm-project
+#include "mlir/include/mlir/IR/Value.h"                    // from @llvm-project
+#include "mlir/include/mlir/Interfaces/ControlFlowInterfaces.h"  // from @llvm-project
+#include "mlir/include/mlir/Support/LLVM.h"                // from @llvm-project
+
+#define DEBUG_TYPE "lazy-reduction-analysis"
+
+namespace mlir {
+namespace heir {
+
+uint64_t getReductionBound(const DataFlowSolver &solver, Value value) {
+  auto *lattice = solver.lookupState<ReductionBoundLattice>(value);
+  if (!lattice || lattice->getValue().isCanonical()) return 1;
+  return lattice->getValue().getBound();
+}
+
+bool fitsLazily(mod_arith::ModArithType type, uint64_t bound) {
+  APInt modulus = type.getModulus().getValue();
+  unsigned width = modulus.getBitWidth();
+  // Wide enough for the product of a w-bit modulus and a 64-bit bound.
+  unsigned productWidth = width + 64;
+  APInt product =
+      modulus.zext(productWidth) * APInt(productWidth, bound);
+  return product.ule(APInt::getOneBitSet(productWidth, width - 1));
+}
+
+uint64_t getAddSubBound(mod_arith::ModArithType type, uint64_t lhs,
+                        uint64_t rhs) {
+  uint64_t bound = llvm::SaturatingAdd(lhs, rhs);
+  return fitsLazily(type, bound) ? bound : 1;
+}
+
+bool isReductionBoundStore(Operation *op) {
+  return isa<tensor::InsertOp, tensor::InsertSliceOp, tensor::FromElementsOp,
+             tensor::SplatOp>(op);
+}
+
+bool isReductionBoundTerminator(Operation *op) {
+  Operation *parent = op->getParentOp();
+  if (isa<linalg::YieldOp>(op))
+    return isa_and_nonnull<linalg::GenericOp>(parent);
+  return isa<RegionBranchTerminatorOpInterface>(op) &&
+         isa_and_nonnull<RegionBranchOpInterface>(parent);
+}
+
+bool acceptsUnreduced(Operation *user) {
+  return isa<mod_arith::AddOp, mod_arith::SubOp, mod_arith::MulOp,
+             mod_arith::MacOp, mod_arith::ReduceOp, tensor::ExtractOp,
+             tensor::ExtractSliceOp, linalg::GenericOp>(user) ||
+         isReductionBoundStore(user) || isReductionBoundTerminator(user);
+}
+
+// Returns the bound of the result of a lazily lowered mul or mac. Skipping
+// the corrections of the Barrett reduction only pays off if the product is
+// combined further before it is reduced, so a product with a consumer that
+// needs a canonical value is reduced fully.
+static uint64_t getProductBound(Operation *op, bool lazyProducts) {
+  auto type = cast<mod_arith::ModArithType>(
+      getElementTypeOrSelf(op->getResult(0).getType()));
+  // A Barrett reduction without its conditional subtractions is below 3q.
+  if (!lazyProducts || !fitsLazily(type, 3)) return 1;
+  return llvm::all_of(op->getUsers(), acceptsUnreduced) ? 3 : 1;
+}
+
+void LazyReductionAnalysis::join(Value value, const ReductionBound &bound) {
+  ReductionBoundLattice *lattice = getLatticeElement(value);
+  propagateIfChanged(lattice, lattice->join(bound));
+
+  // A value yielded by the body of a linalg.generic flows into the matching
+  // result, and into the output block argument of the next iteration.
+  for (OpOperand &use : value.getUses()) {
+    if (!isa<linalg::YieldOp>(use.getOwner())) continue;
+    auto genericOp = dyn_cast<linalg::GenericOp>(use.getOwner()->getParentOp());
+    if (!genericOp) continue;
+    unsigned index = use.getOperandNumber();
+    for (Value target : {Value(genericOp->getResult(index)),
+                         Value(genericOp.getRegionOutputArgs()[index])}) {
+      ReductionBoundLattice *targetLattice = getLatticeElement(target);
+      propagateIfChanged(targetLattice,
+                         targetLattice->join(lattice->getValue()));
+    }
+  }
+}
+
+LogicalResult LazyReductionAnalysis::visitOperation(
+    Operation *op, ArrayRef<const ReductionBoundLattice *> operands,
+    ArrayRef<ReductionBoundLattice *> results) {
+  auto operandBound = [&](const ReductionBoundLattice *lattice) {
+    const ReductionBound &bound = lattice->getValue();
+    return bound.isCanonical() ? 1 : bound.getBound();
+  };
+  // The largest bound of all operands, for ops that only move values around.
+  auto joinedOperandBound = [&]() {
+    ReductionBound bound(1);
+    for (const ReductionBoundLattice *operand : operands)
+      bound = ReductionBound::join(bound, operand->getValue());
+    return bound;
+  };
+
+  llvm::TypeSwitch<Operation &>(*op)
+      .Case<mod_arith::AddOp, mod_arith::SubOp>([&](auto addSubOp) {
+        auto type = mod_arith::getResultModArithType(addSubOp);
+        uint64_t bound = getAddSubBound(type, operandBound(operands[0]),
+                                        operandBound(operands[1]));
+        LLVM_DEBUG(llvm::dbgs() << "Visiting: " << addSubOp->getName()
+                                << ", bound " << bound << "\n");
+        join(addSubOp->getResult(0), ReductionBound(bound));
+      })
+      .Case<mod_arith::MulOp, mod_arith::MacOp>([&](auto mulOp) {
+        join(mulOp->getResult(0),
+             ReductionBound(getProductBound(mulOp, lazyProducts)));
+      })
+      .Case<tensor::ExtractOp, tensor::ExtractSliceOp, tensor::InsertOp,
+            tensor::InsertSliceOp, tensor::FromElementsOp, tensor::SplatOp>(
+          [&](auto tensorOp) {
+            join(tensorOp->getResult(0), joinedOperandBound());
+          })
+      .Case<linalg::GenericOp>([&](linalg::GenericOp genericOp) {
+        // Each block argument sees the elements of its operand. The results
+        // start from the outputs, in case the body never runs.
+        for (OpOperand &operand : genericOp->getOpOperands()) {
+          ReductionBound bound =
+              operands[operand.getOperandNumber()]->getValue();
+          join(genericOp.getMatchingBlockArgument(&operand), bound);
+          if (genericOp.isDpsInit(&operand))
+            join(genericOp.getTiedOpResult(&operand), bound);
+        }
+      })
+      .Default([&](Operation &defaultOp) {
+        // All other ops produce canonical values.
+        for (Value result : defaultOp.getResults())
+          join(result, ReductionBound(1));
+      });
+  return mlir::success();
+}
+
+}  // namespace heir
+}  // namespace mlir
@@ -0,0 +1,175 @@
+#ifndef LIB_ANALYSIS_LAZYREDUCTIONANALYSIS_LAZYREDUCTIONANALYSIS_H_
+#define LIB_ANALYSIS_LAZYREDUCTIONANALYSIS_LAZYREDUCTIONANALYSIS_H_
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <optional>
+
+#include "lib/Dialect/ModArith/IR/ModArithTypes.h"
+#include "mlir/include/mlir/Analysis/DataFlow/SparseAnalysis.h"  // from @llvm-project
+#include "mlir/include/mlir/Analysis/DataFlowFramework.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/Diagnostics.h"              // from @llvm-project
+#include "mlir/include/mlir/IR/Operation.h"                // from @llvm-project
+#include "mlir/include/mlir/IR/Value.h"                    // from @llvm-project
+
+namespace mlir {
+namespace heir {
+
+/// A bound on the integer representative of a mod_arith value after lowering
+/// with lazy reduction.
+///
+/// A bound of `b` for a value of type `!mod_arith.int<q : iw>` states that the
+/// value is represented by a non-negative integer smaller than `b * q`. A bound
+/// of 1 means the value is canonical, i.e., in [0, q). Values with a larger
+/// bound are congruent to, but not necessarily equal to, their canonical
+/// representative.
+class ReductionBound {
+ public:
+  ReductionBound() : bound(std::nullopt) {}
+  explicit ReductionBound(uint64_t bound) : bound(bound) {}
+  ~ReductionBound() = default;
+
+  /// Whether the bound is initialized. It can be uninitialized when the state
+  /// hasn't been set during the analysis.
+  bool isInitialized() const { return bound.has_value(); }
+
+  const uint64_t &getBound() const {
+    assert(isInitialized());
+    return *bound;
+  }
+
+  /// Whether the value is known to be canonical.
+  bool isCanonical() const { return !isInitialized() || getBound() <= 1; }
+
+  bool operator==(const ReductionBound &rhs) const {
+    return bound == rhs.bound;
+  }
+
+  /// Join two bounds, keeping the larger one for soundness.
+  static ReductionBound join(const ReductionBound &lhs,
+                             const ReductionBound &rhs) {
+    if (!lhs.isInitialized()) return rhs;
+    if (!rhs.isInitialized()) return lhs;
+    return ReductionBound{std::max(lhs.getBound(), rhs.getBound())};
+  }
+
+  void print(raw_ostream &os) const {
+    if (isInitialized()) {
+      os << "ReductionBound(" << getBound() << ")";
+      return;
+    }
+    os << "ReductionBound(uninitialized)";
+  }
+
+ private:
+  std::optional<uint64_t> bound;
+
+  friend mlir::Diagnostic &operator<<(mlir::Diagnostic &diagnostic,
+                                      const ReductionBound &bound) {
+    if (bound.isInitialized()) {
+      return diagnostic << bound.getBound();
+    }
+    return diagnostic << "ReductionBound(uninitialized)";
+  }
+};
+
+inline raw_ostream &operator<<(raw_ostream &os, const ReductionBound &v) {
+  v.print(os);
+  return os;
+}
+
+class ReductionBoundLattice : public dataflow::Lattice<ReductionBound> {
+ public:
+  using Lattice::Lattice;
+};
+
+/// An analysis that determines which `mod_arith` ops may skip (part of) their
+/// modular reduction when lowered, and bounds the resulting unreduced values.
+///
+/// The lowering of an add or sub whose operands have bounds `a` and `b`
+/// produces a value smaller than `(a + b) * q` before reduction. The reduction
+/// is skipped whenever this value is guaranteed to stay below `2^(w-1)`, so
+/// that it remains non-negative when interpreted as a signed integer of the
+/// storage width `w` and a subsequent `mod_arith.reduce` still applies. Such a
+/// chain of adds and subs is then reduced only once, by the first op that
+/// would overflow or by the consumer of the chain.
+///
+/// `mod_arith.mul` and `mod_arith.mac` accept unreduced operands, because they
+/// compute in double width. With `lazyProducts`, the Barrett reduction of a
+/// product whose consumers all accept unreduced values skips its final
+/// conditional subtractions and leaves the result in `[0, 3q)`. In particular,
+/// a `mac` accumulating into a loop-carried value never reduces fully.
+///
+/// Bounds flow through `tensor` ops that insert or extract elements, into the
+/// body of a `linalg.generic` and from its `linalg.yield` to its results and
+/// output block arguments, and through the results and iter_args of region
+/// branch ops like `scf.for` and `affine.for`. All other ops, including
+/// function returns and `mod_arith.extract`, are expected to only see
+/// canonical values. Hence, values of unknown origin, like function arguments,
+/// are assumed canonical.
+///
+///     LazyBound(z) = case
+///       add(x, y), sub(x, y):
+///         let b = LazyBound(x) + LazyBound(y) in
+///           b * q <= 2^(w-1) ? b : 1
+///       mul(x, y), mac(x, y, acc):
+///         lazyProducts && 3 * q <= 2^(w-1) && acceptsUnreduced(users) ? 3 : 1
+///       tensor.extract(t), tensor.insert(x, t), linalg.yield(x), ...:
+///         max of the bounds of the operands
+///       any_op(operands):
+///         1
+class LazyReductionAnalysis
+    : public dataflow::SparseForwardDataFlowAnalysis<ReductionBoundLattice> {
+ public:
+  explicit LazyReductionAnalysis(DataFlowSolver &solver,
+                                 bool lazyProducts = false)
+      : SparseForwardDataFlowAnalysis(solver), lazyProducts(lazyProducts) {}
+  ~LazyReductionAnalysis() override = default;
+
+  LogicalResult visitOperation(
+      Operation *op, ArrayRef<const ReductionBoundLattice *> operands,
+      ArrayRef<ReductionBoundLattice *> results) override;
+
+  // Values of unknown origin are canonical.
+  void setToEntryState(ReductionBoundLattice *lattice) override {
+    propagateIfChanged(lattice, lattice->join(ReductionBound(1)));
+  }
+
+ private:
+  // Joins `bound` into the lattice of `value`, and forwards it to the
+  // enclosing linalg.generic if `value` is yielded by its body.
+  void join(Value value, const ReductionBound &bound);
+
+  bool lazyProducts;
+};
+
+/// Returns the bound of `value` computed by a LazyReductionAnalysis loaded in
+/// `solver`, or 1 if the value has no bound.
+uint64_t getReductionBound(const DataFlowSolver &solver, Value value);
+
+/// Returns true if a value of type `type` with the given bound is guaranteed to
+/// be non-negative when interpreted as a signed integer of the storage width.
+bool fitsLazily(mod_arith::ModArithType type, uint64_t bound);
+
+/// Returns the bound of the result of a lazily lowered add or sub with operand
+/// bounds `lhs` and `rhs`, or 1 if the op must reduce its result.
+uint64_t getAddSubBound(mod_arith::ModArithType type, uint64_t lhs,
+                        uint64_t rhs);
+
+/// Returns true if `op` stores a mod_arith value into a container, whose bound
+/// is then the largest bound of the stored values.
+bool isReductionBoundStore(Operation *op);
+
+/// Returns true if `op` is a terminator whose operands flow into the results
+/// or block arguments of its parent op, along with their bounds.
+bool isReductionBoundTerminator(Operation *op);
+
+/// Returns true if `user` may consume an unreduced value, either because it is
+/// lowered lazily or because the analysis forwards the bound to its results.
+bool acceptsUnreduced(Operation *user);
+
+}  // namespace heir
+}  // namespace mlir
+
+#endif  // LIB_ANALYSIS_LAZYREDUCTIONANALYSIS_LAZYREDUCTIONANALYSIS_H_
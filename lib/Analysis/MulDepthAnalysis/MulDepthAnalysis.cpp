@@ -2,6 +2,8 @@
 
 #include <cassert>
 
+#include "lib/Dialect/BGV/IR/BGVOps.h"
+#include "lib/Dialect/CKKS/IR/CKKSOps.h"
 #include "lib/Dialect/Openfhe/IR/OpenfheOps.h"
 #include "llvm/include/llvm/ADT/TypeSwitch.h"              // from @llvm-project
 #include "llvm/include/llvm/Support/Debug.h"               // from @llvm-project
@@ -16,43 +18,38 @@
 namespace mlir {
 namespace heir {
 
-// Currently, this analysis targets the OpenFHE configuration.
-// Since OpenFHE conservatively calculates multiplicative depth, it considers
-// MulPlain and MulConst operations to consume a depth of 1. Therefore, the same
-// approach has been applied here.
+// Currently, this analysis targets the OpenFHE configuration and the BGV and
+// CKKS ops that lower to it. Since OpenFHE conservatively calculates
+// multiplicative depth, it considers MulPlain and MulConst operations to
+// consume a depth of 1. Therefore, the same approach has been applied here.
 
 LogicalResult MulDepthAnalysis::visitOperation(
     Operation *op, ArrayRef<const MulDepthLattice *> operands,
     ArrayRef<MulDepthLattice *> results) {
   llvm::TypeSwitch<Operation &>(*op)
       .Case<openfhe::MulOp, openfhe::MulPlainOp, openfhe::MulConstOp,
-            openfhe::MulNoRelinOp>([&](auto mulOp) {
+            openfhe::MulNoRelinOp, bgv::MulOp, bgv::MulPlainOp, ckks::MulOp,
+            ckks::MulPlainOp>([&](auto mulOp) {
         // In this case, 1 + (the maximum multiplicative depth among the
-        // operands) becomes the multiplicative depth of the operation.
+        // operands) becomes the multiplicative depth of the operation. The
+        // crypto context operand of the openfhe ops is never initialized.
         LLVM_DEBUG(llvm::dbgs()
                    << "Visiting Mul: " << mulOp->getName() << "\n");
         // There should be only one result.
         assert(results.size() == 1);
         MulDepthLattice *r = results[0];
-        MulDepth lhsMulDepth = operands[1]->getValue();
-        if (lhsMulDepth.isInitialized()) {
-          lhsMulDepth = MulDepth{lhsMulDepth.getValue() + 1};
-        } else {
-          // if lhs is not initialized, consider it as 0 (and then add 1).
-          lhsMulDepth = MulDepth{1};
-        }
-        MulDepth rhsMulDepth = operands[2]->getValue();
-        if (rhsMulDepth.isInitialized()) {
-          rhsMulDepth = MulDepth{rhsMulDepth.getValue() + 1};
-        } else {
-          // if rhs is not initialized, consider it as 0 (and then add 1).
-          rhsMulDepth = MulDepth{1};
+        // if no operand is initialized, consider the depth as 0 (and then
+        // add 1).
+        MulDepth operandsMulDepth{0};
+        for (const MulDepthLattice *operand : operands) {
+          operandsMulDepth =
+              MulDepth::join(operandsMulDepth, operand->getValue());
         }
         LLVM_DEBUG({
-          llvm::dbgs() << "lhsMulDepth: " << lhsMulDepth << "\n";
-          llvm::dbgs() << "rhsMulDepth: " << rhsMulDepth << "\n";
+          llvm::dbgs() << "operandsMulDepth: " << operandsMulDepth << "\n";
         });
-        ChangeResult result = r->join(MulDepth::join(lhsMulDepth, rhsMulDepth));
+        ChangeResult result =
+            r->join(MulDepth{operandsMulDepth.getValue() + 1});
         propagateIfChanged(r, result);
         LLVM_DEBUG({
           llvm::dbgs() << "MulDepth: " << results[0]->getValue() << "\n";
@@ -0,0 +1,161 @@
+#include "lib/Analysis/NoiseAnalysis/NoiseAnalysis.h"
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+
+#include "lib/Dialect/BGV/IR/BGVOps.h"
+#include "lib/Dialect/CKKS/IR/CKKSOps.h"
+#include "lib/Dialect/LWE/IR/LWETypes.h"
+#include "lib/Dialect/Openfhe/IR/OpenfheOps.h"
+#include "llvm/include/llvm/ADT/STLExtras.h"               // from @llvm-project
+#include "llvm/include/llvm/ADT/SmallVector.h"             // from @llvm-project
+#include "llvm/include/llvm/ADT/TypeSwitch.h"              // from @llvm-project
+#include "llvm/include/llvm/Support/Debug.h"               // from @llvm-project
+#include "mlir/include/mlir/Analysis/DataFlowFramework.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/Operation.h"                // from @llvm-project
+#include "mlir/include/mlir/IR/Value.h"                    // from @llvm-project
+#include "mlir/include/mlir/Support/LLVM.h"                // from @llvm-project
+
+#define DEBUG_TYPE "noise-analysis"
+
+namespace mlir {
+namespace heir {
+
+namespace {
+// The standard deviation of the error distribution.
+constexpr double kErrorStdDev = 3.19;
+}  // namespace
+
+double log2Sum(double a, double b) {
+  double larger = std::max(a, b);
+  double smaller = std::min(a, b);
+  return larger + std::log2(1 + std::exp2(smaller - larger));
+}
+
+double NoiseModel::log2Expansion() const {
+  return 1 + 0.5 * std::log2(static_cast<double>(ringDimension));
+}
+
+double NoiseModel::log2Fresh() const {
+  // e0 + e1 * s + e * u for an encryption randomness u.
+  double expansion = std::exp2(log2Expansion());
+  return std::log2(kErrorStdDev * (1 + 2 * expansion)) +
+         (ckks ? 0 : log2PlainMod);
+}
+
+double NoiseModel::log2Scale() const {
+  // The rounding of c0 + c1 * s.
+  double expansion = std::exp2(log2Expansion());
+  return std::log2((1 + expansion) / 2) + (ckks ? 0 : log2PlainMod);
+}
+
+double NoiseModel::log2KeySwitch() const {
+  // The rounding by the special modulus, on top of the rounding noise of the
+  // switched ciphertext.
+  return log2Scale() + 1;
+}
+
+double NoiseAnalysis::getRescaledBound(const NoiseBound &bound) {
+  if (!bound.isProduct()) return bound.getLog2Bound();
+  if (model.ckks) return log2Sum(bound.getLog2Bound(), model.log2Scale());
+  maxLog2RescaleModulus = std::max(maxLog2RescaleModulus,
+                                   bound.getLog2Bound() - model.log2Scale());
+  // The noise divided by the rescaling modulus is at most the rounding noise.
+  return model.log2Scale() + 1;
+}
+
+void NoiseAnalysis::setToEntryState(NoiseLattice *lattice) {
+  if (isa<lwe::RLWECiphertextType>(lattice->getAnchor().getType())) {
+    propagateIfChanged(lattice, lattice->join(NoiseBound(model.log2Fresh())));
+    return;
+  }
+  propagateIfChanged(lattice, lattice->join(NoiseBound()));
+}
+
+LogicalResult NoiseAnalysis::visitOperation(
+    Operation *op, ArrayRef<const NoiseLattice *> operands,
+    ArrayRef<NoiseLattice *> results) {
+  auto propagate = [&](const NoiseBound &bound) {
+    LLVM_DEBUG(llvm::dbgs() << "Visiting: " << op->getName() << ", bound "
+                            << bound << "\n");
+    for (NoiseLattice *result : results) {
+      propagateIfChanged(result, result->join(bound));
+    }
+  };
+  // The ciphertext operands, whose bounds are initialized. The crypto context
+  // and plaintext operands are never initialized.
+  SmallVector<NoiseBound> bounds;
+  for (const NoiseLattice *operand : operands) {
+    if (operand->getValue().isInitialized())
+      bounds.push_back(operand->getValue());
+  }
+  NoiseBound joined;
+  for (const NoiseBound &bound : bounds) {
+    joined = NoiseBound::join(joined, bound);
+  }
+
+  llvm::TypeSwitch<Operation &>(*op)
+      .Case<openfhe::EncryptOp>(
+          [&](auto) { propagate(NoiseBound(model.log2Fresh())); })
+      .Case<openfhe::AddOp, openfhe::SubOp, openfhe::AddPlainOp, bgv::AddOp,
+            bgv::SubOp, bgv::AddPlainOp, bgv::SubPlainOp, ckks::AddOp,
+            ckks::SubOp, ckks::AddPlainOp, ckks::SubPlainOp>([&](auto) {
+        if (bounds.empty()) return;
+        double sum = bounds.front().getLog2Bound();
+        for (const NoiseBound &bound : llvm::drop_begin(bounds)) {
+          sum = log2Sum(sum, bound.getLog2Bound());
+        }
+        propagate(NoiseBound(sum, joined.isProduct()));
+      })
+      .Case<openfhe::MulOp, openfhe::MulNoRelinOp, openfhe::SquareOp,
+            bgv::MulOp, ckks::MulOp>([&](auto) {
+        if (bounds.empty()) return;
+        double lhs = getRescaledBound(bounds.front());
+        double rhs = bounds.size() > 1 ? getRescaledBound(bounds[1]) : lhs;
+        double product = model.ckks ? log2Sum(lhs, rhs) : lhs + rhs;
+        product += model.log2Expansion();
+        if (isa<openfhe::MulOp, openfhe::SquareOp>(op)) {
+          // OpenFHE relinearizes these products.
+          product = log2Sum(product, model.log2KeySwitch());
+        }
+        propagate(NoiseBound(product, /*product=*/true));
+      })
+      .Case<openfhe::MulPlainOp, bgv::MulPlainOp, ckks::MulPlainOp>(
+          [&](auto) {
+            if (bounds.empty()) return;
+            // BGV plaintext coefficients are bounded by t / 2.
+            double product = getRescaledBound(bounds.front()) +
+                             model.log2Expansion() +
+                             (model.ckks ? 0 : model.log2PlainMod - 1);
+            propagate(NoiseBound(product, /*product=*/true));
+          })
+      .Case<openfhe::MulConstOp>([&](auto) {
+        if (bounds.empty()) return;
+        double product = getRescaledBound(bounds.front()) +
+                         (model.ckks ? 0 : model.log2PlainMod - 1);
+        propagate(NoiseBound(product, /*product=*/true));
+      })
+      .Case<openfhe::RotOp, openfhe::FastRotationOp, openfhe::AutomorphOp,
+            openfhe::KeySwitchOp, openfhe::RelinOp, bgv::RotateOp,
+            bgv::RelinearizeOp, ckks::RotateOp, ckks::RelinearizeOp>(
+          [&](auto) {
+            if (!joined.isInitialized()) return;
+            propagate(NoiseBound(
+                log2Sum(joined.getLog2Bound(), model.log2KeySwitch()),
+                joined.isProduct()));
+          })
+      .Case<openfhe::ModReduceOp, bgv::ModulusSwitchOp, ckks::RescaleOp>(
+          [&](auto) {
+            if (!joined.isInitialized()) return;
+            NoiseBound product(joined.getLog2Bound(), /*product=*/true);
+            propagate(NoiseBound(getRescaledBound(product)));
+          })
+      .Default([&](Operation &) {
+        if (joined.isInitialized()) propagate(joined);
+      });
+  return success();
+}
+
+}  // namespace heir
+}  // namespace mlir
@@ -0,0 +1,166 @@
+#ifndef LIB_ANALYSIS_NOISEANALYSIS_NOISEANALYSIS_H_
+#define LIB_ANALYSIS_NOISEANALYSIS_NOISEANALYSIS_H_
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <optional>
+
+#include "mlir/include/mlir/Analysis/DataFlow/SparseAnalysis.h"  // from @llvm-project
+#include "mlir/include/mlir/Analysis/DataFlowFramework.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/Diagnostics.h"              // from @llvm-project
+#include "mlir/include/mlir/IR/Operation.h"                // from @llvm-project
+#include "mlir/include/mlir/IR/Value.h"                    // from @llvm-project
+
+namespace mlir {
+namespace heir {
+
+/// A bound on the noise of a ciphertext.
+///
+/// The bound is the base 2 logarithm of a heuristic bound on the canonical
+/// embedding norm of the noise. A ciphertext is a product when it has been
+/// multiplied since its last modulus switch or rescale, in which case OpenFHE
+/// rescales it before multiplying it again.
+class NoiseBound {
+ public:
+  NoiseBound() : log2Bound(std::nullopt), product(false) {}
+  explicit NoiseBound(double log2Bound, bool product = false)
+      : log2Bound(log2Bound), product(product) {}
+  ~NoiseBound() = default;
+
+  /// Whether the bound is initialized. It can be uninitialized when the state
+  /// hasn't been set during the analysis, or for values that are not
+  /// ciphertexts.
+  bool isInitialized() const { return log2Bound.has_value(); }
+
+  double getLog2Bound() const {
+    assert(isInitialized());
+    return *log2Bound;
+  }
+
+  bool isProduct() const { return product; }
+
+  bool operator==(const NoiseBound &rhs) const {
+    return log2Bound == rhs.log2Bound && product == rhs.product;
+  }
+
+  /// Join two bounds, keeping the larger one for soundness.
+  static NoiseBound join(const NoiseBound &lhs, const NoiseBound &rhs) {
+    if (!lhs.isInitialized()) return rhs;
+    if (!rhs.isInitialized()) return lhs;
+    return NoiseBound{std::max(lhs.getLog2Bound(), rhs.getLog2Bound()),
+                      lhs.isProduct() || rhs.isProduct()};
+  }
+
+  void print(raw_ostream &os) const {
+    if (isInitialized()) {
+      os << "NoiseBound(2^" << getLog2Bound() << (product ? ", product" : "")
+         << ")";
+      return;
+    }
+    os << "NoiseBound(uninitialized)";
+  }
+
+ private:
+  std::optional<double> log2Bound;
+  bool product;
+
+  friend mlir::Diagnostic &operator<<(mlir::Diagnostic &diagnostic,
+                                      const NoiseBound &bound) {
+    if (bound.isInitialized()) {
+      return diagnostic << "2^" << bound.getLog2Bound();
+    }
+    return diagnostic << "NoiseBound(uninitialized)";
+  }
+};
+
+inline raw_ostream &operator<<(raw_ostream &os, const NoiseBound &v) {
+  v.print(os);
+  return os;
+}
+
+class NoiseLattice : public dataflow::Lattice<NoiseBound> {
+ public:
+  using Lattice::Lattice;
+};
+
+/// The parameters of the noise model of BGV and CKKS ciphertexts.
+///
+/// The bounds follow the usual heuristics for ternary secrets and Gaussian
+/// errors of standard deviation 3.19, where the canonical embedding norm of a
+/// product is bounded by the expansion factor 2 sqrt(n) times the product of
+/// the norms. BGV noise includes the factor of the plaintext modulus, and
+/// CKKS noise is relative to the scaling factor after rescaling.
+struct NoiseModel {
+  /// The ring dimension n.
+  int64_t ringDimension;
+  /// The base 2 logarithm of the plaintext modulus, ignored for CKKS.
+  double log2PlainMod;
+  bool ckks;
+
+  /// log2 of the expansion factor 2 sqrt(n).
+  double log2Expansion() const;
+  /// log2 of the noise of a fresh encryption.
+  double log2Fresh() const;
+  /// log2 of the rounding noise added by a modulus switch or rescale.
+  double log2Scale() const;
+  /// log2 of the noise added by a hybrid key switch.
+  double log2KeySwitch() const;
+};
+
+/// An analysis that bounds the noise of each ciphertext in a program of
+/// `openfhe`, `bgv` or `ckks` ops.
+///
+/// Ciphertexts of unknown origin, like function arguments, are fresh
+/// encryptions. As in OpenFHE's automatic rescaling, products are rescaled
+/// right before they are multiplied again. For BGV, the analysis assumes that
+/// each rescale divides by a prime large enough to bring the noise down to the
+/// rounding noise, and records the largest such prime in
+/// `getMaxLog2RescaleModulus`.
+///
+///     Noise(z) = case
+///       encrypt(x):              fresh
+///       add(x, y), sub(x, y):    Noise(x) + Noise(y)
+///       mul(x, y):               expansion * Noise(x') * Noise(y') + keyswitch
+///       mul_plain(x, p):         expansion * t / 2 * Noise(x')
+///       rotate(x), relinearize(x):
+///                                Noise(x) + keyswitch
+///       modulus_switch(x):       scale + (BGV ? scale : Noise(x))
+///       any_op(operands):        max(map(Noise, operands))
+///
+/// where x' is x rescaled if x is a product, and CKKS products use
+/// expansion * (Noise(x') + Noise(y')) instead, relative to the scaling
+/// factor.
+class NoiseAnalysis
+    : public dataflow::SparseForwardDataFlowAnalysis<NoiseLattice> {
+ public:
+  NoiseAnalysis(DataFlowSolver &solver, const NoiseModel &model)
+      : SparseForwardDataFlowAnalysis(solver), model(model) {}
+  ~NoiseAnalysis() override = default;
+
+  LogicalResult visitOperation(Operation *op,
+                               ArrayRef<const NoiseLattice *> operands,
+                               ArrayRef<NoiseLattice *> results) override;
+
+  // Ciphertexts of unknown origin are fresh encryptions.
+  void setToEntryState(NoiseLattice *lattice) override;
+
+  /// The base 2 logarithm of the largest modulus a BGV rescale divides by.
+  double getMaxLog2RescaleModulus() const { return maxLog2RescaleModulus; }
+
+  /// Returns the log2 bound of a ciphertext after rescaling it if it is a
+  /// product, as OpenFHE does before multiplications and decryption.
+  double getRescaledBound(const NoiseBound &bound);
+
+ private:
+  NoiseModel model;
+  double maxLog2RescaleModulus = 0;
+};
+
+/// Returns log2(2^a + 2^b).
+double log2Sum(double a, double b);
+
+}  // namespace heir
+}  // namespace mlir
+
+#endif  // LIB_ANALYSIS_NOISEANALYSIS_NOISEANALYSIS_H_
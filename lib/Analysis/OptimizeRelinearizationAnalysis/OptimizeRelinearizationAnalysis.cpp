@@ -1,14 +1,19 @@
 #include "lib/Analysis/OptimizeRelinearizationAnalysis/OptimizeRelinearizationAnalysis.h"
 
-#include <cassert>
+#include <cstdint>
 #include <sstream>
 #include <string>
 #include <utility>
 
 #include "lib/Dialect/BGV/IR/BGVOps.h"
 #include "lib/Dialect/LWE/IR/LWETypes.h"
+#include "lib/Dialect/ModArith/IR/ModArithTypes.h"
+#include "lib/Dialect/Polynomial/IR/PolynomialAttributes.h"
 #include "llvm/include/llvm/ADT/DenseMap.h"             // from @llvm-project
+#include "llvm/include/llvm/ADT/DenseSet.h"             // from @llvm-project
+#include "llvm/include/llvm/ADT/EquivalenceClasses.h"   // from @llvm-project
 #include "llvm/include/llvm/ADT/STLExtras.h"            // from @llvm-project
+#include "llvm/include/llvm/ADT/SmallVector.h"          // from @llvm-project
 #include "llvm/include/llvm/ADT/TypeSwitch.h"           // from @llvm-project
 #include "llvm/include/llvm/Support/Casting.h"          // from @llvm-project
 #include "llvm/include/llvm/Support/Debug.h"            // from @llvm-project
@@ -16,6 +21,7 @@
 #include "mlir/include/mlir/Dialect/Func/IR/FuncOps.h"  // from @llvm-project
 #include "mlir/include/mlir/IR/BuiltinOps.h"            // from @llvm-project
 #include "mlir/include/mlir/IR/Operation.h"             // from @llvm-project
+#include "mlir/include/mlir/IR/Threading.h"             // from @llvm-project
 #include "mlir/include/mlir/IR/Value.h"                 // from @llvm-project
 #include "mlir/include/mlir/IR/ValueRange.h"            // from @llvm-project
 #include "mlir/include/mlir/Support/LLVM.h"             // from @llvm-project
@@ -39,10 +45,17 @@
 // assumptions made here anyway.
 //
 // For now, fix the key basis degree bound to 3. Could make it a pass flag
-// later, or introduce costs for high-degree operations and let it be
-// unconstrained.
+// later. The bound also keeps the cost of a multiplication linear in the key
+// basis degrees of its operands, see the objective below.
 constexpr int MAX_KEY_BASIS_DEGREE = 3;
-constexpr int IF_THEN_AUX = 100;
+// The big-M constant of the if-then constraints that linearize the effect of a
+// relinearization decision. It must be at least the largest difference of
+// degrees they relax, MAX_KEY_BASIS_DEGREE - 1, and a larger constant loosens
+// the LP relaxation and with it the lower bounds the solver proves.
+constexpr int IF_THEN_AUX = MAX_KEY_BASIS_DEGREE;
+// The time after which the solver stops improving the lower bound on the cost
+// of a component placed by the greedy heuristic.
+constexpr absl::Duration BOUND_TIME_LIMIT = absl::Seconds(10);
 
 namespace math_opt = ::operations_research::math_opt;
 
@@ -64,36 +77,144 @@ bool hasCiphertextType(ValueRange range) {
   });
 }
 
-LogicalResult OptimizeRelinearizationAnalysis::solve() {
-  math_opt::Model model("OptimizeRelinearizationAnalysis");
+// The factor by which the costs of the ops on the first ciphertext in `range`
+// are scaled, which is the number of bits of its coefficient modulus.
+double getCostScale(ValueRange range) {
+  for (Value value : range) {
+    auto type = dyn_cast<lwe::RLWECiphertextType>(value.getType());
+    if (!type) continue;
+    auto coeffType = dyn_cast<mod_arith::ModArithType>(
+        type.getRlweParams().getRing().getCoefficientType());
+    if (!coeffType) return 1;
+    return coeffType.getModulus().getValue().getActiveBits();
+  }
+  return 1;
+}
+
+// The key basis degree of a ciphertext according to its type.
+int getTypeDegree(Value value) {
+  auto type = cast<lwe::RLWECiphertextType>(value.getType());
+  // If the dimension is 3, the key basis is [0, 1, 2] and the degree is 2.
+  return type.getRlweParams().getDimension() - 1;
+}
+
+// Whether the key basis degree of `value` is fixed to 1 by the ops that define
+// or use it, which holds for the operands of rotations and returns and for the
+// results of rotations.
+bool isForcedLinear(Value value) {
+  if (isa_and_nonnull<bgv::RotateOp>(value.getDefiningOp())) return true;
+  return llvm::any_of(value.getUsers(), [](Operation *user) {
+    return isa<bgv::RotateOp, func::ReturnOp>(user);
+  });
+}
+
+namespace {
+
+// The placement of relinearizations in the ops of one component of the
+// dataflow graph between ciphertext ops. No constraint relates the key basis
+// degrees of different components, so each component is solved
+// independently.
+struct Component {
+  SmallVector<Operation *> ops;
+  llvm::DenseMap<Operation *, bool> solution;
+  llvm::DenseMap<Value, int> keyBasisDegreeBeforeRelin;
+  // The modeled cost of the solution and a lower bound on the cost of an
+  // optimal solution, if they were computed.
+  bool bounded = false;
+  double objectiveValue = 0;
+  double objectiveBound = 0;
+};
+
+// Returns the ops handling ciphertexts in `root` grouped by the connected
+// components of the dataflow graph between them, cut at the values whose key
+// basis degree is fixed: block arguments, whose degree is given by their type,
+// and forced-linear values, which the component defining them keeps linear.
+// The uses of such values see a constant degree, so they need not be solved
+// together with its definition. The ops of each component are in the order of
+// Operation::walk, which visits the definition of a value before its uses.
+SmallVector<Component> getComponents(Operation *root) {
+  SmallVector<Operation *> ops;
+  llvm::EquivalenceClasses<Operation *> classes;
+  root->walk([&](Operation *op) {
+    if (!hasCiphertextType(op->getOperands()) &&
+        !hasCiphertextType(op->getResults())) {
+      return;
+    }
+    ops.push_back(op);
+    classes.insert(op);
+    for (Value operand : op->getOperands()) {
+      if (!isa<lwe::RLWECiphertextType>(operand.getType()) ||
+          isa<BlockArgument>(operand) || isForcedLinear(operand)) {
+        continue;
+      }
+      classes.unionSets(op, operand.getDefiningOp());
+    }
+  });
 
+  SmallVector<Component> components;
+  llvm::DenseMap<Operation *, unsigned> componentIndices;
+  for (Operation *op : ops) {
+    auto [it, inserted] = componentIndices.try_emplace(
+        classes.getLeaderValue(op), components.size());
+    if (inserted) components.emplace_back();
+    components[it->second].ops.push_back(op);
+  }
+  return components;
+}
+
+// The ILP model of the relinearization placement in the ops of a component.
+class RelinearizationModel {
+ public:
+  RelinearizationModel(ArrayRef<Operation *> ops,
+                       const RelinearizationCostModel &costModel);
+
+  // Solves the model, or returns failure if there is no feasible solution.
+  FailureOr<math_opt::SolveResult> solve() const;
+
+  // Solves the model for at most `timeLimit` and returns the best lower bound
+  // on its optimal objective value that the solver proved, or failure if the
+  // model is infeasible.
+  FailureOr<double> bound(absl::Duration timeLimit) const;
+
+  // Returns the objective value of the given placement of relinearizations,
+  // where `solution` and `keyBasisDegreeBeforeRelin` are as in Component.
+  double evaluate(
+      const llvm::DenseMap<Operation *, bool> &solution,
+      const llvm::DenseMap<Value, int> &keyBasisDegreeBeforeRelin) const;
+
+  math_opt::Model model{"OptimizeRelinearizationAnalysis"};
+  // The fixed key basis degrees of the values used by the component but
+  // defined outside of it, see getComponents.
+  llvm::DenseMap<Value, int> boundaryDegrees;
   // Map an operation to a decision to relinearize its results.
   llvm::DenseMap<Operation *, math_opt::Variable> decisionVariables;
-  // keyBasisArgVars maps SSA values to variables tracking the key basis degree
+  // keyBasisVars maps SSA values to variables tracking the key basis degree
   // of the ciphertext at that point in the computation. If the SSA value is
   // the result of an op, this variable corresponds to the degree _after_ the
   // decision to relinearize is applied.
   llvm::DenseMap<Value, math_opt::Variable> keyBasisVars;
-  // keyBasisResultVarsAfterRelin is the same as keyBasisArgVars, but _before_
-  // the decision to relinearize is applied. We need both because the
-  // post-processing of the solution requires us to remember the before-relin
-  // key basis degree. We could recompute it later, but it's more general to
-  // track it.
+  // beforeRelinVars is the same as keyBasisVars, but _before_ the decision to
+  // relinearize is applied. We need both because the post-processing of the
+  // solution requires us to remember the before-relin key basis degree. We
+  // could recompute it later, but it's more general to track it.
   llvm::DenseMap<Value, math_opt::Variable> beforeRelinVars;
+  // keySwitchVars maps op results to the number of key switches needed to
+  // relinearize them, which is zero if no relinearization is inserted.
+  llvm::DenseMap<Value, math_opt::Variable> keySwitchVars;
+};
 
+RelinearizationModel::RelinearizationModel(
+    ArrayRef<Operation *> ops, const RelinearizationCostModel &costModel) {
   // First create a variable for each SSA value tracking the key basis degree
   // of the ciphertext at that point in the computation, as well as the decision
   // variable to track whether to insert a relinearization operation after the
   // operation.
-  opToRunOn->walk([&](Operation *op) {
+  for (Operation *op : ops) {
     std::string name = nameAndLoc(op);
 
-    if (isa<ModuleOp>(op)) {
-      return;
-    }
-
     if (hasCiphertextType(op->getResults())) {
-      auto decisionVar = model.AddBinaryVariable("InsertRelin_" + name);
+      std::string decisionVarName = "InsertRelin_" + name;
+      auto decisionVar = model.AddBinaryVariable(decisionVarName);
       decisionVariables.insert(std::make_pair(op, decisionVar));
     }
 
@@ -116,59 +237,97 @@ LogicalResult OptimizeRelinearizationAnalysis::solve() {
       beforeRelinVars.insert(std::make_pair(result, brKeyBasisVar));
     }
 
-    // Handle block arguments to the op, which are assumed to already be
-    // linearized, though this could be generalized to read the degree from the
-    // type.
-    if (op->getNumRegions() == 0) {
-      return;
-    }
-
-    LLVM_DEBUG(llvm::dbgs()
-               << "Handling block arguments for " << op->getName() << "\n");
-    for (Region &region : op->getRegions()) {
-      for (Block &block : region.getBlocks()) {
-        for (BlockArgument arg : block.getArguments()) {
-          if (!isa<lwe::RLWECiphertextType>(arg.getType())) {
-            continue;
-          }
+    // Handle the values used by the op but defined outside the component,
+    // whose key basis degree is fixed below. The definitions of the values
+    // defined in the component are visited before their uses.
+    for (Value operand : op->getOperands()) {
+      if (!isa<lwe::RLWECiphertextType>(operand.getType()) ||
+          keyBasisVars.contains(operand)) {
+        continue;
+      }
 
-          std::stringstream ss;
-          ss << "Degree_ba" << arg.getArgNumber() << "_" << name;
-          std::string varName = ss.str();
-          auto keyBasisVar =
-              model.AddContinuousVariable(0, MAX_KEY_BASIS_DEGREE, varName);
-          keyBasisVars.insert(std::make_pair(arg, keyBasisVar));
-        }
+      std::stringstream ss;
+      if (auto arg = dyn_cast<BlockArgument>(operand)) {
+        ss << "Degree_ba" << arg.getArgNumber() << "_"
+           << nameAndLoc(arg.getOwner()->getParentOp());
+        boundaryDegrees.insert(std::make_pair(arg, getTypeDegree(arg)));
+      } else {
+        ss << "Degree_in_" << nameAndLoc(operand.getDefiningOp());
+        boundaryDegrees.insert(std::make_pair(operand, 1));
       }
+      std::string varName = ss.str();
+      auto keyBasisVar =
+          model.AddContinuousVariable(0, MAX_KEY_BASIS_DEGREE, varName);
+      keyBasisVars.insert(std::make_pair(operand, keyBasisVar));
     }
-  });
+  }
 
-  // The objective is to minimize the number of relinearization ops.
-  // TODO(#1018): improve the objective function to account for differing
-  // costs of operations at varying degrees.
+  // The objective is to minimize the modeled runtime of the ops whose cost
+  // depends on the key basis degree, including the relinearization ops.
   math_opt::LinearExpression obj;
-  for (auto &[op, decisionVar] : decisionVariables) {
-    obj += decisionVar;
+  for (Operation *op : ops) {
+    if (!hasCiphertextType(op->getOperands()) ||
+        !hasCiphertextType(op->getResults())) {
+      continue;
+    }
+
+    std::string name = nameAndLoc(op);
+    double scale = getCostScale(op->getResults());
+    llvm::TypeSwitch<Operation &>(*op)
+        .Case<bgv::MulOp>([&](auto op) {
+          // The tensor product of ciphertexts of degrees d1 and d2 takes
+          // (d1 + 1)(d2 + 1) polynomial products. Because d1 + d2 is at most
+          // MAX_KEY_BASIS_DEGREE = 3, this equals 2 (d1 + d2) for all
+          // feasible degrees.
+          auto lhsDegreeVar = keyBasisVars.at(op.getLhs());
+          auto rhsDegreeVar = keyBasisVars.at(op.getRhs());
+          obj += 2 * costModel.mulCost * scale * (lhsDegreeVar + rhsDegreeVar);
+        })
+        .Default([&](Operation &op) {
+          // All other ops process each polynomial of their ciphertext operands
+          // once, and the operands have equal degrees.
+          auto it = llvm::find_if(op.getOperands(), [&](Value operand) {
+            return keyBasisVars.contains(operand);
+          });
+          if (it == op.getOperands().end()) return;
+          double cost =
+              isa<bgv::MulPlainOp>(op) ? costModel.mulCost : costModel.addCost;
+          obj += cost * scale * (keyBasisVars.at(*it) + 1);
+        });
+
+    // Relinearizing a result of degree k key switches its k - 1 polynomials
+    // beyond the linear key basis and adds them to the linear part, i.e.,
+    // KeySwitches >= before_relin - 1 if insert_relin_op = 1, else
+    // KeySwitches >= 0. Minimizing the objective makes these bounds tight.
+    auto insertRelinOpDecision = decisionVariables.at(op);
+    obj += 2 * costModel.addCost * scale * insertRelinOpDecision;
+    for (Value result : op->getResults()) {
+      if (!beforeRelinVars.contains(result)) continue;
+      auto resultBeforeRelinVar = beforeRelinVars.at(result);
+      auto keySwitchesVar = model.AddContinuousVariable(
+          0, MAX_KEY_BASIS_DEGREE - 1, "KeySwitches_" + name);
+      keySwitchVars.insert(std::make_pair(result, keySwitchesVar));
+      model.AddLinearConstraint(
+          keySwitchesVar >= resultBeforeRelinVar - 1 -
+                                IF_THEN_AUX * (1 - insertRelinOpDecision),
+          "RelinCost_" + name);
+      obj += costModel.keySwitchCost * scale * keySwitchesVar;
+    }
   }
   model.Minimize(obj);
 
   // Constraints to initialize the key basis degree variables at the start of
   // the computation.
-  for (auto &[value, var] : keyBasisVars) {
-    if (llvm::isa<BlockArgument>(value)) {
-      auto type = cast<lwe::RLWECiphertextType>(value.getType());
-      // If the dimension is 3, the key basis is [0, 1, 2] and the degree is 2.
-      int constrainedDegree = type.getRlweParams().getDimension() - 1;
-      model.AddLinearConstraint(var == constrainedDegree, "");
-    }
+  for (auto &[value, degree] : boundaryDegrees) {
+    model.AddLinearConstraint(keyBasisVars.at(value) == degree, "");
   }
 
   // For each operation, constrain its inputs to all have the same key basis
   // degree.
   std::string cstName;
-  opToRunOn->walk([&](Operation *op) {
+  for (Operation *op : ops) {
     if (op->getNumOperands() <= 1) {
-      return;
+      continue;
     }
 
     std::string name = nameAndLoc(op);
@@ -188,31 +347,30 @@ LogicalResult OptimizeRelinearizationAnalysis::solve() {
          << name;
       model.AddLinearConstraint(operandDegreeVar == anchorVar, ss.str());
     }
-  });
+  }
 
   // Some ops require a linear key basis. Return is a special case
-  // where we require returned values from funcs to be linearized.
-  opToRunOn->walk([&](Operation *op) {
-    llvm::TypeSwitch<Operation &>(*op).Case<bgv::RotateOp, func::ReturnOp>(
-        [&](auto op) {
-          for (Value operand : op->getOperands()) {
-            if (!keyBasisVars.contains(operand)) {
-              // This could happen if you return a block argument without doing
-              // anything to it. No variables are created, but it does not
-              // necessarily need to be constrained.
-              if (isa<func::ReturnOp>(op)) return;
-
-              assert(false && "Operand not found in keyBasisVars");
-            }
-            auto operandDegreeVar = keyBasisVars.at(operand);
-            cstName = "RequireLinearized_" + nameAndLoc(op);
-            model.AddLinearConstraint(operandDegreeVar == 1, cstName);
-          }
-        });
-  });
+  // where we require returned values from funcs to be linearized. The
+  // constraint is placed on the values defined in the component, whose users
+  // may be in other components.
+  for (Operation *op : ops) {
+    for (Value result : op->getResults()) {
+      if (!keyBasisVars.contains(result) || !isForcedLinear(result)) continue;
+      cstName = "RequireLinearized_" + nameAndLoc(op);
+      model.AddLinearConstraint(keyBasisVars.at(result) == 1, cstName);
+    }
+    if (!isa<bgv::RotateOp, func::ReturnOp>(op)) continue;
+    for (Value operand : op->getOperands()) {
+      auto it = boundaryDegrees.find(operand);
+      if (it == boundaryDegrees.end()) continue;
+      // A block argument that is not linear cannot be relinearized.
+      cstName = "RequireLinearized_" + nameAndLoc(op);
+      model.AddLinearConstraint(keyBasisVars.at(operand) == 1, cstName);
+    }
+  }
 
   // Add constraints that set the before_relin variables appropriately
-  opToRunOn->walk([&](Operation *op) {
+  for (Operation *op : ops) {
     llvm::TypeSwitch<Operation &>(*op)
         .Case<bgv::MulOp>([&](auto op) {
           auto lhsDegreeVar = keyBasisVars.at(op.getLhs());
@@ -258,10 +416,10 @@ LogicalResult OptimizeRelinearizationAnalysis::solve() {
                                       cstName);
           }
         });
-  });
+  }
 
   // Add constraints that control the effect of relinearization insertion.
-  opToRunOn->walk([&](Operation *op) {
+  for (Operation *op : ops) {
     // We don't need a type switch here because the only difference
     // between mul and other ops is how the before_relin variable is related to
     // the operand variables.
@@ -273,7 +431,7 @@ LogicalResult OptimizeRelinearizationAnalysis::solve() {
 
     if (!hasCiphertextType(op->getOperands()) ||
         !hasCiphertextType(op->getResults())) {
-      return;
+      continue;
     }
 
     for (Value result : op->getResults()) {
@@ -304,8 +462,10 @@ LogicalResult OptimizeRelinearizationAnalysis::solve() {
               resultBeforeRelinVar + IF_THEN_AUX * insertRelinOpDecision,
           cstName);
     }
-  });
+  }
+}
 
+FailureOr<math_opt::SolveResult> RelinearizationModel::solve() const {
   // Dump the model
   LLVM_DEBUG({
     std::stringstream ss;
@@ -351,16 +511,210 @@ LogicalResult OptimizeRelinearizationAnalysis::solve() {
                    << "\n";
       return failure();
   }
+  return result;
+}
+
+FailureOr<double> RelinearizationModel::bound(absl::Duration timeLimit) const {
+  math_opt::SolveArguments args;
+  args.parameters.time_limit = timeLimit;
+  const absl::StatusOr<math_opt::SolveResult> status =
+      math_opt::Solve(model, math_opt::SolverType::kGscip, args);
 
-  auto varMap = result.variable_values();
-  for (auto item : decisionVariables) {
-    solution.insert(std::make_pair(item.first, varMap[item.second]));
+  if (!status.ok()) {
+    std::stringstream ss;
+    ss << "Error solving the problem: " << status.status() << "\n";
+    llvm::errs() << ss.str();
+    return failure();
   }
-  for (auto item : beforeRelinVars) {
-    solutionKeyBasisDegreeBeforeRelin.insert(
+
+  const math_opt::SolveResult &result = status.value();
+  switch (result.termination.reason) {
+    case math_opt::TerminationReason::kOptimal:
+    case math_opt::TerminationReason::kFeasible:
+    case math_opt::TerminationReason::kNoSolutionFound:
+      LLVM_DEBUG(llvm::dbgs() << "Bound " << result.best_objective_bound()
+                              << " proved in "
+                              << result.solve_time() / absl::Milliseconds(1)
+                              << " milliseconds.\n");
+      return result.best_objective_bound();
+    default:
+      llvm::errs() << "Failed to bound the problem. Termination status code: "
+                   << (int)result.termination.reason << "\n";
+      return failure();
+  }
+}
+
+double RelinearizationModel::evaluate(
+    const llvm::DenseMap<Operation *, bool> &solution,
+    const llvm::DenseMap<Value, int> &keyBasisDegreeBeforeRelin) const {
+  math_opt::VariableMap<double> values;
+  for (auto &[op, var] : decisionVariables) {
+    values[var] = solution.lookup(op);
+  }
+  for (auto &[value, var] : keyBasisVars) {
+    auto it = boundaryDegrees.find(value);
+    if (it != boundaryDegrees.end()) {
+      values[var] = it->second;
+      continue;
+    }
+    bool relinearized = solution.lookup(value.getDefiningOp());
+    values[var] = relinearized ? 1 : keyBasisDegreeBeforeRelin.lookup(value);
+  }
+  for (auto &[value, var] : beforeRelinVars) {
+    values[var] = keyBasisDegreeBeforeRelin.lookup(value);
+  }
+  for (auto &[value, var] : keySwitchVars) {
+    bool relinearized = solution.lookup(value.getDefiningOp());
+    values[var] =
+        relinearized ? keyBasisDegreeBeforeRelin.lookup(value) - 1 : 0;
+  }
+  return model.ObjectiveAsLinearExpression().Evaluate(values);
+}
+
+// Places relinearizations with an exact solution of the ILP.
+LogicalResult solveExactly(Component &component,
+                           const RelinearizationCostModel &costModel) {
+  RelinearizationModel model(component.ops, costModel);
+  FailureOr<math_opt::SolveResult> result = model.solve();
+  if (failed(result)) return failure();
+
+  auto varMap = result->variable_values();
+  for (auto item : model.decisionVariables) {
+    component.solution.insert(std::make_pair(item.first, varMap[item.second]));
+  }
+  for (auto item : model.beforeRelinVars) {
+    component.keyBasisDegreeBeforeRelin.insert(
         (std::make_pair(item.first, (int)varMap[item.second])));
   }
+  component.bounded = true;
+  component.objectiveValue = result->objective_value();
+  component.objectiveBound = result->best_objective_bound();
+  return success();
+}
+
+// Places relinearizations with a greedy heuristic, whose sweeps over the ops
+// of the component take linear time. Multiplications get linear operands, and
+// so do ops whose operands have differing key basis degrees, by relinearizing
+// the ops that define the operands, and forced-linear results are
+// relinearized where they are defined. This changes the
+// degrees seen by the ops visited earlier in the sweep, so sweeps are
+// repeated until none adds a relinearization, which in practice takes a few
+// sweeps. If `bound` is set, the ILP is solved for at most BOUND_TIME_LIMIT
+// to bound the cost of the placement from below.
+LogicalResult solveGreedily(Component &component,
+                            const RelinearizationCostModel &costModel,
+                            bool bound) {
+  llvm::DenseSet<Operation *> relinearized;
+  llvm::DenseMap<Value, int> degrees;
+  // The values defined outside the component are block arguments or are
+  // forced to be linear.
+  auto getDegree = [&](Value value) {
+    auto it = degrees.find(value);
+    if (it != degrees.end()) return it->second;
+    return isa<BlockArgument>(value) ? getTypeDegree(value) : 1;
+  };
+
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    degrees.clear();
+    component.keyBasisDegreeBeforeRelin.clear();
+    for (Operation *op : component.ops) {
+      SmallVector<Value> operands;
+      for (Value operand : op->getOperands()) {
+        if (isa<lwe::RLWECiphertextType>(operand.getType()))
+          operands.push_back(operand);
+      }
 
+      bool requireLinear =
+          isa<bgv::MulOp, bgv::RotateOp, func::ReturnOp>(op) ||
+          llvm::any_of(operands, [&](Value operand) {
+            return getDegree(operand) != getDegree(operands.front());
+          });
+      if (requireLinear) {
+        for (Value operand : operands) {
+          if (getDegree(operand) == 1) continue;
+          Operation *definingOp = operand.getDefiningOp();
+          if (!definingOp) {
+            LLVM_DEBUG(llvm::dbgs() << "Cannot relinearize block argument "
+                                    << operand << "\n");
+            return failure();
+          }
+          changed |= relinearized.insert(definingOp).second;
+          for (Value result : definingOp->getResults()) {
+            if (isa<lwe::RLWECiphertextType>(result.getType()))
+              degrees[result] = 1;
+          }
+        }
+      }
+
+      for (Value result : op->getResults()) {
+        if (!isa<lwe::RLWECiphertextType>(result.getType())) continue;
+        int degree = getTypeDegree(result);
+        if (isa<bgv::MulOp>(op)) {
+          degree = getDegree(op->getOperand(0)) + getDegree(op->getOperand(1));
+        } else if (!operands.empty()) {
+          degree = getDegree(operands.front());
+        }
+        component.keyBasisDegreeBeforeRelin[result] = degree;
+        if (degree > 1 && isForcedLinear(result))
+          changed |= relinearized.insert(op).second;
+        degrees[result] = relinearized.contains(op) ? 1 : degree;
+      }
+    }
+  }
+
+  // An op may have been relinearized before its operands were, in which case
+  // its results end up linear anyway.
+  for (Operation *op : relinearized) {
+    component.solution[op] = llvm::any_of(op->getResults(), [&](Value result) {
+      return component.keyBasisDegreeBeforeRelin.lookup(result) > 1;
+    });
+  }
+
+  if (!bound) return success();
+  RelinearizationModel model(component.ops, costModel);
+  FailureOr<double> objectiveBound = model.bound(BOUND_TIME_LIMIT);
+  if (failed(objectiveBound)) return failure();
+  component.bounded = true;
+  component.objectiveValue =
+      model.evaluate(component.solution, component.keyBasisDegreeBeforeRelin);
+  component.objectiveBound = *objectiveBound;
+  return success();
+}
+
+}  // namespace
+
+LogicalResult OptimizeRelinearizationAnalysis::solve() {
+  SmallVector<Component> components = getComponents(opToRunOn);
+
+  // The components share no variables, so they are solved in parallel.
+  LogicalResult result = failableParallelForEach(
+      opToRunOn->getContext(), components, [&](Component &component) {
+        if (static_cast<int64_t>(component.ops.size()) > maxIlpSize) {
+          LLVM_DEBUG(llvm::dbgs()
+                     << "Placing relinearizations greedily in a component of "
+                     << component.ops.size() << " ops\n");
+          return solveGreedily(component, costModel, boundHeuristicSolutions);
+        }
+        return solveExactly(component, costModel);
+      });
+  if (failed(result)) return failure();
+
+  objectiveValue = 0;
+  objectiveBound = 0;
+  for (Component &component : components) {
+    solution.insert(component.solution.begin(), component.solution.end());
+    solutionKeyBasisDegreeBeforeRelin.insert(
+        component.keyBasisDegreeBeforeRelin.begin(),
+        component.keyBasisDegreeBeforeRelin.end());
+    if (component.bounded) {
+      objectiveValue += component.objectiveValue;
+      objectiveBound += component.objectiveBound;
+    }
+  }
+  LLVM_DEBUG(llvm::dbgs() << "Objective value = " << objectiveValue
+                          << ", bound = " << objectiveBound << "\n");
   return success();
 }
 }  // namespace heir
@@ -1,19 +1,58 @@
 #ifndef LIB_ANALYSIS_OPTIMIZE_RELINEARIZATIONANALYSIS_H
 #define LIB_ANALYSIS_OPTIMIZE_RELINEARIZATIONANALYSIS_H
 
+#include <cstdint>
+#include <limits>
+
 #include "llvm/include/llvm/ADT/DenseMap.h"  // from @llvm-project
 #include "mlir/include/mlir/IR/Operation.h"  // from @llvm-project
 #include "mlir/include/mlir/IR/Value.h"      // from @llvm-project
 
 namespace mlir {
 namespace heir {
+
+// The modeled costs of the ops whose runtime depends on the key basis degree
+// of their ciphertexts. Each cost is given per polynomial of the ciphertext
+// and is scaled by the number of bits of the coefficient modulus of the
+// ciphertext, since the RNS arithmetic on a ciphertext at a lower level has
+// proportionally fewer limbs to process. The defaults are the approximate
+// ratios of the per-limb work of the corresponding OpenFHE routines.
+struct RelinearizationCostModel {
+  // An addition, negation or other linear op on a polynomial.
+  double addCost = 0.25;
+  // A product of two polynomials, or of a polynomial and a plaintext.
+  double mulCost = 1;
+  // Switching one polynomial of a ciphertext back to the key s, which is
+  // dominated by the NTTs of the digit decomposition.
+  double keySwitchCost = 60;
+};
+
 class OptimizeRelinearizationAnalysis {
  public:
-  OptimizeRelinearizationAnalysis(Operation *op) : opToRunOn(op) {}
+  // Each connected component of the dataflow graph between the ciphertext ops
+  // of `op`, cut at block arguments and at the values that must be linear, is
+  // solved independently, with an ILP if it has at most `maxIlpSize` ops and
+  // with a greedy heuristic otherwise. The placements made by the heuristic
+  // are only bounded from below, by the best bound that a time-limited solve
+  // of their ILP proves, if `boundHeuristicSolutions` is set.
+  OptimizeRelinearizationAnalysis(
+      Operation *op, RelinearizationCostModel costModel = {},
+      int64_t maxIlpSize = std::numeric_limits<int64_t>::max(),
+      bool boundHeuristicSolutions = false)
+      : opToRunOn(op),
+        costModel(costModel),
+        maxIlpSize(maxIlpSize),
+        boundHeuristicSolutions(boundHeuristicSolutions) {}
   ~OptimizeRelinearizationAnalysis() = default;
 
   LogicalResult solve();
 
+  // Return the modeled cost of the solution, and a lower bound on the cost of
+  // an optimal solution. The components placed by the greedy heuristic are
+  // only included if boundHeuristicSolutions is set.
+  double getObjectiveValue() const { return objectiveValue; }
+  double getObjectiveBound() const { return objectiveBound; }
+
   // Return true if a relin op should be inserted after the given
   // operation, according to the solution to the optimization problem.
   bool shouldInsertRelin(Operation *op) const { return solution.lookup(op); }
@@ -32,6 +71,11 @@ class OptimizeRelinearizationAnalysis {
 
  private:
   Operation *opToRunOn;
+  RelinearizationCostModel costModel;
+  int64_t maxIlpSize;
+  bool boundHeuristicSolutions;
+  double objectiveValue = 0;
+  double objectiveBound = 0;
   llvm::DenseMap<Operation *, bool> solution;
   llvm::DenseMap<Value, int> solutionKeyBasisDegreeBeforeRelin;
 };
@@ -51,6 +51,31 @@ using ConvertRelinOp = ConvertRlweRelinOp<RelinearizeOp>;
 using ConvertExtractOp =
     lwe::ConvertRlweExtractOp<ExtractOp, MulPlainOp, RotateOp>;
 
+// Lowers a CKKS op that moves a ciphertext to a smaller ring. Unlike
+// ConvertRlweUnaryOp, the result type differs from the input type, so it is
+// taken from the original op rather than inferred.
+template <typename LevelOp, typename OpenfheLevelOp>
+struct ConvertRlweLevelOp : public OpConversionPattern<LevelOp> {
+  using OpConversionPattern<LevelOp>::OpConversionPattern;
+
+  LogicalResult matchAndRewrite(
+      LevelOp op, typename LevelOp::Adaptor adaptor,
+      ConversionPatternRewriter &rewriter) const override {
+    FailureOr<Value> result = getContextualCryptoContext(op.getOperation());
+    if (failed(result)) return result;
+
+    Value cryptoContext = result.value();
+    rewriter.replaceOp(op, rewriter.create<OpenfheLevelOp>(
+                               op.getLoc(), op.getOutput().getType(),
+                               cryptoContext, adaptor.getInput()));
+    return success();
+  }
+};
+
+using ConvertRescaleOp = ConvertRlweLevelOp<RescaleOp, openfhe::ModReduceOp>;
+using ConvertLevelReduceOp =
+    ConvertRlweLevelOp<LevelReduceOp, openfhe::LevelReduceOp>;
+
 struct CKKSToOpenfhe : public impl::CKKSToOpenfheBase<CKKSToOpenfhe> {
   void runOnOperation() override {
     MLIRContext *context = &getContext();
@@ -79,7 +104,8 @@ struct CKKSToOpenfhe : public impl::CKKSToOpenfheBase<CKKSToOpenfhe> {
     patterns
         .add<AddCryptoContextArg<ckks::CKKSDialect>, ConvertAddOp, ConvertSubOp,
              ConvertMulOp, ConvertAddPlainOp, ConvertMulPlainOp,
-             ConvertNegateOp, ConvertRotateOp, ConvertRelinOp, ConvertExtractOp,
+             ConvertNegateOp, ConvertRotateOp, ConvertRelinOp,
+             ConvertRescaleOp, ConvertLevelReduceOp, ConvertExtractOp,
              lwe::ConvertEncryptOp, lwe::ConvertDecryptOp>(typeConverter,
                                                            context);
     patterns.add<lwe::ConvertEncodeOp>(typeConverter, context, /*ckks=*/true);
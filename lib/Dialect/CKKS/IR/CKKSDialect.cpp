@@ -45,6 +45,10 @@ LogicalResult RescaleOp::verify() {
   return verifyModulusSwitchOrRescaleOp(this);
 }
 
+LogicalResult LevelReduceOp::verify() {
+  return verifyModulusSwitchOrRescaleOp(this);
+}
+
 LogicalResult MulOp::inferReturnTypes(
     MLIRContext *ctx, std::optional<Location>, MulOp::Adaptor adaptor,
     SmallVectorImpl<Type> &inferredReturnTypes) {
@@ -8,6 +8,7 @@
 #include "llvm/include/llvm/ADT/APInt.h"              // from @llvm-project
 #include "llvm/include/llvm/Support/Debug.h"          // from @llvm-project
 #include "llvm/include/llvm/Support/LogicalResult.h"  // from @llvm-project
+#include "llvm/include/llvm/Support/MathExtras.h"     // from @llvm-project
 #include "mlir/include/mlir/Analysis/DataFlow/ConstantPropagationAnalysis.h"  // from @llvm-project
 #include "mlir/include/mlir/Analysis/DataFlow/DeadCodeAnalysis.h"  // from @llvm-project
 #include "mlir/include/mlir/Analysis/DataFlowFramework.h"  // from @llvm-project
@@ -52,7 +53,8 @@ int calculateIndexHelper(bool isLeftOperandSecret, int dim0, int dim1, int i,
 
 template <typename T>
 Value diagonalizeMatrix(ImplicitLocOpBuilder builder,
-                        DenseElementsAttr denseAttr, bool isLeftOperandSecret) {
+                        DenseElementsAttr denseAttr, bool isLeftOperandSecret,
+                        int64_t babySteps = 0) {
   // Algorithm for diagonalizing the matrix:
   // There are two loops, an outer loop and an inner loop.
   // The outer loop is the for loop that goes from 0 to number of rows in the
@@ -93,6 +95,12 @@ Value diagonalizeMatrix(ImplicitLocOpBuilder builder,
   //     diagonal_element = matrix[index]
   //     diagonal_elements.push_back(diagonal_element)
   //
+  // If babySteps is positive, the diagonals are laid out for the baby-step
+  // giant-step multiplication (see multiplyDiagonalizedMatrixWithVectorBSGS):
+  // the k-th diagonal is additionally rotated right by k - k % babySteps, so
+  // that the rotation by the giant step can be applied after the products
+  // with the diagonals instead of before them.
+  //
   // Finally, we create a new constant op with the diagonalized elements.
 
   auto type = denseAttr.getElementType();
@@ -106,7 +114,22 @@ Value diagonalizeMatrix(ImplicitLocOpBuilder builder,
   diagonalElements.reserve(denseAttr.getNumElements());
   for (int i = 0; i < transposedDimensions[0]; ++i) {
     for (int j = 0; j < transposedDimensions[1]; ++j) {
-      int index = calculateIndexHelper(isLeftOperandSecret, dim0, dim1, i, j);
+      // The diagonal is a row of the transposed matrix if the left operand is
+      // secret, and a column otherwise.
+      int row = i;
+      int column = j;
+      if (babySteps > 0) {
+        if (isLeftOperandSecret) {
+          int shift = i - i % babySteps;
+          column =
+              (j - shift + transposedDimensions[1]) % transposedDimensions[1];
+        } else {
+          int shift = j - j % babySteps;
+          row = (i - shift + transposedDimensions[0]) % transposedDimensions[0];
+        }
+      }
+      int index =
+          calculateIndexHelper(isLeftOperandSecret, dim0, dim1, row, column);
       auto value = denseAttr.getValues<T>()[index];
       diagonalElements.push_back(value);
     }
@@ -220,13 +243,90 @@ Value multiplyDiagonalizedMatrixWithVector(ImplicitLocOpBuilder builder,
   return finalSum;
 }
 
+template <typename AddOp, typename MulOp>
+Value multiplyDiagonalizedMatrixWithVectorBSGS(ImplicitLocOpBuilder builder,
+                                               Value diagonalizedMatrix,
+                                               Value secretValues, Value bias,
+                                               bool isLeftOperandSecret,
+                                               int64_t babySteps) {
+  // The baby-step giant-step (BSGS) variant of the Halevi-Shoup
+  // multiplication. With n = babySteps * giantSteps diagonals d_k, it uses
+  //
+  //   rotate(v, g * babySteps + b) * d_k
+  //       = rotate(rotate(v, b) * rotate(d_k, -g * babySteps), g * babySteps)
+  //
+  // for k = g * babySteps + b. The diagonals were rotated at compile time by
+  // diagonalizeMatrix, so this emits the following code, with the loops
+  // unrolled:
+  //
+  // %baby_b = rotate %v, b for b = 0 to babySteps - 1
+  // %sum = bias
+  // for g = 0 to giantSteps - 1:
+  //   %inner = sum over b of %baby_b * extract_slice(%newMatrix, k)
+  //   %sum = %sum + rotate %inner, g * babySteps
+  // return %sum
+  //
+  // This takes babySteps + giantSteps - 2 rotations instead of n - 1. The
+  // baby-step rotations all rotate the same vector, which also lets backends
+  // share their key-switching work.
+
+  auto shape = cast<RankedTensorType>(diagonalizedMatrix.getType()).getShape();
+  auto transposedDim0 = shape[0];
+  auto transposedDim1 = shape[1];
+  int64_t numDiagonals = isLeftOperandSecret ? transposedDim0 : transposedDim1;
+  int64_t giantSteps = numDiagonals / babySteps;
+
+  SmallVector<OpFoldResult> sizes(2);
+  if (isLeftOperandSecret) {
+    sizes = {builder.getIndexAttr(1), builder.getIndexAttr(transposedDim1)};
+  } else {
+    sizes = {builder.getIndexAttr(transposedDim0), builder.getIndexAttr(1)};
+  }
+  SmallVector<OpFoldResult> strides(2, builder.getIndexAttr(1));
+
+  SmallVector<Value> babyStepRotations({secretValues});
+  for (int64_t b = 1; b < babySteps; ++b) {
+    auto shift = builder.create<arith::ConstantIndexOp>(b);
+    babyStepRotations.push_back(
+        builder.create<tensor_ext::RotateOp>(secretValues, shift));
+  }
+
+  Value sum = bias;
+  for (int64_t g = 0; g < giantSteps; ++g) {
+    Value inner;
+    for (int64_t b = 0; b < babySteps; ++b) {
+      int64_t diagonal = g * babySteps + b;
+      SmallVector<OpFoldResult> offsets(2);
+      if (isLeftOperandSecret) {
+        offsets = {builder.getIndexAttr(diagonal), builder.getIndexAttr(0)};
+      } else {
+        offsets = {builder.getIndexAttr(0), builder.getIndexAttr(diagonal)};
+      }
+      auto extracted = builder.create<tensor::ExtractSliceOp>(
+          diagonalizedMatrix, offsets, sizes, strides);
+      Value multiplied = builder.create<MulOp>(babyStepRotations[b], extracted);
+      inner = inner ? builder.create<AddOp>(inner, multiplied) : multiplied;
+    }
+    if (g > 0) {
+      auto shift = builder.create<arith::ConstantIndexOp>(g * babySteps);
+      inner = builder.create<tensor_ext::RotateOp>(inner, shift);
+    }
+    sum = builder.create<AddOp>(sum, inner);
+  }
+  return sum;
+}
+
 struct ConvertLinalgMatmul : public OpRewritePattern<mlir::linalg::MatmulOp> {
  private:
   DataFlowSolver *solver;
+  int64_t bsgsThreshold;
 
  public:
-  ConvertLinalgMatmul(DataFlowSolver *solver, mlir::MLIRContext *context)
-      : OpRewritePattern<mlir::linalg::MatmulOp>(context), solver(solver) {}
+  ConvertLinalgMatmul(DataFlowSolver *solver, int64_t bsgsThreshold,
+                      mlir::MLIRContext *context)
+      : OpRewritePattern<mlir::linalg::MatmulOp>(context),
+        solver(solver),
+        bsgsThreshold(bsgsThreshold) {}
 
   using OpRewritePattern::OpRewritePattern;
 
@@ -315,21 +415,41 @@ struct ConvertLinalgMatmul : public OpRewritePattern<mlir::linalg::MatmulOp> {
     // not used, then dead code elimination pass will remove it.
 
     // After that, we create code for multiplying the matrix with rotations of
-    // the vector.
+    // the vector. Large matrices use the baby-step giant-step variant, with
+    // the number of baby steps the power of two closest to the square root
+    // of the dimension, rounded up.
+    int64_t babySteps = 0;
+    if (bsgsThreshold > 0 && dim0 >= bsgsThreshold) {
+      babySteps = int64_t{1} << ((llvm::Log2_64(dim0) + 1) / 2);
+    }
     if (type.isInteger()) {
-      Value diagonalizedMatrix =
-          diagonalizeMatrix<APInt>(b, denseAttr, isLeftOperandSecret);
-
-      result =
-          multiplyDiagonalizedMatrixWithVector<arith::AddIOp, arith::MulIOp>(
-              b, diagonalizedMatrix, secretValues, bias, isLeftOperandSecret);
+      Value diagonalizedMatrix = diagonalizeMatrix<APInt>(
+          b, denseAttr, isLeftOperandSecret, babySteps);
+
+      if (babySteps > 0) {
+        result = multiplyDiagonalizedMatrixWithVectorBSGS<arith::AddIOp,
+                                                          arith::MulIOp>(
+            b, diagonalizedMatrix, secretValues, bias, isLeftOperandSecret,
+            babySteps);
+      } else {
+        result =
+            multiplyDiagonalizedMatrixWithVector<arith::AddIOp, arith::MulIOp>(
+                b, diagonalizedMatrix, secretValues, bias, isLeftOperandSecret);
+      }
     } else {  // floating point
-      Value diagonalizedMatrix =
-          diagonalizeMatrix<APFloat>(b, denseAttr, isLeftOperandSecret);
-
-      result =
-          multiplyDiagonalizedMatrixWithVector<arith::AddFOp, arith::MulFOp>(
-              b, diagonalizedMatrix, secretValues, bias, isLeftOperandSecret);
+      Value diagonalizedMatrix = diagonalizeMatrix<APFloat>(
+          b, denseAttr, isLeftOperandSecret, babySteps);
+
+      if (babySteps > 0) {
+        result = multiplyDiagonalizedMatrixWithVectorBSGS<arith::AddFOp,
+                                                          arith::MulFOp>(
+            b, diagonalizedMatrix, secretValues, bias, isLeftOperandSecret,
+            babySteps);
+      } else {
+        result =
+            multiplyDiagonalizedMatrixWithVector<arith::AddFOp, arith::MulFOp>(
+                b, diagonalizedMatrix, secretValues, bias, isLeftOperandSecret);
+      }
     }
     rewriter.replaceOp(op, result);
     return success();
@@ -338,6 +458,8 @@ struct ConvertLinalgMatmul : public OpRewritePattern<mlir::linalg::MatmulOp> {
 
 struct LinalgToTensorExt
     : public impl::LinalgToTensorExtBase<LinalgToTensorExt> {
+  using LinalgToTensorExtBase::LinalgToTensorExtBase;
+
   void runOnOperation() override {
     MLIRContext *context = &getContext();
     auto *module = getOperation();
@@ -357,7 +479,7 @@ struct LinalgToTensorExt
 
     RewritePatternSet patterns(context);
 
-    patterns.add<ConvertLinalgMatmul>(&solver, context);
+    patterns.add<ConvertLinalgMatmul>(&solver, bsgsThreshold, context);
 
     // Run pattern matching and conversion
     if (failed(applyPatternsAndFoldGreedily(module, std::move(patterns)))) {
@@ -1,12 +1,27 @@
 #include "lib/Dialect/ModArith/Conversions/ModArithToArith/ModArithToArith.h"
 
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <string>
 #include <utility>
 
+#include "lib/Analysis/LazyReductionAnalysis/LazyReductionAnalysis.h"
+#include "lib/Dialect/ModArith/IR/ModArithAttributes.h"
 #include "lib/Dialect/ModArith/IR/ModArithDialect.h"
 #include "lib/Dialect/ModArith/IR/ModArithOps.h"
 #include "lib/Dialect/ModArith/IR/ModArithTypes.h"
 #include "lib/Utils/ConversionUtils/ConversionUtils.h"
+#include "llvm/include/llvm/ADT/APInt.h"       // from @llvm-project
+#include "llvm/include/llvm/ADT/DenseSet.h"    // from @llvm-project
+#include "llvm/include/llvm/ADT/STLExtras.h"   // from @llvm-project
+#include "llvm/include/llvm/ADT/SmallVector.h"  // from @llvm-project
+#include "llvm/include/llvm/ADT/SmallVectorExtras.h"  // from @llvm-project
 #include "llvm/include/llvm/Support/Casting.h"  // from @llvm-project
+#include "mlir/include/mlir/Analysis/DataFlow/ConstantPropagationAnalysis.h"  // from @llvm-project
+#include "mlir/include/mlir/Analysis/DataFlow/DeadCodeAnalysis.h"  // from @llvm-project
+#include "mlir/include/mlir/Analysis/DataFlowFramework.h"  // from @llvm-project
 #include "mlir/include/mlir/Dialect/Affine/IR/AffineOps.h"  // from @llvm-project
 #include "mlir/include/mlir/Dialect/Arith/IR/Arith.h"    // from @llvm-project
 #include "mlir/include/mlir/Dialect/Linalg/IR/Linalg.h"  // from @llvm-project
@@ -20,6 +35,7 @@
 #include "mlir/include/mlir/IR/MLIRContext.h"            // from @llvm-project
 #include "mlir/include/mlir/IR/PatternMatch.h"           // from @llvm-project
 #include "mlir/include/mlir/IR/TypeUtilities.h"          // from @llvm-project
+#include "mlir/include/mlir/Interfaces/FunctionInterfaces.h"  // from @llvm-project
 #include "mlir/include/mlir/Support/LLVM.h"              // from @llvm-project
 #include "mlir/include/mlir/Support/LogicalResult.h"     // from @llvm-project
 #include "mlir/include/mlir/Transforms/DialectConversion.h"  // from @llvm-project
@@ -84,6 +100,160 @@ inline Type modulusType(Op op, bool mul = false) {
   return modulusAttr(op, mul).getType();
 }
 
+// A helper function to generate an integer attribute of the given width
+// holding `value`, splatted to the shape of `type` if it is a shaped type.
+TypedAttr getIntOrSplatAttr(Type type, const APInt &value, unsigned width) {
+  auto intType = IntegerType::get(type.getContext(), width);
+  auto truncValue = value.zextOrTrunc(width);
+  if (auto st = mlir::dyn_cast<ShapedType>(type)) {
+    auto containerType = st.cloneWith(st.getShape(), intType);
+    return DenseElementsAttr::get(containerType, truncValue);
+  }
+  return IntegerAttr::get(intType, truncValue);
+}
+
+// Computes the canonical representative of `x` modulo `cmod`, interpreting `x`
+// as a signed integer.
+static Value buildCanonicalRemainder(ImplicitLocOpBuilder &b, Value x,
+                                     Value cmod) {
+  // ModArithType ensures cmod can be correctly interpreted as a signed number
+  auto rems = b.create<arith::RemSIOp>(x, cmod);
+  auto add = b.create<arith::AddIOp>(rems, cmod);
+  // TODO(#710): better with a subifge
+  return b.create<arith::RemUIOp>(add, cmod);
+}
+
+// Computes (x >= y) ? x - y : x.
+static Value buildSubIfGE(ImplicitLocOpBuilder &b, Value x, Value y) {
+  auto sub = b.create<arith::SubIOp>(x, y);
+  auto cmp = b.create<arith::CmpIOp>(arith::CmpIPredicate::uge, x, y);
+  return b.create<arith::SelectOp>(cmp, sub, x);
+}
+
+// Computes a Barrett reduction of `x` modulo the statically known `modulus`,
+// following Algorithm 14.42 of the Handbook of Applied Cryptography generalized
+// to inputs of `inputBits` bits. With k the bit width of the modulus q and the
+// compile-time constant mu = floor(2^inputBits / q),
+//
+//   r = x - floor(floor(x / 2^{k-1}) * mu / 2^{inputBits-k+1}) * q
+//
+// satisfies r = (x mod q) + c * q for some c in {0, 1, 2}. Each of the
+// `numCorrections` conditional subtractions that follow reduces the range of
+// the result by q. `x` must be an unsigned integer (or container of integers)
+// in [0, 2^inputBits), and the result has the same type as `x`.
+static Value buildBarrettReduce(ImplicitLocOpBuilder &b, Value x,
+                                const APInt &modulus, unsigned inputBits,
+                                unsigned numCorrections) {
+  Type type = x.getType();
+  unsigned width = getElementTypeOrSelf(type).getIntOrFloatBitWidth();
+  unsigned k = modulus.getActiveBits();
+  assert(inputBits + 1 >= k && "expected the input to be at least as wide as "
+                               "the modulus, minus one bit");
+
+  // The product q1 * mu is below 2^{2 * shift}, and r < 3q needs k + 2 bits.
+  unsigned shift = inputBits + 1 - k;
+  unsigned interWidth = std::max({width, 2 * shift, k + 2});
+  APInt mu = APInt::getOneBitSet(inputBits + 1, inputBits)
+                 .udiv(modulus.zextOrTrunc(inputBits + 1));
+
+  auto constant = [&](const APInt &value) -> Value {
+    return b.create<arith::ConstantOp>(
+        getIntOrSplatAttr(type, value, interWidth));
+  };
+
+  Value xExt = x;
+  if (interWidth > width) {
+    xExt = b.create<arith::ExtUIOp>(
+        getIntOrSplatAttr(type, mu, interWidth).getType(), x);
+  }
+
+  // q1 = floor(x / 2^{k-1}) and q3 = floor(q1 * mu / 2^{inputBits-k+1})
+  auto q1 = b.create<arith::ShRUIOp>(xExt, constant(APInt(interWidth, k - 1)));
+  auto q2 = b.create<arith::MulIOp>(q1, constant(mu));
+  auto q3 = b.create<arith::ShRUIOp>(q2, constant(APInt(interWidth, shift)));
+
+  // q3 underestimates floor(x / q) by at most 2, so r = x - q3 * q < 3q
+  Value cmod = constant(modulus);
+  auto q3TimesMod = b.create<arith::MulIOp>(q3, cmod);
+  Value remainder = b.create<arith::SubIOp>(xExt, q3TimesMod);
+  for (unsigned i = 0; i < numCorrections; ++i) {
+    remainder = buildSubIfGE(b, remainder, cmod);
+  }
+
+  if (interWidth > width) {
+    remainder = b.create<arith::TruncIOp>(type, remainder);
+  }
+  return remainder;
+}
+
+static LogicalResult verifyMontgomeryModulus(Operation *op,
+                                             ModArithType modArithType) {
+  if (!modArithType.getModulus().getValue()[0])
+    return op->emitOpError()
+           << "Montgomery lowering requires an odd modulus, but got "
+           << modArithType << ".";
+  return success();
+}
+
+// Computes the Montgomery reduction (REDC) t * 2^{-w} mod q in [0, q), where q
+// is the modulus of `modArithType` and w its storage width. The input `t` must
+// be an integer (or container of integers) of width 2w in the range
+// [0, q * 2^w), which holds for the product of two values in [0, q).
+static Value buildMontgomeryReduce(ImplicitLocOpBuilder &b,
+                                   ModArithType modArithType, Value t) {
+  auto montgomery = MontgomeryAttr::get(modArithType);
+  APInt modulus = modArithType.getModulus().getValue();
+  unsigned width = modulus.getBitWidth();
+  Type type = t.getType();
+
+  Value cmod =
+      b.create<arith::ConstantOp>(getIntOrSplatAttr(type, modulus, width));
+  Value negModulusInv = b.create<arith::ConstantOp>(getIntOrSplatAttr(
+      type, montgomery.getNegModulusInv().getValue(), width));
+  Value cmodExt =
+      b.create<arith::ConstantOp>(getIntOrSplatAttr(type, modulus, 2 * width));
+  Value shift = b.create<arith::ConstantOp>(
+      getIntOrSplatAttr(type, APInt(2 * width, width), 2 * width));
+
+  // m = (t mod 2^w) * (-q^{-1}) mod 2^w, where both reductions are implicit in
+  // the w-bit arithmetic.
+  auto tLow = b.create<arith::TruncIOp>(cmod.getType(), t);
+  auto m = b.create<arith::MulIOp>(tLow, negModulusInv);
+
+  // t + m * q is divisible by 2^w, and since q < 2^{w-1} it does not overflow
+  // 2w bits. The quotient (t + m * q) / 2^w lies in [0, 2q).
+  auto mExt = b.create<arith::ExtUIOp>(cmodExt.getType(), m);
+  auto mq = b.create<arith::MulIOp>(mExt, cmodExt);
+  auto sum = b.create<arith::AddIOp>(t, mq);
+  auto quotient = b.create<arith::ShRUIOp>(sum, shift);
+  auto trunc = b.create<arith::TruncIOp>(cmod.getType(), quotient);
+  return buildSubIfGE(b, trunc, cmod);
+}
+
+// Converts `x` in [0, q) to its Montgomery form x * 2^w mod q, computed as
+// REDC(x * (2^{2w} mod q)).
+static Value buildToMontgomery(ImplicitLocOpBuilder &b,
+                               ModArithType modArithType, Value x) {
+  auto montgomery = MontgomeryAttr::get(modArithType);
+  unsigned width = modArithType.getModulus().getValue().getBitWidth();
+  Value rSquared = b.create<arith::ConstantOp>(getIntOrSplatAttr(
+      x.getType(), montgomery.getRSquared().getValue(), 2 * width));
+  auto ext = b.create<arith::ExtUIOp>(rSquared.getType(), x);
+  auto mul = b.create<arith::MulIOp>(ext, rSquared);
+  return buildMontgomeryReduce(b, modArithType, mul);
+}
+
+// Converts `x` from Montgomery form back to the canonical representative,
+// computed as REDC(x).
+static Value buildFromMontgomery(ImplicitLocOpBuilder &b,
+                                 ModArithType modArithType, Value x) {
+  unsigned width = modArithType.getModulus().getValue().getBitWidth();
+  Type extType =
+      getIntOrSplatAttr(x.getType(), APInt(width, 0), 2 * width).getType();
+  auto ext = b.create<arith::ExtUIOp>(extType, x);
+  return buildMontgomeryReduce(b, modArithType, ext);
+}
+
 struct ConvertEncapsulate : public OpConversionPattern<EncapsulateOp> {
   ConvertEncapsulate(mlir::MLIRContext *context)
       : OpConversionPattern<EncapsulateOp>(context) {}
@@ -140,11 +310,7 @@ struct ConvertReduce : public OpConversionPattern<ReduceOp> {
     ImplicitLocOpBuilder b(op.getLoc(), rewriter);
 
     auto cmod = b.create<arith::ConstantOp>(modulusAttr(op));
-    // ModArithType ensures cmod can be correctly interpreted as a signed number
-    auto rems = b.create<arith::RemSIOp>(adaptor.getOperands()[0], cmod);
-    auto add = b.create<arith::AddIOp>(rems, cmod);
-    // TODO(#710): better with a subifge
-    auto remu = b.create<arith::RemUIOp>(add, cmod);
+    auto remu = buildCanonicalRemainder(b, adaptor.getOperands()[0], cmod);
     rewriter.replaceOp(op, remu);
     return success();
   }
@@ -246,6 +412,468 @@ struct ConvertMac : public OpConversionPattern<MacOp> {
   }
 };
 
+// In Montgomery mode, encapsulate reduces its input to the canonical
+// representative (with the same signed interpretation as mod_arith.reduce) and
+// converts it to Montgomery form.
+struct ConvertEncapsulateMontgomery
+    : public OpConversionPattern<EncapsulateOp> {
+  ConvertEncapsulateMontgomery(mlir::MLIRContext *context)
+      : OpConversionPattern<EncapsulateOp>(context) {}
+
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult matchAndRewrite(
+      EncapsulateOp op, OpAdaptor adaptor,
+      ConversionPatternRewriter &rewriter) const override {
+    auto modArithType = getResultModArithType(op);
+    if (failed(verifyMontgomeryModulus(op, modArithType))) return failure();
+
+    ImplicitLocOpBuilder b(op.getLoc(), rewriter);
+    auto cmod = b.create<arith::ConstantOp>(modulusAttr(op));
+    auto canonical = buildCanonicalRemainder(b, adaptor.getInput(), cmod);
+    rewriter.replaceOp(op, buildToMontgomery(b, modArithType, canonical));
+    return success();
+  }
+};
+
+struct ConvertExtractMontgomery : public OpConversionPattern<ExtractOp> {
+  ConvertExtractMontgomery(mlir::MLIRContext *context)
+      : OpConversionPattern<ExtractOp>(context) {}
+
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult matchAndRewrite(
+      ExtractOp op, OpAdaptor adaptor,
+      ConversionPatternRewriter &rewriter) const override {
+    auto modArithType = getOperandModArithType(op);
+    if (failed(verifyMontgomeryModulus(op, modArithType))) return failure();
+
+    ImplicitLocOpBuilder b(op.getLoc(), rewriter);
+    rewriter.replaceOp(
+        op, buildFromMontgomery(b, modArithType, adaptor.getInput()));
+    return success();
+  }
+};
+
+struct ConvertConstantMontgomery : public OpConversionPattern<ConstantOp> {
+  ConvertConstantMontgomery(mlir::MLIRContext *context)
+      : OpConversionPattern<ConstantOp>(context) {}
+
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult matchAndRewrite(
+      ConstantOp op, OpAdaptor adaptor,
+      ConversionPatternRewriter &rewriter) const override {
+    auto modArithType = cast<ModArithType>(op.getOutput().getType());
+    if (failed(verifyMontgomeryModulus(op, modArithType))) return failure();
+
+    // The conversion to Montgomery form is folded at compile time:
+    // value * 2^w mod q = value * (2^w mod q) mod q
+    auto montgomery = MontgomeryAttr::get(modArithType);
+    APInt modulus = modArithType.getModulus().getValue();
+    unsigned width = modulus.getBitWidth();
+    APInt modulusExt = modulus.zext(2 * width);
+    APInt value = op.getValue().getValue().getValue().zext(2 * width);
+    APInt rMod = montgomery.getRMod().getValue().zext(2 * width);
+    APInt montValue = (value.urem(modulusExt) * rMod).urem(modulusExt);
+
+    rewriter.replaceOpWithNewOp<arith::ConstantOp>(
+        op, IntegerAttr::get(modArithType.getModulus().getType(),
+                             montValue.trunc(width)));
+    return success();
+  }
+};
+
+// Since REDC(xR * yR) = xyR mod q, a product of two values in Montgomery form
+// is a double-width multiplication followed by a single REDC.
+struct ConvertMulMontgomery : public OpConversionPattern<MulOp> {
+  ConvertMulMontgomery(mlir::MLIRContext *context)
+      : OpConversionPattern<MulOp>(context) {}
+
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult matchAndRewrite(
+      MulOp op, OpAdaptor adaptor,
+      ConversionPatternRewriter &rewriter) const override {
+    auto modArithType = getResultModArithType(op);
+    if (failed(verifyMontgomeryModulus(op, modArithType))) return failure();
+
+    ImplicitLocOpBuilder b(op.getLoc(), rewriter);
+    auto lhs =
+        b.create<arith::ExtUIOp>(modulusType(op, true), adaptor.getLhs());
+    auto rhs =
+        b.create<arith::ExtUIOp>(modulusType(op, true), adaptor.getRhs());
+    auto mul = b.create<arith::MulIOp>(lhs, rhs);
+    rewriter.replaceOp(op, buildMontgomeryReduce(b, modArithType, mul));
+    return success();
+  }
+};
+
+struct ConvertMacMontgomery : public OpConversionPattern<MacOp> {
+  ConvertMacMontgomery(mlir::MLIRContext *context)
+      : OpConversionPattern<MacOp>(context) {}
+
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult matchAndRewrite(
+      MacOp op, OpAdaptor adaptor,
+      ConversionPatternRewriter &rewriter) const override {
+    auto modArithType = getResultModArithType(op);
+    if (failed(verifyMontgomeryModulus(op, modArithType))) return failure();
+
+    ImplicitLocOpBuilder b(op.getLoc(), rewriter);
+    auto x = b.create<arith::ExtUIOp>(modulusType(op, true),
+                                      adaptor.getOperands()[0]);
+    auto y = b.create<arith::ExtUIOp>(modulusType(op, true),
+                                      adaptor.getOperands()[1]);
+    auto mul = b.create<arith::MulIOp>(x, y);
+    auto reduced = buildMontgomeryReduce(b, modArithType, mul);
+
+    // Both summands lie in [0, q), so the sum lies in [0, 2q) and does not
+    // overflow the storage type.
+    auto cmod = b.create<arith::ConstantOp>(modulusAttr(op));
+    auto add = b.create<arith::AddIOp>(reduced, adaptor.getOperands()[2]);
+    rewriter.replaceOp(op, buildSubIfGE(b, add, cmod));
+    return success();
+  }
+};
+
+// The bit width up to which a modulus is considered to fit in a machine word,
+// for the automatic choice of the reduction strategy.
+constexpr unsigned kNativeWordBits = 64;
+
+// A base class for patterns that lower the reductions in mod_arith ops to
+// Barrett reductions and conditional subtractions instead of arith.remui. When
+// `nativeWidthOnly` is set, the pattern only applies to moduli that fit in a
+// machine word, and otherwise defers to the lower-benefit remui patterns.
+template <typename SourceOp>
+struct ConvertBarrettBase : public OpConversionPattern<SourceOp> {
+  ConvertBarrettBase(const TypeConverter &typeConverter,
+                     mlir::MLIRContext *context, bool nativeWidthOnly)
+      : OpConversionPattern<SourceOp>(typeConverter, context, /*benefit=*/2),
+        nativeWidthOnly(nativeWidthOnly) {}
+
+  LogicalResult matchAndRewrite(
+      SourceOp op, typename SourceOp::Adaptor adaptor,
+      ConversionPatternRewriter &rewriter) const final {
+    APInt modulus = getResultModArithType(op).getModulus().getValue();
+    if (nativeWidthOnly && modulus.getActiveBits() > kNativeWordBits) {
+      return rewriter.notifyMatchFailure(
+          op, "modulus does not fit in a machine word");
+    }
+    ImplicitLocOpBuilder b(op.getLoc(), rewriter);
+    rewriter.replaceOp(op, lower(b, op, adaptor, modulus));
+    return success();
+  }
+
+  virtual Value lower(ImplicitLocOpBuilder &b, SourceOp op,
+                      typename SourceOp::Adaptor adaptor,
+                      const APInt &modulus) const = 0;
+
+ private:
+  bool nativeWidthOnly;
+};
+
+// Inputs are canonical, so the sum lies in [0, 2q) and a single conditional
+// subtraction suffices.
+struct ConvertAddBarrett : public ConvertBarrettBase<AddOp> {
+  using ConvertBarrettBase::ConvertBarrettBase;
+
+  Value lower(ImplicitLocOpBuilder &b, AddOp op, OpAdaptor adaptor,
+              const APInt &modulus) const override {
+    auto cmod = b.create<arith::ConstantOp>(modulusAttr(op));
+    auto add = b.create<arith::AddIOp>(adaptor.getLhs(), adaptor.getRhs());
+    return buildSubIfGE(b, add, cmod);
+  }
+};
+
+// Inputs are canonical, so lhs - rhs + q lies in (0, 2q) and a single
+// conditional subtraction suffices.
+struct ConvertSubBarrett : public ConvertBarrettBase<SubOp> {
+  using ConvertBarrettBase::ConvertBarrettBase;
+
+  Value lower(ImplicitLocOpBuilder &b, SubOp op, OpAdaptor adaptor,
+              const APInt &modulus) const override {
+    auto cmod = b.create<arith::ConstantOp>(modulusAttr(op));
+    auto sub = b.create<arith::SubIOp>(adaptor.getLhs(), adaptor.getRhs());
+    auto add = b.create<arith::AddIOp>(sub, cmod);
+    return buildSubIfGE(b, add, cmod);
+  }
+};
+
+struct ConvertMulBarrett : public ConvertBarrettBase<MulOp> {
+  using ConvertBarrettBase::ConvertBarrettBase;
+
+  Value lower(ImplicitLocOpBuilder &b, MulOp op, OpAdaptor adaptor,
+              const APInt &modulus) const override {
+    auto lhs =
+        b.create<arith::ExtUIOp>(modulusType(op, true), adaptor.getLhs());
+    auto rhs =
+        b.create<arith::ExtUIOp>(modulusType(op, true), adaptor.getRhs());
+    auto mul = b.create<arith::MulIOp>(lhs, rhs);
+    // The product of canonical inputs is below q^2 < 2^{2k}.
+    auto reduced =
+        buildBarrettReduce(b, mul, modulus, 2 * modulus.getActiveBits(),
+                           /*numCorrections=*/2);
+    return b.create<arith::TruncIOp>(modulusType(op), reduced);
+  }
+};
+
+struct ConvertMacBarrett : public ConvertBarrettBase<MacOp> {
+  using ConvertBarrettBase::ConvertBarrettBase;
+
+  Value lower(ImplicitLocOpBuilder &b, MacOp op, OpAdaptor adaptor,
+              const APInt &modulus) const override {
+    auto x = b.create<arith::ExtUIOp>(modulusType(op, true),
+                                      adaptor.getOperands()[0]);
+    auto y = b.create<arith::ExtUIOp>(modulusType(op, true),
+                                      adaptor.getOperands()[1]);
+    auto acc = b.create<arith::ExtUIOp>(modulusType(op, true),
+                                        adaptor.getOperands()[2]);
+    auto mul = b.create<arith::MulIOp>(x, y);
+    auto add = b.create<arith::AddIOp>(mul, acc);
+    // (q - 1)^2 + (q - 1) < q^2 < 2^{2k}
+    auto reduced =
+        buildBarrettReduce(b, add, modulus, 2 * modulus.getActiveBits(),
+                           /*numCorrections=*/2);
+    return b.create<arith::TruncIOp>(modulusType(op), reduced);
+  }
+};
+
+// The input is an arbitrary signed integer of the storage width w. Adding a
+// multiple of q that is at least 2^{w-1} makes it non-negative without
+// changing its residue, after which it fits in w + 1 bits.
+struct ConvertReduceBarrett : public ConvertBarrettBase<ReduceOp> {
+  using ConvertBarrettBase::ConvertBarrettBase;
+
+  Value lower(ImplicitLocOpBuilder &b, ReduceOp op, OpAdaptor adaptor,
+              const APInt &modulus) const override {
+    Value input = adaptor.getInput();
+    unsigned width = modulus.getBitWidth();
+    APInt modulusExt = modulus.zext(width + 1);
+    APInt halfRange = APInt::getOneBitSet(width + 1, width - 1);
+    APInt offset =
+        APIntOps::RoundingUDiv(halfRange, modulusExt, APInt::Rounding::UP) *
+        modulusExt;
+
+    auto offsetValue = b.create<arith::ConstantOp>(
+        getIntOrSplatAttr(input.getType(), offset, width + 1));
+    auto ext = b.create<arith::ExtSIOp>(offsetValue.getType(), input);
+    auto shifted = b.create<arith::AddIOp>(ext, offsetValue);
+    auto reduced = buildBarrettReduce(b, shifted, modulus, width + 1,
+                                      /*numCorrections=*/2);
+    return b.create<arith::TruncIOp>(modulusType(op), reduced);
+  }
+};
+
+static bool shouldUseBarrett(StringRef reduction, const APInt &modulus) {
+  return reduction == "barrett" ||
+         (reduction == "auto" && modulus.getActiveBits() <= kNativeWordBits);
+}
+
+// Whether products may skip the final corrections of their Barrett reduction.
+// In auto mode, moduli that fall back to remui are still reduced fully, which
+// stays within the bound assumed by the analysis.
+static bool useLazyProducts(StringRef reduction) {
+  return reduction != "remui";
+}
+
+// Reduces `x`, an unsigned integer (or container of integers) whose values are
+// at most `maxValue`, to its canonical representative modulo `modulus`.
+static Value buildFullReduce(ImplicitLocOpBuilder &b, Value x,
+                             const APInt &modulus, const APInt &maxValue,
+                             bool useBarrett) {
+  Type type = x.getType();
+  unsigned width = getElementTypeOrSelf(type).getIntOrFloatBitWidth();
+  auto cmod =
+      b.create<arith::ConstantOp>(getIntOrSplatAttr(type, modulus, width));
+  if (!useBarrett) {
+    return b.create<arith::RemUIOp>(x, cmod);
+  }
+  APInt twiceModulus = modulus.zext(maxValue.getBitWidth()).shl(1);
+  if (maxValue.ult(twiceModulus)) {
+    return buildSubIfGE(b, x, cmod);
+  }
+  return buildBarrettReduce(b, x, modulus, maxValue.getActiveBits(),
+                            /*numCorrections=*/2);
+}
+
+// Returns the largest integer representative of a value with the given bound,
+// as an integer of the given width.
+static APInt getMaxValue(const APInt &modulus, uint64_t bound,
+                         unsigned width) {
+  return modulus.zext(width) * APInt(width, bound) - 1;
+}
+
+// A base class for patterns that lower mod_arith ops whose operands or result
+// are not canonical according to a LazyReductionAnalysis. Ops for which
+// everything is canonical are left to the regular patterns.
+template <typename SourceOp>
+struct ConvertLazyBase : public OpConversionPattern<SourceOp> {
+  ConvertLazyBase(const TypeConverter &typeConverter,
+                  mlir::MLIRContext *context, const DataFlowSolver *solver,
+                  StringRef reduction)
+      : OpConversionPattern<SourceOp>(typeConverter, context, /*benefit=*/3),
+        solver(solver),
+        reduction(reduction.str()) {}
+
+  LogicalResult matchAndRewrite(
+      SourceOp op, typename SourceOp::Adaptor adaptor,
+      ConversionPatternRewriter &rewriter) const final {
+    auto modArithType = getResultModArithType(op);
+    SmallVector<uint64_t> bounds = llvm::map_to_vector(
+        op->getOperands(),
+        [&](Value operand) { return getReductionBound(*solver, operand); });
+    if (llvm::all_of(bounds, [](uint64_t bound) { return bound == 1; }) &&
+        !producesUnreduced(op, bounds)) {
+      return rewriter.notifyMatchFailure(op, "operands and result are reduced");
+    }
+
+    ImplicitLocOpBuilder b(op.getLoc(), rewriter);
+    APInt modulus = modArithType.getModulus().getValue();
+    rewriter.replaceOp(op, lower(b, op, adaptor, modulus, bounds,
+                                 shouldUseBarrett(reduction, modulus)));
+    return success();
+  }
+
+  virtual bool producesUnreduced(SourceOp op,
+                                 ArrayRef<uint64_t> bounds) const {
+    return false;
+  }
+
+  virtual Value lower(ImplicitLocOpBuilder &b, SourceOp op,
+                      typename SourceOp::Adaptor adaptor, const APInt &modulus,
+                      ArrayRef<uint64_t> bounds, bool useBarrett) const = 0;
+
+ protected:
+  // The bound of the result of `op` according to the analysis.
+  uint64_t getResultBound(SourceOp op) const {
+    return getReductionBound(*solver, op.getResult());
+  }
+
+ private:
+  const DataFlowSolver *solver;
+  std::string reduction;
+};
+
+struct ConvertAddLazy : public ConvertLazyBase<AddOp> {
+  using ConvertLazyBase::ConvertLazyBase;
+
+  bool producesUnreduced(AddOp op,
+                         ArrayRef<uint64_t> bounds) const override {
+    return getAddSubBound(getResultModArithType(op), bounds[0], bounds[1]) > 1;
+  }
+
+  Value lower(ImplicitLocOpBuilder &b, AddOp op, OpAdaptor adaptor,
+              const APInt &modulus, ArrayRef<uint64_t> bounds,
+              bool useBarrett) const override {
+    auto add = b.create<arith::AddIOp>(adaptor.getLhs(), adaptor.getRhs());
+    if (producesUnreduced(op, bounds)) return add;
+
+    // Both operands are below 2^{w-1}, so the sum does not overflow.
+    unsigned width = modulus.getBitWidth();
+    APInt maxValue = getMaxValue(modulus, bounds[0], width) +
+                     getMaxValue(modulus, bounds[1], width);
+    return buildFullReduce(b, add, modulus, maxValue, useBarrett);
+  }
+};
+
+struct ConvertSubLazy : public ConvertLazyBase<SubOp> {
+  using ConvertLazyBase::ConvertLazyBase;
+
+  bool producesUnreduced(SubOp op,
+                         ArrayRef<uint64_t> bounds) const override {
+    return getAddSubBound(getResultModArithType(op), bounds[0], bounds[1]) > 1;
+  }
+
+  Value lower(ImplicitLocOpBuilder &b, SubOp op, OpAdaptor adaptor,
+              const APInt &modulus, ArrayRef<uint64_t> bounds,
+              bool useBarrett) const override {
+    // Adding a multiple of q that exceeds rhs keeps the difference positive.
+    unsigned width = modulus.getBitWidth();
+    APInt offset = getMaxValue(modulus, bounds[1], width) + 1;
+    auto offsetValue = b.create<arith::ConstantOp>(
+        getIntOrSplatAttr(adaptor.getLhs().getType(), offset, width));
+    auto sub = b.create<arith::SubIOp>(adaptor.getLhs(), adaptor.getRhs());
+    auto add = b.create<arith::AddIOp>(sub, offsetValue);
+    if (producesUnreduced(op, bounds)) return add;
+
+    APInt maxValue = getMaxValue(modulus, bounds[0], width) + offset;
+    return buildFullReduce(b, add, modulus, maxValue, useBarrett);
+  }
+};
+
+// Reduces the double-width `x`, whose values are at most `maxValue`, to the
+// bound the analysis assigns to a product. A lazy product keeps the result of
+// the Barrett reduction in [0, 3q) instead of correcting it.
+static Value buildProductReduce(ImplicitLocOpBuilder &b, Value x,
+                                const APInt &modulus, const APInt &maxValue,
+                                bool useBarrett, bool lazy) {
+  if (!lazy || !useBarrett)
+    return buildFullReduce(b, x, modulus, maxValue, useBarrett);
+  return buildBarrettReduce(b, x, modulus, maxValue.getActiveBits(),
+                            /*numCorrections=*/0);
+}
+
+struct ConvertMulLazy : public ConvertLazyBase<MulOp> {
+  using ConvertLazyBase::ConvertLazyBase;
+
+  bool producesUnreduced(MulOp op,
+                         ArrayRef<uint64_t> bounds) const override {
+    return getResultBound(op) > 1;
+  }
+
+  Value lower(ImplicitLocOpBuilder &b, MulOp op, OpAdaptor adaptor,
+              const APInt &modulus, ArrayRef<uint64_t> bounds,
+              bool useBarrett) const override {
+    auto lhs =
+        b.create<arith::ExtUIOp>(modulusType(op, true), adaptor.getLhs());
+    auto rhs =
+        b.create<arith::ExtUIOp>(modulusType(op, true), adaptor.getRhs());
+    auto mul = b.create<arith::MulIOp>(lhs, rhs);
+
+    // Both operands are below 2^{w-1}, so the product does not overflow.
+    unsigned width = 2 * modulus.getBitWidth();
+    APInt maxValue = getMaxValue(modulus, bounds[0], width) *
+                     getMaxValue(modulus, bounds[1], width);
+    auto reduced = buildProductReduce(
+        b, mul, modulus, maxValue, useBarrett,
+        producesUnreduced(op, bounds));
+    return b.create<arith::TruncIOp>(modulusType(op), reduced);
+  }
+};
+
+struct ConvertMacLazy : public ConvertLazyBase<MacOp> {
+  using ConvertLazyBase::ConvertLazyBase;
+
+  bool producesUnreduced(MacOp op,
+                         ArrayRef<uint64_t> bounds) const override {
+    return getResultBound(op) > 1;
+  }
+
+  Value lower(ImplicitLocOpBuilder &b, MacOp op, OpAdaptor adaptor,
+              const APInt &modulus, ArrayRef<uint64_t> bounds,
+              bool useBarrett) const override {
+    auto x = b.create<arith::ExtUIOp>(modulusType(op, true),
+                                      adaptor.getOperands()[0]);
+    auto y = b.create<arith::ExtUIOp>(modulusType(op, true),
+                                      adaptor.getOperands()[1]);
+    auto acc = b.create<arith::ExtUIOp>(modulusType(op, true),
+                                        adaptor.getOperands()[2]);
+    auto mul = b.create<arith::MulIOp>(x, y);
+    auto add = b.create<arith::AddIOp>(mul, acc);
+
+    unsigned width = 2 * modulus.getBitWidth();
+    APInt maxValue = getMaxValue(modulus, bounds[0], width) *
+                         getMaxValue(modulus, bounds[1], width) +
+                     getMaxValue(modulus, bounds[2], width);
+    auto reduced = buildProductReduce(
+        b, add, modulus, maxValue, useBarrett,
+        producesUnreduced(op, bounds));
+    return b.create<arith::TruncIOp>(modulusType(op), reduced);
+  }
+};
+
 namespace rewrites {
 // In an inner namespace to avoid conflicts with canonicalization patterns
 #include "lib/Dialect/ModArith/Conversions/ModArithToArith/ModArithToArith.cpp.inc"
@@ -262,50 +890,15 @@ struct ConvertBarrettReduce : public OpConversionPattern<BarrettReduceOp> {
       ConversionPatternRewriter &rewriter) const override {
     ImplicitLocOpBuilder b(op.getLoc(), rewriter);
 
-    // Compute B = 4^{bitWidth} and ratio = floordiv(B / modulus)
+    // The input is in [0, 2^w) where w is its bit width, and a single
+    // conditional subtraction brings the result into the [0, 2q) range
+    // promised by the op.
     auto input = adaptor.getInput();
-    auto mod = op.getModulus();
-    auto bitWidth = (mod - 1).getActiveBits();
-    mod = mod.trunc(3 * bitWidth);
-    auto B = APInt(3 * bitWidth, 1).shl(2 * bitWidth);
-    auto barrettRatio = B.udiv(mod);
-
-    Type intermediateType = IntegerType::get(b.getContext(), 3 * bitWidth);
-
-    // Create our pre-computed constants
-    TypedAttr ratioAttr, shiftAttr, modAttr;
-    if (auto tensorType = dyn_cast<RankedTensorType>(input.getType())) {
-      tensorType = tensorType.clone(tensorType.getShape(), intermediateType);
-      ratioAttr = DenseElementsAttr::get(tensorType, barrettRatio);
-      shiftAttr =
-          DenseElementsAttr::get(tensorType, APInt(3 * bitWidth, 2 * bitWidth));
-      modAttr = DenseElementsAttr::get(tensorType, mod);
-      intermediateType = tensorType;
-    } else if (auto integerType = dyn_cast<IntegerType>(input.getType())) {
-      ratioAttr = IntegerAttr::get(intermediateType, barrettRatio);
-      shiftAttr =
-          IntegerAttr::get(intermediateType, APInt(3 * bitWidth, 2 * bitWidth));
-      modAttr = IntegerAttr::get(intermediateType, mod);
-    }
-
-    auto ratioValue = b.create<arith::ConstantOp>(intermediateType, ratioAttr);
-    auto shiftValue = b.create<arith::ConstantOp>(intermediateType, shiftAttr);
-    auto modValue = b.create<arith::ConstantOp>(intermediateType, modAttr);
-
-    // Intermediate value will be in the range [0,p^3) so we need to extend to
-    // 3*bitWidth
-    auto extendOp = b.create<arith::ExtUIOp>(intermediateType, input);
-
-    // Compute x - floordiv(x * ratio, B) * mod
-    auto mulRatioOp = b.create<arith::MulIOp>(extendOp, ratioValue);
-    auto shrOp = b.create<arith::ShRUIOp>(mulRatioOp, shiftValue);
-    auto mulModOp = b.create<arith::MulIOp>(shrOp, modValue);
-    auto subOp = b.create<arith::SubIOp>(extendOp, mulModOp);
-
-    auto truncOp = b.create<arith::TruncIOp>(input.getType(), subOp);
-
-    rewriter.replaceOp(op, truncOp);
-
+    unsigned bitWidth =
+        getElementTypeOrSelf(input.getType()).getIntOrFloatBitWidth();
+    auto result = buildBarrettReduce(b, input, op.getModulus(), bitWidth,
+                                     /*numCorrections=*/1);
+    rewriter.replaceOp(op, result);
     return success();
   }
 };
@@ -316,9 +909,128 @@ struct ModArithToArith : impl::ModArithToArithBase<ModArithToArith> {
   void runOnOperation() override;
 };
 
+// Whether `use` is a value stored into a container, as opposed to the
+// container itself.
+static bool isStoredValue(OpOperand &use) {
+  Operation *op = use.getOwner();
+  if (isa<tensor::InsertOp, tensor::InsertSliceOp>(op))
+    return use.getOperandNumber() == 0;
+  return isReductionBoundStore(op);
+}
+
+// Returns the ops enclosing an add or sub whose result bound exceeds what its
+// operands allow. This happens when an unreduced value grows around a loop
+// until the add or sub has to reduce, which the analysis only sees as a larger
+// bound at the loop-carried value.
+static DenseSet<Operation *> getUnstableRegionOps(
+    Operation *root, const DataFlowSolver &solver) {
+  DenseSet<Operation *> unstable;
+  root->walk([&](Operation *op) {
+    if (!isa<AddOp, SubOp>(op)) return;
+    uint64_t lhs = getReductionBound(solver, op->getOperand(0));
+    uint64_t rhs = getReductionBound(solver, op->getOperand(1));
+    auto type = cast<ModArithType>(
+        getElementTypeOrSelf(op->getResult(0).getType()));
+    uint64_t bound = getAddSubBound(type, lhs, rhs);
+    if (getReductionBound(solver, op->getResult(0)) <= bound) return;
+    for (Operation *parent = op->getParentOp();
+         parent && parent != root && !isa<FunctionOpInterface>(parent);
+         parent = parent->getParentOp())
+      unstable.insert(parent);
+  });
+  return unstable;
+}
+
+// Inserts a mod_arith.reduce in front of every consumer of an unreduced value
+// that cannot absorb it, and returns a solver holding the reduction bounds of
+// the resulting IR. Since inserting reductions changes the bounds, this
+// repeats until no more reductions are needed.
+//
+// Bounds that grow around a loop are cut by reducing the values stored into
+// containers inside the loop, and failing that the yielded values. Other
+// consumers are only handled once the bounds are stable, so that they are not
+// reduced based on a bound that a later round shrinks.
+static FailureOr<std::unique_ptr<DataFlowSolver>> insertLazyReductions(
+    Operation *root, bool lazyProducts) {
+  while (true) {
+    auto solver = std::make_unique<DataFlowSolver>();
+    solver->load<dataflow::DeadCodeAnalysis>();
+    solver->load<dataflow::SparseConstantPropagation>();
+    solver->load<LazyReductionAnalysis>(lazyProducts);
+    if (failed(solver->initializeAndRun(root))) return failure();
+
+    DenseSet<Operation *> unstable = getUnstableRegionOps(root, *solver);
+    auto isUnstable = [&](Operation *op) {
+      for (Operation *parent = op->getParentOp(); parent;
+           parent = parent->getParentOp())
+        if (unstable.contains(parent)) return true;
+      return false;
+    };
+
+    SmallVector<OpOperand *> storeUses, terminatorUses, otherUses;
+    auto collectUses = [&](Value value) {
+      if (getReductionBound(*solver, value) == 1) return;
+      for (OpOperand &use : value.getUses()) {
+        Operation *user = use.getOwner();
+        if (isStoredValue(use) && isUnstable(user))
+          storeUses.push_back(&use);
+        else if (isReductionBoundTerminator(user) && isUnstable(user))
+          terminatorUses.push_back(&use);
+        else if (!acceptsUnreduced(user))
+          otherUses.push_back(&use);
+      }
+    };
+    root->walk([&](Operation *op) {
+      for (Value result : op->getResults()) collectUses(result);
+      for (Region &region : op->getRegions())
+        for (Block &block : region)
+          for (BlockArgument arg : block.getArguments()) collectUses(arg);
+    });
+
+    ArrayRef<OpOperand *> unreducedUses = otherUses;
+    if (!storeUses.empty())
+      unreducedUses = storeUses;
+    else if (!terminatorUses.empty())
+      unreducedUses = terminatorUses;
+    if (unreducedUses.empty()) return solver;
+
+    for (OpOperand *use : unreducedUses) {
+      OpBuilder builder(use->getOwner());
+      auto reduce =
+          builder.create<ReduceOp>(use->get().getLoc(), use->get());
+      use->set(reduce);
+    }
+  }
+}
+
 void ModArithToArith::runOnOperation() {
   MLIRContext *context = &getContext();
   ModuleOp module = getOperation();
+
+  if (reduction != "auto" && reduction != "barrett" && reduction != "remui") {
+    module.emitError() << "unknown reduction strategy '" << reduction
+                       << "', expected one of auto, barrett, remui";
+    signalPassFailure();
+    return;
+  }
+  if (lazyReduction && useMontgomery) {
+    module.emitError()
+        << "lazy-reduction is not supported together with use-montgomery";
+    signalPassFailure();
+    return;
+  }
+
+  std::unique_ptr<DataFlowSolver> solver;
+  if (lazyReduction) {
+    auto result = insertLazyReductions(module, useLazyProducts(reduction));
+    if (failed(result)) {
+      module.emitOpError() << "Failed to run the analysis.\n";
+      signalPassFailure();
+      return;
+    }
+    solver = std::move(result.value());
+  }
+
   ModArithToArithTypeConverter typeConverter(context);
 
   ConversionTarget target(*context);
@@ -327,10 +1039,33 @@ void ModArithToArith::runOnOperation() {
 
   RewritePatternSet patterns(context);
   rewrites::populateWithGenerated(patterns);
+  if (useMontgomery) {
+    patterns.add<ConvertEncapsulateMontgomery, ConvertExtractMontgomery,
+                 ConvertConstantMontgomery, ConvertMulMontgomery,
+                 ConvertMacMontgomery>(typeConverter, context);
+  } else {
+    patterns.add<ConvertEncapsulate, ConvertExtract, ConvertConstant,
+                 ConvertMul, ConvertMac>(typeConverter, context);
+  }
+  if (lazyReduction) {
+    patterns.add<ConvertAddLazy, ConvertSubLazy, ConvertMulLazy,
+                 ConvertMacLazy>(typeConverter, context, solver.get(),
+                                 reduction);
+  }
+  if (reduction != "remui") {
+    // In auto mode, the remui patterns below remain as a fallback for moduli
+    // that do not fit in a machine word.
+    bool nativeWidthOnly = reduction == "auto";
+    patterns.add<ConvertAddBarrett, ConvertSubBarrett, ConvertReduceBarrett>(
+        typeConverter, context, nativeWidthOnly);
+    if (!useMontgomery) {
+      patterns.add<ConvertMulBarrett, ConvertMacBarrett>(typeConverter, context,
+                                                         nativeWidthOnly);
+    }
+  }
   patterns
-      .add<ConvertEncapsulate, ConvertExtract, ConvertReduce, ConvertAdd,
-           ConvertSub, ConvertMul, ConvertMac, ConvertBarrettReduce,
-           ConvertConstant, ConvertAny<>, ConvertAny<affine::AffineForOp>,
+      .add<ConvertReduce, ConvertAdd, ConvertSub, ConvertBarrettReduce,
+           ConvertAny<>, ConvertAny<affine::AffineForOp>,
            ConvertAny<affine::AffineYieldOp>, ConvertAny<linalg::GenericOp> >(
           typeConverter, context);
 
@@ -136,6 +136,21 @@ LogicalResult BarrettReduceOp::verify() {
   return success();
 }
 
+LogicalResult MontgomeryAttr::verify(
+    function_ref<InFlightDiagnostic()> emitError, IntegerAttr modulus,
+    IntegerAttr negModulusInv, IntegerAttr rMod, IntegerAttr rSquared) {
+  if (!modulus.getValue()[0])
+    return emitError() << "Montgomery arithmetic requires an odd modulus, but "
+                       << "got " << modulus << ".";
+  for (IntegerAttr param : {negModulusInv, rMod, rSquared}) {
+    if (param.getType() != modulus.getType())
+      return emitError() << "expected all parameters to have the modulus "
+                         << "storage type " << modulus.getType() << ", but got "
+                         << param.getType() << ".";
+  }
+  return success();
+}
+
 ParseResult ConstantOp::parse(OpAsmParser &parser, OperationState &result) {
   APInt parsedValue(64, 0);
   Type parsedType;
@@ -9,4 +9,18 @@
 // Generated headers (block clang-format from messing up order)
 #include "lib/Dialect/Openfhe/IR/OpenfheDialect.h.inc"
 
+namespace mlir {
+namespace heir {
+namespace openfhe {
+
+/// The name of the unit attribute marking plaintext encoding ops whose result
+/// only depends on the crypto context, so that the generated code may encode
+/// the plaintext once per crypto context and reuse it across calls.
+constexpr const static ::llvm::StringLiteral kCachedPlaintextAttrName =
+    "openfhe.cached";
+
+}  // namespace openfhe
+}  // namespace heir
+}  // namespace mlir
+
 #endif  // LIB_DIALECT_OPENFHE_IR_OPENFHEDIALECT_H_
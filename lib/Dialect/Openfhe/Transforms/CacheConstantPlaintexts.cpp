@@ -0,0 +1,58 @@
+#include "lib/Dialect/Openfhe/Transforms/CacheConstantPlaintexts.h"
+
+#include "lib/Dialect/Openfhe/IR/OpenfheDialect.h"
+#include "lib/Dialect/Openfhe/IR/OpenfheOps.h"
+#include "llvm/include/llvm/ADT/STLExtras.h"           // from @llvm-project
+#include "mlir/include/mlir/Dialect/Arith/IR/Arith.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/Builders.h"             // from @llvm-project
+#include "mlir/include/mlir/IR/Operation.h"            // from @llvm-project
+#include "mlir/include/mlir/IR/Value.h"                // from @llvm-project
+#include "mlir/include/mlir/IR/Visitors.h"             // from @llvm-project
+#include "mlir/include/mlir/Support/LLVM.h"            // from @llvm-project
+
+namespace mlir {
+namespace heir {
+namespace openfhe {
+
+#define GEN_PASS_DEF_CACHECONSTANTPLAINTEXTS
+#include "lib/Dialect/Openfhe/Transforms/Passes.h.inc"
+
+// Returns true if `value` is a constant, possibly after the casts the
+// lowering inserts in front of the encoding ops, e.g. to widen the cleartexts
+// to the std::vector<int64_t> expected by MakePackedPlaintext.
+static bool isCompileTimeConstant(Value value) {
+  Operation *definingOp = value.getDefiningOp();
+  if (!definingOp) return false;
+  if (definingOp->hasTrait<OpTrait::ConstantLike>()) return true;
+  if (!isa<arith::ExtSIOp, arith::ExtUIOp, arith::ExtFOp, arith::SIToFPOp,
+           arith::IndexCastOp>(definingOp)) {
+    return false;
+  }
+  return llvm::all_of(definingOp->getOperands(), isCompileTimeConstant);
+}
+
+struct CacheConstantPlaintexts
+    : impl::CacheConstantPlaintextsBase<CacheConstantPlaintexts> {
+  using CacheConstantPlaintextsBase::CacheConstantPlaintextsBase;
+
+  void runOnOperation() override {
+    OpBuilder builder(&getContext());
+    getOperation()->walk([&](Operation *op) {
+      Value cleartexts;
+      if (auto encodeOp = dyn_cast<MakePackedPlaintextOp>(op)) {
+        cleartexts = encodeOp.getValue();
+      } else if (auto encodeOp = dyn_cast<MakeCKKSPackedPlaintextOp>(op)) {
+        cleartexts = encodeOp.getValue();
+      } else {
+        return;
+      }
+      if (isCompileTimeConstant(cleartexts)) {
+        op->setAttr(kCachedPlaintextAttrName, builder.getUnitAttr());
+      }
+    });
+  }
+};
+
+}  // namespace openfhe
+}  // namespace heir
+}  // namespace mlir
@@ -1,13 +1,19 @@
 #include "lib/Dialect/Openfhe/Transforms/ConfigureCryptoContext.h"
 
 #include <algorithm>
+#include <cmath>
 #include <cstdint>
 #include <set>
 #include <string>
+#include <utility>
 
 #include "lib/Analysis/MulDepthAnalysis/MulDepthAnalysis.h"
+#include "lib/Analysis/NoiseAnalysis/NoiseAnalysis.h"
+#include "lib/Dialect/LWE/IR/LWEAttributes.h"
+#include "lib/Dialect/LWE/IR/LWETypes.h"
 #include "lib/Dialect/Openfhe/IR/OpenfheOps.h"
 #include "lib/Dialect/Openfhe/IR/OpenfheTypes.h"
+#include "llvm/include/llvm/Support/MathExtras.h"   // from @llvm-project
 #include "llvm/include/llvm/Support/raw_ostream.h"  // from @llvm-project
 #include "mlir/include/mlir/Analysis/DataFlow/ConstantPropagationAnalysis.h"  // from @llvm-project
 #include "mlir/include/mlir/Analysis/DataFlow/DeadCodeAnalysis.h"  // from @llvm-project
@@ -16,6 +22,7 @@
 #include "mlir/include/mlir/Dialect/Func/IR/FuncOps.h"     // from @llvm-project
 #include "mlir/include/mlir/IR/BuiltinAttributes.h"        // from @llvm-project
 #include "mlir/include/mlir/IR/BuiltinOps.h"               // from @llvm-project
+#include "mlir/include/mlir/IR/BuiltinTypes.h"             // from @llvm-project
 #include "mlir/include/mlir/IR/ImplicitLocOpBuilder.h"     // from @llvm-project
 #include "mlir/include/mlir/IR/Operation.h"                // from @llvm-project
 #include "mlir/include/mlir/IR/Types.h"                    // from @llvm-project
@@ -52,11 +59,130 @@ SmallVector<int64_t> findAllRotIndices(func::FuncOp op) {
     distinctRotIndices.insert(rotOp.getIndex().getInt());
     return WalkResult::advance();
   });
+  op.walk([&](openfhe::FastRotationOp rotOp) {
+    distinctRotIndices.insert(rotOp.getIndex().getInt());
+    return WalkResult::advance();
+  });
   SmallVector<int64_t> rotIndicesResult(distinctRotIndices.begin(),
                                         distinctRotIndices.end());
   return rotIndicesResult;
 }
 
+namespace {
+
+// The largest coefficient modulus bit size, including the special modulus of
+// key switching, for 128-bit classical security with ternary secrets,
+// following the tables of the homomorphic encryption standard used by OpenFHE.
+constexpr std::pair<int64_t, int64_t> kMaxLog2ModulusByRingDim[] = {
+    {1024, 27},   {2048, 54},   {4096, 109},  {8192, 218},
+    {16384, 438}, {32768, 881}, {65536, 1747}};
+
+// The bits of the first CKKS modulus above the scaling factor, which hold the
+// integer part of the messages, as in OpenFHE's default modulus sizes.
+constexpr int64_t kCKKSMessageBits = 10;
+
+// The largest modulus size OpenFHE supports with its native 64-bit integers.
+constexpr int64_t kMaxModSize = 60;
+
+// The number of digits of hybrid key switching, as OpenFHE picks by default.
+constexpr int64_t kMaxKeySwitchDigits = 3;
+
+// The parameters of a crypto context, where 0 leaves the choice to OpenFHE.
+struct CryptoContextParams {
+  int64_t ringDim = 0;
+  int64_t firstModSize = 0;
+  int64_t scalingModSize = 0;
+};
+
+}  // namespace
+
+// Returns true if the ciphertexts in the function are CKKS ciphertexts, and
+// sets `minRingDim` to the smallest ring dimension with enough slots for them
+// and `precisionBits` to the largest number of cleartext bits they encode.
+bool inspectCiphertexts(func::FuncOp op, int64_t &minRingDim,
+                        int64_t &precisionBits) {
+  bool ckks = false;
+  int64_t maxSlots = 1;
+  precisionBits = 0;
+  auto visitType = [&](Type type) {
+    auto ctType = dyn_cast<lwe::RLWECiphertextType>(type);
+    if (!ctType) return;
+    int64_t slots = 1;
+    if (auto shapedType = dyn_cast<ShapedType>(ctType.getUnderlyingType()))
+      slots = shapedType.getNumElements();
+    if (auto encoding = dyn_cast<lwe::InverseCanonicalEmbeddingEncodingAttr>(
+            ctType.getEncoding())) {
+      ckks = true;
+      // CKKS packs n / 2 slots.
+      slots *= 2;
+      precisionBits = std::max<int64_t>(precisionBits,
+                                        encoding.getCleartextBitwidth());
+    }
+    maxSlots = std::max(maxSlots, slots);
+  };
+  for (Type type : op.getArgumentTypes()) visitType(type);
+  op.walk([&](Operation *nested) {
+    for (Type type : nested->getResultTypes()) visitType(type);
+  });
+  minRingDim = llvm::PowerOf2Ceil(maxSlots);
+  return ckks;
+}
+
+// Returns the smallest secure ring dimension, with the modulus sizes of the
+// modulus chain, for which the noise bounds of the NoiseAnalysis guarantee
+// that the outputs of the function decrypt correctly, or failure if even the
+// largest ring dimension is not enough. Only CKKS is supported: for BGV,
+// OpenFHE derives the modulus chain from its own noise estimates, so all
+// parameters are left to OpenFHE and no analysis is run.
+FailureOr<CryptoContextParams> selectParams(func::FuncOp op, int64_t mulDepth,
+                                            int64_t plainMod) {
+  int64_t minRingDim = 0;
+  int64_t precisionBits = 0;
+  bool ckks = inspectCiphertexts(op, minRingDim, precisionBits);
+  // TODO(#661): Select the BGV parameters once the NoiseAnalysis models
+  // OpenFHE's BGV modulus chain.
+  if (!ckks) return CryptoContextParams();
+
+  for (const auto &[ringDim, maxLog2Modulus] : kMaxLog2ModulusByRingDim) {
+    if (ringDim < minRingDim) continue;
+
+    NoiseModel model{ringDim, std::log2(static_cast<double>(plainMod)), ckks};
+    DataFlowSolver solver;
+    solver.load<dataflow::DeadCodeAnalysis>();
+    solver.load<dataflow::SparseConstantPropagation>();
+    auto *analysis = solver.load<NoiseAnalysis>(model);
+    if (failed(solver.initializeAndRun(op))) return failure();
+
+    // OpenFHE rescales products before decrypting them.
+    double outputBound = model.log2Fresh();
+    op.walk([&](func::ReturnOp returnOp) {
+      for (Value result : returnOp.getOperands()) {
+        const auto *lattice = solver.lookupState<NoiseLattice>(result);
+        if (!lattice || !lattice->getValue().isInitialized()) continue;
+        outputBound = std::max(outputBound,
+                               analysis->getRescaledBound(lattice->getValue()));
+      }
+    });
+
+    CryptoContextParams params;
+    params.ringDim = ringDim;
+    params.scalingModSize =
+        static_cast<int64_t>(std::ceil(outputBound)) + precisionBits;
+    // The noise only grows with the ring dimension, so no larger ring
+    // dimension fits either.
+    if (params.scalingModSize >= kMaxModSize) return failure();
+    params.firstModSize =
+        std::min(params.scalingModSize + kCKKSMessageBits, kMaxModSize);
+    int64_t log2Modulus =
+        params.firstModSize + mulDepth * params.scalingModSize;
+    int64_t numDigits = std::min(mulDepth + 1, kMaxKeySwitchDigits);
+    int64_t log2SpecialModulus = llvm::divideCeil(log2Modulus, numDigits);
+    if (log2Modulus + log2SpecialModulus > maxLog2Modulus) continue;
+    return params;
+  }
+  return failure();
+}
+
 // function that generates the crypto context with proper parameters
 LogicalResult generateGenFunc(func::FuncOp op, const std::string &genFuncName,
                               int64_t mulDepth, ImplicitLocOpBuilder &builder) {
@@ -73,9 +199,20 @@ LogicalResult generateGenFunc(func::FuncOp op, const std::string &genFuncName,
 
   // TODO(#661) : Calculate the appropriate values by analyzing the function
   int64_t plainMod = 4295294977;
+
+  // Without parameters that fit the noise of the function, OpenFHE picks the
+  // ring dimension and modulus sizes itself.
+  CryptoContextParams params;
+  auto selectedParams = selectParams(op, mulDepth, plainMod);
+  if (succeeded(selectedParams)) {
+    params = selectedParams.value();
+  } else {
+    op.emitWarning() << "no secure ring dimension fits the estimated noise";
+  }
   Type openfheParamsType = openfhe::CCParamsType::get(builder.getContext());
-  Value ccParams = builder.create<openfhe::GenParamsOp>(openfheParamsType,
-                                                        mulDepth, plainMod);
+  Value ccParams = builder.create<openfhe::GenParamsOp>(
+      openfheParamsType, mulDepth, plainMod, params.ringDim,
+      params.firstModSize, params.scalingModSize);
   Value cryptoContext =
       builder.create<openfhe::GenContextOp>(openfheContextType, ccParams);
 
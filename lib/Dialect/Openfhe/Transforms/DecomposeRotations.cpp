@@ -0,0 +1,142 @@
+#include "lib/Dialect/Openfhe/Transforms/DecomposeRotations.h"
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <set>
+#include <string>
+#include <utility>
+
+#include "lib/Dialect/Openfhe/IR/OpenfheOps.h"
+#include "llvm/include/llvm/ADT/SmallVector.h"       // from @llvm-project
+#include "llvm/include/llvm/Support/Debug.h"         // from @llvm-project
+#include "mlir/include/mlir/IR/Builders.h"           // from @llvm-project
+#include "mlir/include/mlir/IR/BuiltinAttributes.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/Value.h"              // from @llvm-project
+#include "mlir/include/mlir/IR/Visitors.h"           // from @llvm-project
+#include "mlir/include/mlir/Support/LLVM.h"          // from @llvm-project
+
+#define DEBUG_TYPE "openfhe-decompose-rotations"
+
+namespace mlir {
+namespace heir {
+namespace openfhe {
+
+#define GEN_PASS_DEF_DECOMPOSEROTATIONS
+#include "lib/Dialect/Openfhe/Transforms/Passes.h.inc"
+
+using Decomposition = std::function<SmallVector<int64_t>(int64_t)>;
+
+// Decomposes `shift` into its nonzero digits in radix 2^logRadix, each scaled
+// by its place value and carrying the sign of `shift`. E.g., in radix 4,
+// 7 = 3 + 4 and -7 = -3 + -4.
+static SmallVector<int64_t> decomposeRadix(int64_t shift, unsigned logRadix) {
+  int64_t sign = shift < 0 ? -1 : 1;
+  uint64_t remaining = shift < 0 ? -(uint64_t)shift : shift;
+  uint64_t radix = uint64_t{1} << logRadix;
+  SmallVector<int64_t> result;
+  for (uint64_t place = 1; remaining != 0; place *= radix) {
+    uint64_t digit = remaining % radix;
+    if (digit != 0) result.push_back(sign * (int64_t)(digit * place));
+    remaining /= radix;
+  }
+  return result;
+}
+
+// Decomposes `shift` into its non-adjacent form, a sum of signed powers of
+// two of which no two are adjacent. E.g., 7 = -1 + 8.
+static SmallVector<int64_t> decomposeNAF(int64_t shift) {
+  int64_t sign = shift < 0 ? -1 : 1;
+  uint64_t remaining = shift < 0 ? -(uint64_t)shift : shift;
+  SmallVector<int64_t> result;
+  for (uint64_t place = 1; remaining != 0; place *= 2) {
+    if (remaining % 2 == 1) {
+      // Choose the digit +-1 that makes the remainder divisible by 4.
+      if (remaining % 4 == 1) {
+        result.push_back(sign * (int64_t)place);
+        remaining -= 1;
+      } else {
+        result.push_back(-sign * (int64_t)place);
+        remaining += 1;
+      }
+    }
+    remaining /= 2;
+  }
+  return result;
+}
+
+struct DecomposeRotations : impl::DecomposeRotationsBase<DecomposeRotations> {
+  using DecomposeRotationsBase::DecomposeRotationsBase;
+
+  void runOnOperation() override {
+    SmallVector<RotOp> rotOps;
+    getOperation()->walk([&](RotOp op) { rotOps.push_back(op); });
+    if (rotOps.empty()) return;
+
+    // The candidate bases, in order of preference for equal costs. The first
+    // keeps every shift as is.
+    SmallVector<std::pair<std::string, Decomposition>> candidates = {
+        {"identity", [](int64_t shift) { return SmallVector<int64_t>{shift}; }},
+        {"binary", [](int64_t shift) { return decomposeRadix(shift, 1); }},
+        {"naf", decomposeNAF},
+        {"radix-4", [](int64_t shift) { return decomposeRadix(shift, 2); }},
+        {"radix-8", [](int64_t shift) { return decomposeRadix(shift, 3); }},
+    };
+
+    // Each rotation key has the same size, so the key memory is proportional
+    // to the number of distinct shifts used, and the cost of a basis is the
+    // number of rotations it executes times the number of keys it needs.
+    const Decomposition *best = nullptr;
+    const Decomposition *fewestKeys = nullptr;
+    uint64_t bestCost = std::numeric_limits<uint64_t>::max();
+    uint64_t minNumKeys = std::numeric_limits<uint64_t>::max();
+    for (const auto &[name, decompose] : candidates) {
+      std::set<int64_t> keys;
+      uint64_t numRotations = 0;
+      for (RotOp op : rotOps) {
+        SmallVector<int64_t> shifts = decompose(op.getIndex().getInt());
+        keys.insert(shifts.begin(), shifts.end());
+        numRotations += shifts.size();
+      }
+      uint64_t cost = numRotations * keys.size();
+      LLVM_DEBUG(llvm::dbgs() << "Basis " << name << ": " << keys.size()
+                              << " keys, " << numRotations
+                              << " rotations\n");
+      if (keys.size() < minNumKeys) {
+        minNumKeys = keys.size();
+        fewestKeys = &decompose;
+      }
+      if ((keyBudget <= 0 || keys.size() <= (uint64_t)keyBudget) &&
+          cost < bestCost) {
+        bestCost = cost;
+        best = &decompose;
+      }
+    }
+
+    if (!best) {
+      getOperation()->emitWarning()
+          << "no rotation basis fits the key budget of " << keyBudget
+          << " keys; using the basis with the fewest keys (" << minNumKeys
+          << ")";
+      best = fewestKeys;
+    }
+    if (best == &candidates.front().second) return;
+
+    for (RotOp op : rotOps) {
+      OpBuilder builder(op);
+      Value result = op.getCiphertext();
+      IntegerAttr index = op.getIndex();
+      for (int64_t shift : (*best)(index.getInt())) {
+        result = builder.create<RotOp>(
+            op.getLoc(), op.getOutput().getType(), op.getCryptoContext(),
+            result, builder.getIntegerAttr(index.getType(), shift));
+      }
+      op.replaceAllUsesWith(result);
+      op.erase();
+    }
+  }
+};
+
+}  // namespace openfhe
+}  // namespace heir
+}  // namespace mlir
@@ -0,0 +1,60 @@
+#include "lib/Dialect/Openfhe/Transforms/FastRotationPrecompute.h"
+
+#include <utility>
+
+#include "lib/Dialect/Openfhe/IR/OpenfheOps.h"
+#include "lib/Dialect/Openfhe/IR/OpenfheTypes.h"
+#include "llvm/include/llvm/ADT/MapVector.h"    // from @llvm-project
+#include "llvm/include/llvm/ADT/SmallVector.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/Block.h"         // from @llvm-project
+#include "mlir/include/mlir/IR/Builders.h"      // from @llvm-project
+#include "mlir/include/mlir/IR/Value.h"         // from @llvm-project
+#include "mlir/include/mlir/IR/Visitors.h"      // from @llvm-project
+#include "mlir/include/mlir/Support/LLVM.h"     // from @llvm-project
+
+namespace mlir {
+namespace heir {
+namespace openfhe {
+
+#define GEN_PASS_DEF_FASTROTATIONPRECOMPUTE
+#include "lib/Dialect/Openfhe/Transforms/Passes.h.inc"
+
+struct FastRotationPrecompute
+    : impl::FastRotationPrecomputeBase<FastRotationPrecompute> {
+  using FastRotationPrecomputeBase::FastRotationPrecomputeBase;
+
+  void runOnOperation() override {
+    // Group the rotations by the block they are in and the ciphertext they
+    // rotate. Restricting groups to a single block ensures that the
+    // precomputation, placed before the first rotation of the group, dominates
+    // all of them.
+    llvm::MapVector<std::pair<Block *, Value>, SmallVector<RotOp>> groups;
+    getOperation()->walk([&](RotOp op) {
+      groups[{op->getBlock(), op.getCiphertext()}].push_back(op);
+    });
+
+    for (auto &[key, rotOps] : groups) {
+      if (rotOps.size() < 2) continue;
+
+      // The walk visits the ops of a block in order, so the first rotation of
+      // the group comes first.
+      RotOp first = rotOps.front();
+      OpBuilder builder(first);
+      auto precomputed = builder.create<FastRotationPrecomputeOp>(
+          first.getLoc(), DigitDecompType::get(&getContext()),
+          first.getCryptoContext(), first.getCiphertext());
+      for (RotOp op : rotOps) {
+        builder.setInsertionPoint(op);
+        auto fastRot = builder.create<FastRotationOp>(
+            op.getLoc(), op.getOutput().getType(), op.getCryptoContext(),
+            op.getCiphertext(), op.getIndexAttr(), precomputed.getResult());
+        op.replaceAllUsesWith(fastRot.getResult());
+        op.erase();
+      }
+    }
+  }
+};
+
+}  // namespace openfhe
+}  // namespace heir
+}  // namespace mlir
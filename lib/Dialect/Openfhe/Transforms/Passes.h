@@ -2,7 +2,11 @@
 #define LIB_DIALECT_OPENFHE_TRANSFORMS_PASSES_H_
 
 #include "lib/Dialect/Openfhe/IR/OpenfheDialect.h"
+#include "lib/Dialect/Openfhe/Transforms/CacheConstantPlaintexts.h"
 #include "lib/Dialect/Openfhe/Transforms/ConfigureCryptoContext.h"
+#include "lib/Dialect/Openfhe/Transforms/DecomposeRotations.h"
+#include "lib/Dialect/Openfhe/Transforms/FastRotationPrecompute.h"
+#include "lib/Dialect/Openfhe/Transforms/ReleaseCiphertexts.h"
 
 namespace mlir {
 namespace heir {
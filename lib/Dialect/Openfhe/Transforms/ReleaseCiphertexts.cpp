@@ -0,0 +1,126 @@
+#include "lib/Dialect/Openfhe/Transforms/ReleaseCiphertexts.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "lib/Dialect/LWE/IR/LWEOps.h"
+#include "lib/Dialect/LWE/IR/LWETypes.h"
+#include "lib/Dialect/Openfhe/IR/OpenfheDialect.h"
+#include "lib/Dialect/Openfhe/IR/OpenfheOps.h"
+#include "llvm/include/llvm/ADT/DenseSet.h"             // from @llvm-project
+#include "llvm/include/llvm/ADT/MapVector.h"            // from @llvm-project
+#include "llvm/include/llvm/ADT/STLExtras.h"            // from @llvm-project
+#include "mlir/include/mlir/Dialect/Func/IR/FuncOps.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/Block.h"                 // from @llvm-project
+#include "mlir/include/mlir/IR/Builders.h"              // from @llvm-project
+#include "mlir/include/mlir/IR/Operation.h"             // from @llvm-project
+#include "mlir/include/mlir/IR/Value.h"                 // from @llvm-project
+#include "mlir/include/mlir/Support/LLVM.h"             // from @llvm-project
+
+namespace mlir {
+namespace heir {
+namespace openfhe {
+
+#define GEN_PASS_DEF_RELEASECIPHERTEXTS
+#include "lib/Dialect/Openfhe/Transforms/Passes.h.inc"
+
+// Returns the value whose variable holds `value` in the generated code, which
+// is `value` itself unless it reinterprets the type of another ciphertext, in
+// which case it is emitted as a reference to that ciphertext.
+static Value getStorage(Value value) {
+  while (auto op = value.getDefiningOp<lwe::ReinterpretUnderlyingTypeOp>()) {
+    value = op.getInput();
+  }
+  return value;
+}
+
+// Returns true if `value` is a ciphertext computed by an OpenFHE op, which the
+// generated code holds in a variable of its own. Function arguments and
+// ciphertexts extracted from tensors are held by the caller or the tensor.
+static bool isOwnedCiphertext(Value value) {
+  Operation *definingOp = value.getDefiningOp();
+  return definingOp &&
+         isa_and_nonnull<OpenfheDialect>(definingOp->getDialect()) &&
+         isa<lwe::RLWECiphertextType>(value.getType());
+}
+
+// Returns the number of owned ciphertexts that are alive at the same time
+// when each is released by an openfhe.release op, or when none are released.
+static int64_t getPeakLiveCiphertexts(func::FuncOp funcOp, bool withReleases) {
+  int64_t live = 0;
+  int64_t peak = 0;
+  funcOp.walk([&](Operation *op) {
+    if (isa<ReleaseOp>(op)) {
+      if (withReleases) --live;
+      return;
+    }
+    live += llvm::count_if(op->getResults(), isOwnedCiphertext);
+    peak = std::max(peak, live);
+  });
+  return peak;
+}
+
+struct ReleaseCiphertexts : impl::ReleaseCiphertextsBase<ReleaseCiphertexts> {
+  using ReleaseCiphertextsBase::ReleaseCiphertextsBase;
+
+  void processFunc(func::FuncOp funcOp) {
+    // The last use of each owned ciphertext, including the uses of the values
+    // referring to its variable, as the op in the block of its definition
+    // that contains the use.
+    llvm::MapVector<Value, Operation *> lastUsers;
+    // Ciphertexts used outside the block of their definition, whose lifetime
+    // is not bounded by an op of that block.
+    llvm::DenseSet<Value> escaping;
+    // Ciphertexts that are already released, e.g., by an earlier run of this
+    // pass. A release is not a use that extends the lifetime.
+    llvm::DenseSet<Value> released;
+    funcOp.walk([&](Operation *op) {
+      if (auto releaseOp = dyn_cast<ReleaseOp>(op)) {
+        released.insert(getStorage(releaseOp.getCiphertext()));
+        return;
+      }
+      for (Value operand : op->getOperands()) {
+        Value storage = getStorage(operand);
+        if (!isOwnedCiphertext(storage)) continue;
+        Operation *user = storage.getParentBlock()->findAncestorOpInBlock(*op);
+        if (!user) {
+          escaping.insert(storage);
+          continue;
+        }
+        auto [it, inserted] = lastUsers.try_emplace(storage, user);
+        if (!inserted && it->second->isBeforeInBlock(user)) it->second = user;
+      }
+    });
+
+    // Releases after the same op are each inserted right after it, so visit
+    // the ciphertexts in reverse to release them in the order of first use.
+    OpBuilder builder(&getContext());
+    for (auto &[storage, lastUser] : llvm::reverse(lastUsers)) {
+      // Ciphertexts used by a terminator are returned or passed on, so they
+      // must outlive the block.
+      if (escaping.contains(storage) || released.contains(storage) ||
+          lastUser->hasTrait<OpTrait::IsTerminator>()) {
+        continue;
+      }
+      builder.setInsertionPointAfter(lastUser);
+      builder.create<ReleaseOp>(lastUser->getLoc(), storage);
+    }
+
+    if (reportPeak) {
+      funcOp.emitRemark() << "peak of "
+                          << getPeakLiveCiphertexts(funcOp,
+                                                    /*withReleases=*/true)
+                          << " live ciphertexts, down from "
+                          << getPeakLiveCiphertexts(funcOp,
+                                                    /*withReleases=*/false);
+    }
+  }
+
+  void runOnOperation() override {
+    getOperation()->walk([&](func::FuncOp funcOp) { processFunc(funcOp); });
+  }
+};
+
+}  // namespace openfhe
+}  // namespace heir
+}  // namespace mlir
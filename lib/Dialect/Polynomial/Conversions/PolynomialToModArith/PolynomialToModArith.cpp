@@ -18,20 +18,27 @@
 #include "lib/Dialect/Polynomial/IR/PolynomialDialect.h"
 #include "lib/Dialect/Polynomial/IR/PolynomialOps.h"
 #include "lib/Dialect/Polynomial/IR/PolynomialTypes.h"
+#include "lib/Dialect/RNS/IR/RNSOps.h"
+#include "lib/Dialect/RNS/IR/RNSTypes.h"
 #include "lib/Utils/ConversionUtils/ConversionUtils.h"
+#include "llvm/include/llvm/ADT/APInt.h"               // from @llvm-project
+#include "llvm/include/llvm/ADT/SmallVectorExtras.h"   // from @llvm-project
 #include "llvm/include/llvm/ADT/TypeSwitch.h"          // from @llvm-project
 #include "llvm/include/llvm/Support/Casting.h"         // from @llvm-project
 #include "llvm/include/llvm/Support/Debug.h"           // from @llvm-project
 #include "llvm/include/llvm/Support/FormatVariadic.h"  // from @llvm-project
 #include "mlir/include/mlir/Dialect/Affine/IR/AffineOps.h"  // from @llvm-project
 #include "mlir/include/mlir/Dialect/Arith/IR/Arith.h"   // from @llvm-project
+#include "mlir/include/mlir/Dialect/Bufferization/IR/Bufferization.h"  // from @llvm-project
 #include "mlir/include/mlir/Dialect/Func/IR/FuncOps.h"  // from @llvm-project
 #include "mlir/include/mlir/Dialect/Func/Transforms/FuncConversions.h"  // from @llvm-project
 #include "mlir/include/mlir/Dialect/LLVMIR/LLVMAttrs.h"    // from @llvm-project
 #include "mlir/include/mlir/Dialect/LLVMIR/LLVMDialect.h"  // from @llvm-project
 #include "mlir/include/mlir/Dialect/Linalg/IR/Linalg.h"    // from @llvm-project
+#include "mlir/include/mlir/Dialect/MemRef/IR/MemRef.h"    // from @llvm-project
 #include "mlir/include/mlir/Dialect/SCF/IR/SCF.h"          // from @llvm-project
 #include "mlir/include/mlir/Dialect/Tensor/IR/Tensor.h"    // from @llvm-project
+#include "mlir/include/mlir/Dialect/Utils/ReshapeOpsUtils.h"  // from @llvm-project
 #include "mlir/include/mlir/Dialect/Utils/StructuredOpsUtils.h"  // from @llvm-project
 #include "mlir/include/mlir/IR/AffineExpr.h"             // from @llvm-project
 #include "mlir/include/mlir/IR/AffineMap.h"              // from @llvm-project
@@ -44,6 +51,7 @@
 #include "mlir/include/mlir/IR/Location.h"               // from @llvm-project
 #include "mlir/include/mlir/IR/OpDefinition.h"           // from @llvm-project
 #include "mlir/include/mlir/IR/PatternMatch.h"           // from @llvm-project
+#include "mlir/include/mlir/IR/SymbolTable.h"            // from @llvm-project
 #include "mlir/include/mlir/IR/TypeRange.h"              // from @llvm-project
 #include "mlir/include/mlir/IR/ValueRange.h"             // from @llvm-project
 #include "mlir/include/mlir/IR/Visitors.h"               // from @llvm-project
@@ -76,6 +84,33 @@ RankedTensorType convertPolynomialType(PolynomialType type) {
   return RankedTensorType::get({degree}, attr.getCoefficientType());
 }
 
+/// Converts an RNS type whose limbs are polynomials in the same ring with
+/// mod_arith coefficients of the same storage type to a tensor of the storage
+/// integers, with the limbs as the outer dimension. The limbs have different
+/// coefficient moduli, so they cannot share a tensor of mod_arith elements.
+std::optional<Type> convertRNSType(rns::RNSType type) {
+  ArrayRef<Type> basisTypes = type.getBasisTypes();
+  if (basisTypes.empty()) return std::nullopt;
+  auto firstLimbType = dyn_cast<PolynomialType>(basisTypes.front());
+  if (!firstLimbType) return std::nullopt;
+  auto firstCoeffType =
+      dyn_cast<ModArithType>(firstLimbType.getRing().getCoefficientType());
+  if (!firstCoeffType) return std::nullopt;
+
+  Type storageType = firstCoeffType.getModulus().getType();
+  for (Type basisType : basisTypes) {
+    auto limbType = dyn_cast<PolynomialType>(basisType);
+    if (!limbType) return std::nullopt;
+    auto coeffType =
+        dyn_cast<ModArithType>(limbType.getRing().getCoefficientType());
+    if (!coeffType || coeffType.getModulus().getType() != storageType)
+      return std::nullopt;
+  }
+  int64_t degree = convertPolynomialType(firstLimbType).getShape()[0];
+  return RankedTensorType::get(
+      {static_cast<int64_t>(basisTypes.size()), degree}, storageType);
+}
+
 struct CommonConversionInfo {
   PolynomialType polynomialType;
   RingAttr ringAttr;
@@ -206,6 +241,9 @@ class PolynomialToModArithTypeConverter : public TypeConverter {
     addConversion([](PolynomialType type) -> Type {
       return convertPolynomialType(type);
     });
+    addConversion([](rns::RNSType type) -> std::optional<Type> {
+      return convertRNSType(type);
+    });
 
     // We don't include any custom materialization ops because this lowering is
     // all done in a single pass. The dialect conversion framework works by
@@ -217,6 +255,295 @@ class PolynomialToModArithTypeConverter : public TypeConverter {
   }
 };
 
+/// Returns the coefficient types of the limbs of an RNS type accepted by
+/// convertRNSType.
+SmallVector<ModArithType> getLimbCoefficientTypes(rns::RNSType type) {
+  return llvm::map_to_vector(type.getBasisTypes(), [](Type basisType) {
+    return cast<ModArithType>(
+        cast<PolynomialType>(basisType).getRing().getCoefficientType());
+  });
+}
+
+/// Returns the i-th row of a tensor of limbs as a tensor of `limbType`.
+Value extractLimb(ImplicitLocOpBuilder &b, Value limbs, int64_t i,
+                  ModArithType limbType) {
+  auto limbsType = cast<RankedTensorType>(limbs.getType());
+  int64_t degree = limbsType.getShape()[1];
+  SmallVector<OpFoldResult> offsets = {b.getIndexAttr(i), b.getIndexAttr(0)};
+  SmallVector<OpFoldResult> sizes = {b.getIndexAttr(1),
+                                     b.getIndexAttr(degree)};
+  SmallVector<OpFoldResult> strides = {b.getIndexAttr(1), b.getIndexAttr(1)};
+  auto storage = b.create<tensor::ExtractSliceOp>(
+      RankedTensorType::get({degree}, limbsType.getElementType()), limbs,
+      offsets, sizes, strides);
+  return b.create<mod_arith::EncapsulateOp>(
+      RankedTensorType::get({degree}, limbType), storage);
+}
+
+/// Stores a tensor of mod_arith values in the i-th row of a tensor of limbs.
+Value insertLimb(ImplicitLocOpBuilder &b, Value limb, Value limbs, int64_t i) {
+  auto limbsType = cast<RankedTensorType>(limbs.getType());
+  int64_t degree = limbsType.getShape()[1];
+  auto storage = b.create<mod_arith::ExtractOp>(
+      RankedTensorType::get({degree}, limbsType.getElementType()), limb);
+  SmallVector<OpFoldResult> offsets = {b.getIndexAttr(i), b.getIndexAttr(0)};
+  SmallVector<OpFoldResult> sizes = {b.getIndexAttr(1),
+                                     b.getIndexAttr(degree)};
+  SmallVector<OpFoldResult> strides = {b.getIndexAttr(1), b.getIndexAttr(1)};
+  return b.create<tensor::InsertSliceOp>(storage, limbs, offsets, sizes,
+                                         strides);
+}
+
+/// Returns a splat tensor of `type`, a tensor of mod_arith values, holding
+/// `value`.
+Value getLimbConstant(ImplicitLocOpBuilder &b, RankedTensorType type,
+                      const APInt &value) {
+  auto modArithType = cast<ModArithType>(type.getElementType());
+  auto storageType = cast<IntegerType>(modArithType.getModulus().getType());
+  auto storage = b.create<arith::ConstantOp>(DenseElementsAttr::get(
+      type.clone(storageType), value.zextOrTrunc(storageType.getWidth())));
+  return b.create<mod_arith::EncapsulateOp>(type, storage);
+}
+
+/// Reduces a tensor of storage integers modulo the modulus of `limbType`.
+Value reduceToLimb(ImplicitLocOpBuilder &b, Value storage,
+                   ModArithType limbType) {
+  auto storageType = cast<RankedTensorType>(storage.getType());
+  APInt modulus = limbType.getModulus().getValue().zextOrTrunc(
+      storageType.getElementTypeBitWidth());
+  auto modulusTensor = b.create<arith::ConstantOp>(
+      DenseElementsAttr::get(storageType, modulus));
+  return b.create<mod_arith::EncapsulateOp>(
+      storageType.clone(limbType),
+      b.create<arith::RemUIOp>(storage, modulusTensor));
+}
+
+// Stores the coefficients of each limb in a row of the limb tensor.
+struct ConvertPack : public OpConversionPattern<rns::PackOp> {
+  ConvertPack(mlir::MLIRContext *context)
+      : OpConversionPattern<rns::PackOp>(context) {}
+
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult matchAndRewrite(
+      rns::PackOp op, OpAdaptor adaptor,
+      ConversionPatternRewriter &rewriter) const override {
+    auto resultType = dyn_cast_or_null<RankedTensorType>(
+        typeConverter->convertType(op.getType()));
+    if (!resultType) return failure();
+
+    ImplicitLocOpBuilder b(op.getLoc(), rewriter);
+    Value result = b.create<tensor::EmptyOp>(resultType.getShape(),
+                                             resultType.getElementType());
+    for (auto [i, limb] : llvm::enumerate(adaptor.getLimbs()))
+      result = insertLimb(b, limb, result, i);
+    rewriter.replaceOp(op, result);
+    return success();
+  }
+};
+
+// Reads each limb from a row of the limb tensor.
+struct ConvertUnpack : public OpConversionPattern<rns::UnpackOp> {
+  ConvertUnpack(mlir::MLIRContext *context)
+      : OpConversionPattern<rns::UnpackOp>(context) {}
+
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult matchAndRewrite(
+      rns::UnpackOp op, OpAdaptor adaptor,
+      ConversionPatternRewriter &rewriter) const override {
+    if (!isa<RankedTensorType>(adaptor.getInput().getType())) return failure();
+
+    ImplicitLocOpBuilder b(op.getLoc(), rewriter);
+    SmallVector<Value> limbs;
+    for (auto [i, limbType] :
+         llvm::enumerate(getLimbCoefficientTypes(op.getInput().getType())))
+      limbs.push_back(extractLimb(b, adaptor.getInput(), i, limbType));
+    rewriter.replaceOp(op, limbs);
+    return success();
+  }
+};
+
+// Fast base conversion: the residue modulo each new modulus p is
+//
+//   sum_i [x_i * (Q/q_i)^{-1}]_{q_i} * (Q/q_i) mod p,
+//
+// with the constants (Q/q_i)^{-1} mod q_i and Q/q_i mod p precomputed.
+struct ConvertExtendBasis : public OpConversionPattern<rns::ExtendBasisOp> {
+  ConvertExtendBasis(mlir::MLIRContext *context)
+      : OpConversionPattern<rns::ExtendBasisOp>(context) {}
+
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult matchAndRewrite(
+      rns::ExtendBasisOp op, OpAdaptor adaptor,
+      ConversionPatternRewriter &rewriter) const override {
+    Value input = adaptor.getInput();
+    auto inputType = dyn_cast<RankedTensorType>(input.getType());
+    auto resultType = dyn_cast_or_null<RankedTensorType>(
+        typeConverter->convertType(op.getType()));
+    if (!inputType || !resultType) return failure();
+
+    SmallVector<ModArithType> inputLimbTypes =
+        getLimbCoefficientTypes(op.getInput().getType());
+    SmallVector<ModArithType> resultLimbTypes =
+        getLimbCoefficientTypes(op.getOutput().getType());
+    unsigned width = inputType.getElementTypeBitWidth();
+    int64_t degree = inputType.getShape()[1];
+
+    // The product of the input moduli, wide enough to never overflow.
+    unsigned productWidth = 1;
+    for (ModArithType limbType : inputLimbTypes)
+      productWidth += limbType.getModulus().getValue().getActiveBits();
+    productWidth = std::max(productWidth, width);
+    APInt product(productWidth, 1);
+    for (ModArithType limbType : inputLimbTypes)
+      product *= limbType.getModulus().getValue().zextOrTrunc(productWidth);
+
+    ImplicitLocOpBuilder b(op.getLoc(), rewriter);
+    // The residues modulo the input moduli are kept as they are.
+    SmallVector<OpFoldResult> offsets = {b.getIndexAttr(0), b.getIndexAttr(0)};
+    SmallVector<OpFoldResult> sizes = {
+        b.getIndexAttr(inputLimbTypes.size()), b.getIndexAttr(degree)};
+    SmallVector<OpFoldResult> strides = {b.getIndexAttr(1), b.getIndexAttr(1)};
+    Value result = b.create<tensor::InsertSliceOp>(
+        input,
+        b.create<tensor::EmptyOp>(resultType.getShape(),
+                                  resultType.getElementType()),
+        offsets, sizes, strides);
+
+    SmallVector<APInt> cofactors;
+    SmallVector<Value> scaledResidues;
+    for (auto [i, limbType] : llvm::enumerate(inputLimbTypes)) {
+      APInt modulus = limbType.getModulus().getValue().zextOrTrunc(width);
+      APInt cofactor = product.udiv(modulus.zext(productWidth));
+      APInt cofactorInverse = multiplicativeInverse(
+          cofactor.urem(modulus.zext(productWidth)).zextOrTrunc(width),
+          modulus);
+      auto limbTensorType = RankedTensorType::get({degree}, limbType);
+      Value scaled = b.create<mod_arith::MulOp>(
+          extractLimb(b, input, i, limbType),
+          getLimbConstant(b, limbTensorType, cofactorInverse));
+      cofactors.push_back(cofactor);
+      scaledResidues.push_back(b.create<mod_arith::ExtractOp>(
+          RankedTensorType::get({degree}, inputType.getElementType()),
+          scaled));
+    }
+
+    for (int64_t j = inputLimbTypes.size(); j < resultLimbTypes.size(); ++j) {
+      ModArithType limbType = resultLimbTypes[j];
+      auto limbTensorType = RankedTensorType::get({degree}, limbType);
+      APInt modulus =
+          limbType.getModulus().getValue().zextOrTrunc(productWidth);
+      Value sum;
+      for (auto [cofactor, scaled] : llvm::zip(cofactors, scaledResidues)) {
+        Value term = b.create<mod_arith::MulOp>(
+            reduceToLimb(b, scaled, limbType),
+            getLimbConstant(b, limbTensorType, cofactor.urem(modulus)));
+        sum = sum ? b.create<mod_arith::AddOp>(sum, term) : term;
+      }
+      result = insertLimb(b, sum, result, j);
+    }
+    rewriter.replaceOp(op, result);
+    return success();
+  }
+};
+
+// Divides by the last modulus q_k, computing each remaining residue as
+//
+//   (x_i - t * [x_k * t^{-1}]_{q_k}) * q_k^{-1} mod q_i,
+//
+// where [.]_{q_k} is the centered representative and t = 1 unless a plaintext
+// modulus is given.
+struct ConvertRescale : public OpConversionPattern<rns::RescaleOp> {
+  ConvertRescale(mlir::MLIRContext *context)
+      : OpConversionPattern<rns::RescaleOp>(context) {}
+
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult matchAndRewrite(
+      rns::RescaleOp op, OpAdaptor adaptor,
+      ConversionPatternRewriter &rewriter) const override {
+    Value input = adaptor.getInput();
+    auto inputType = dyn_cast<RankedTensorType>(input.getType());
+    auto resultType = dyn_cast_or_null<RankedTensorType>(
+        typeConverter->convertType(op.getType()));
+    if (!inputType || !resultType) return failure();
+
+    SmallVector<ModArithType> limbTypes =
+        getLimbCoefficientTypes(op.getInput().getType());
+    ModArithType lastLimbType = limbTypes.pop_back_val();
+    unsigned width = inputType.getElementTypeBitWidth();
+    int64_t degree = inputType.getShape()[1];
+    auto storageTensorType =
+        RankedTensorType::get({degree}, inputType.getElementType());
+    APInt lastModulus = lastLimbType.getModulus().getValue().zextOrTrunc(width);
+
+    std::optional<APInt> plaintextModulus;
+    if (op.getPlaintextModulus().has_value())
+      plaintextModulus = APInt(64, *op.getPlaintextModulus());
+
+    ImplicitLocOpBuilder b(op.getLoc(), rewriter);
+    Value lastLimb = extractLimb(b, input, limbTypes.size(), lastLimbType);
+    if (plaintextModulus.has_value()) {
+      APInt plaintextInverse = multiplicativeInverse(
+          plaintextModulus->urem(lastModulus.zextOrTrunc(64))
+              .zextOrTrunc(width),
+          lastModulus);
+      if (plaintextInverse.isZero()) {
+        return op.emitOpError()
+               << "expected the plaintext modulus to be invertible modulo "
+               << lastModulus;
+      }
+      lastLimb = b.create<mod_arith::MulOp>(
+          lastLimb,
+          getLimbConstant(b, RankedTensorType::get({degree}, lastLimbType),
+                          plaintextInverse));
+    }
+    Value last = b.create<mod_arith::ExtractOp>(storageTensorType, lastLimb);
+    // Residues above q_k / 2 represent negative values.
+    auto half = b.create<arith::ConstantOp>(
+        DenseElementsAttr::get(storageTensorType, lastModulus.lshr(1)));
+    auto isNegative =
+        b.create<arith::CmpIOp>(arith::CmpIPredicate::ugt, last, half);
+
+    Value result = b.create<tensor::EmptyOp>(resultType.getShape(),
+                                             resultType.getElementType());
+    for (auto [i, limbType] : llvm::enumerate(limbTypes)) {
+      APInt modulus = limbType.getModulus().getValue().zextOrTrunc(width);
+      auto limbTensorType = RankedTensorType::get({degree}, limbType);
+      Value correction = reduceToLimb(b, last, limbType);
+      Value negativeCorrection = b.create<mod_arith::SubOp>(
+          correction,
+          getLimbConstant(b, limbTensorType, lastModulus.urem(modulus)));
+      correction = b.create<mod_arith::EncapsulateOp>(
+          limbTensorType,
+          b.create<arith::SelectOp>(
+              isNegative,
+              b.create<mod_arith::ExtractOp>(storageTensorType,
+                                             negativeCorrection),
+              b.create<mod_arith::ExtractOp>(storageTensorType, correction)));
+      if (plaintextModulus.has_value()) {
+        correction = b.create<mod_arith::MulOp>(
+            correction,
+            getLimbConstant(
+                b, limbTensorType,
+                plaintextModulus->urem(modulus.zextOrTrunc(64))));
+      }
+      Value difference = b.create<mod_arith::SubOp>(
+          extractLimb(b, input, i, limbType), correction);
+      Value rescaled = b.create<mod_arith::MulOp>(
+          difference,
+          getLimbConstant(
+              b, limbTensorType,
+              multiplicativeInverse(lastModulus.urem(modulus), modulus)));
+      result = insertLimb(b, rescaled, result, i);
+    }
+    rewriter.replaceOp(op, result);
+    return success();
+  }
+};
+
 struct ConvertFromTensor : public OpConversionPattern<FromTensorOp> {
   ConvertFromTensor(mlir::MLIRContext *context)
       : OpConversionPattern<FromTensorOp>(context) {}
@@ -421,19 +748,34 @@ struct ConvertMulScalar : public OpConversionPattern<MulScalarOp> {
   }
 };
 
+/// Returns true if and only if the polynomial modulus of the ring is of the
+/// form x^n + c for some n, with c = 1 or c = -1 given by `constantCoeff`.
+static bool hasBinomialModulus(RingAttr ring, int64_t constantCoeff) {
+  if (!ring.getPolynomialModulus()) return false;
+  IntPolynomial ideal = ring.getPolynomialModulus().getPolynomial();
+  auto idealTerms = ideal.getTerms();
+  if (idealTerms.size() != 2) return false;
+  APInt lowCoeff = idealTerms[0].getCoefficient();
+  return lowCoeff == APInt(lowCoeff.getBitWidth(), constantCoeff,
+                           /*isSigned=*/true) &&
+         idealTerms[0].getExponent().isZero() &&
+         idealTerms[1].getCoefficient().isOne();
+}
+
 /// Returns true if and only if the polynomial modulus of the ring for this op
 /// is of the form x^n - 1 for some n. This is "cyclic" in the sense that
 /// multiplication by a monomial corresponds to a cyclic shift of the
 /// coefficients.
 bool hasCyclicModulus(MonicMonomialMulOp op) {
   auto ring = cast<PolynomialType>(op.getInput().getType()).getRing();
-  IntPolynomial ideal = ring.getPolynomialModulus().getPolynomial();
-  auto idealTerms = ideal.getTerms();
-  APInt constantCoeff = idealTerms[0].getCoefficient();
-  return idealTerms.size() == 2 &&
-         (constantCoeff == APInt(constantCoeff.getBitWidth(), -1) &&
-          idealTerms[0].getExponent().isZero()) &&
-         (idealTerms[1].getCoefficient().isOne());
+  return hasBinomialModulus(ring, -1);
+}
+
+/// Returns true if products in the ring can be reduced by folding the upper
+/// half of the coefficients onto the lower half, i.e., if the polynomial
+/// modulus is x^n - 1 or x^n + 1.
+static bool hasFoldableModulus(RingAttr ring) {
+  return hasBinomialModulus(ring, -1) || hasBinomialModulus(ring, 1);
 }
 
 // Implement rotation via tensor.insert_slice
@@ -622,13 +964,156 @@ RankedTensorType polymulOutputTensorType(PolynomialType type) {
                                type.getRing().getCoefficientType());
 }
 
+// Returns a tensor of zeros of the given tensor of mod_arith type.
+static Value zeroTensor(ImplicitLocOpBuilder &b, RankedTensorType tensorType) {
+  auto coeffType = cast<ModArithType>(tensorType.getElementType());
+  auto intStorageType = coeffType.getModulus().getType();
+  auto storageTensorType =
+      RankedTensorType::get(tensorType.getShape(), intStorageType);
+  auto tensor = b.create<arith::ConstantOp>(DenseElementsAttr::get(
+      storageTensorType, b.getIntegerAttr(intStorageType, 0)));
+  return b.create<mod_arith::EncapsulateOp>(tensorType, tensor);
+}
+
+// Implementing a naive polymul operation which is a loop
+//
+// for i = 0, ..., N-1
+//   for j = 0, ..., N-1
+//     c[i+j] += a[i] * b[j]
+//
+// The result has 2N - 1 coefficients and is not reduced modulo any ideal.
+static Value naivePolymul(ImplicitLocOpBuilder &b, Value lhs, Value rhs) {
+  auto inputType = cast<RankedTensorType>(lhs.getType());
+  auto polymulTensorType = RankedTensorType::get(
+      {2 * inputType.getShape()[0] - 1}, inputType.getElementType());
+
+  SmallVector<utils::IteratorType> iteratorTypes(2,
+                                                 utils::IteratorType::parallel);
+  AffineExpr d0, d1;
+  bindDims(b.getContext(), d0, d1);
+  SmallVector<AffineMap> indexingMaps = {
+      AffineMap::get(2, 0, {d0}),      // i
+      AffineMap::get(2, 0, {d1}),      // j
+      AffineMap::get(2, 0, {d0 + d1})  // i+j
+  };
+
+  // The tensor of zeros in which to store the naive polymul output from the
+  // linalg.generic op below.
+  Value polymulOutput = zeroTensor(b, polymulTensorType);
+
+  auto polyMul = b.create<linalg::GenericOp>(
+      /*resultTypes=*/polymulTensorType,
+      /*inputs=*/ValueRange{lhs, rhs},
+      /*outputs=*/polymulOutput,
+      /*indexingMaps=*/indexingMaps,
+      /*iteratorTypes=*/iteratorTypes,
+      /*bodyBuilder=*/
+      [&](OpBuilder &nestedBuilder, Location nestedLoc, ValueRange args) {
+        ImplicitLocOpBuilder b(nestedLoc, nestedBuilder);
+        auto lhs = args[0];
+        auto rhs = args[1];
+        auto accum = args[2];
+        auto macOp = b.create<mod_arith::MacOp>(lhs, rhs, accum);
+        b.create<linalg::YieldOp>(macOp.getResult());
+      });
+  return polyMul.getResult(0);
+}
+
+// Multiply two polynomials in a ring with polynomial modulus x^n - 1 or
+// x^n + 1 by a single kernel that accumulates directly into the n
+// coefficients of the result, i.e.,
+//
+// for k = 0, ..., N-1
+//   for i = 0, ..., N-1
+//     c[k] += a[i] * s(k - i) * b[(k - i) mod N]
+//
+// where s(k - i) = -1 if k < i and the modulus is x^n + 1, and 1 otherwise.
+// The sign flips are folded into the rhs operand by extending it to
+// [s * b, b] with s = -1 for x^n + 1 and s = 1 for x^n - 1, so that the
+// coefficient multiplied with a[i] is found at index k - i + N.
+static Value foldedPolymul(ImplicitLocOpBuilder &b, RingAttr ring,
+                           RankedTensorType tensorType, ModArithType coeffType,
+                           Value lhs, Value rhs) {
+  int64_t n = tensorType.getShape()[0];
+  Value lowerHalf = rhs;
+  if (hasBinomialModulus(ring, 1))
+    lowerHalf = b.create<mod_arith::SubOp>(zeroTensor(b, tensorType), rhs);
+  auto extendedType = RankedTensorType::get({2 * n}, coeffType);
+  Value extended = b.create<tensor::EmptyOp>(extendedType.getShape(),
+                                             extendedType.getElementType());
+  SmallVector<OpFoldResult> lowerOffsets = {b.getIndexAttr(0)};
+  SmallVector<OpFoldResult> upperOffsets = {b.getIndexAttr(n)};
+  SmallVector<OpFoldResult> sizes = {b.getIndexAttr(n)};
+  SmallVector<OpFoldResult> strides = {b.getIndexAttr(1)};
+  extended = b.create<tensor::InsertSliceOp>(lowerHalf, extended, lowerOffsets,
+                                             sizes, strides);
+  extended = b.create<tensor::InsertSliceOp>(rhs, extended, upperOffsets,
+                                             sizes, strides);
+
+  SmallVector<utils::IteratorType> iteratorTypes = {
+      utils::IteratorType::parallel, utils::IteratorType::reduction};
+  AffineExpr d0, d1;
+  bindDims(b.getContext(), d0, d1);
+  SmallVector<AffineMap> indexingMaps = {
+      AffineMap::get(2, 0, {d1}),           // i
+      AffineMap::get(2, 0, {d0 - d1 + n}),  // k - i + N
+      AffineMap::get(2, 0, {d0})            // k
+  };
+
+  auto polyMul = b.create<linalg::GenericOp>(
+      /*resultTypes=*/tensorType,
+      /*inputs=*/ValueRange{lhs, extended},
+      /*outputs=*/zeroTensor(b, tensorType),
+      /*indexingMaps=*/indexingMaps,
+      /*iteratorTypes=*/iteratorTypes,
+      /*bodyBuilder=*/
+      [&](OpBuilder &nestedBuilder, Location nestedLoc, ValueRange args) {
+        ImplicitLocOpBuilder b(nestedLoc, nestedBuilder);
+        auto macOp = b.create<mod_arith::MacOp>(args[0], args[1], args[2]);
+        b.create<linalg::YieldOp>(macOp.getResult());
+      });
+  return polyMul.getResult(0);
+}
+
+// Reduce a product with 2N - 1 coefficients modulo x^N - 1 or x^N + 1 by
+// adding, respectively subtracting, the upper N - 1 coefficients to the lower
+// N coefficients.
+static Value foldProduct(ImplicitLocOpBuilder &b, RingAttr ring,
+                         RankedTensorType tensorType, Value product) {
+  int64_t n = tensorType.getShape()[0];
+  SmallVector<OpFoldResult> strides = {b.getIndexAttr(1)};
+  Value lower = b.create<tensor::ExtractSliceOp>(
+      tensorType, product, SmallVector<OpFoldResult>{b.getIndexAttr(0)},
+      SmallVector<OpFoldResult>{b.getIndexAttr(n)}, strides);
+  auto upperType =
+      RankedTensorType::get({n - 1}, tensorType.getElementType());
+  SmallVector<OpFoldResult> upperSizes = {b.getIndexAttr(n - 1)};
+  Value upper = b.create<tensor::ExtractSliceOp>(
+      upperType, product, SmallVector<OpFoldResult>{b.getIndexAttr(n)},
+      upperSizes, strides);
+  Value paddedUpper = b.create<tensor::InsertSliceOp>(
+      upper, zeroTensor(b, tensorType),
+      SmallVector<OpFoldResult>{b.getIndexAttr(0)}, upperSizes, strides);
+  if (hasBinomialModulus(ring, 1))
+    return b.create<mod_arith::SubOp>(lower, paddedUpper);
+  return b.create<mod_arith::AddOp>(lower, paddedUpper);
+}
+
+// Callback type for getting the pre-generated FuncOp computing the unreduced
+// product of two polynomials with Karatsuba's method, if any.
+using GetKaratsubaCallbackTy = function_ref<func::FuncOp(FunctionType)>;
+
 // Lower polynomial multiplication to a 1D convolution, followed by with a
-// modulus reduction in the ring.
+// modulus reduction in the ring. Rings with polynomial modulus x^n - 1 or
+// x^n + 1 use a fused kernel instead, which needs no reduction. If a
+// Karatsuba implementation was generated for the operand type, it replaces
+// the convolution.
 struct ConvertMul : public OpConversionPattern<MulOp> {
   ConvertMul(const TypeConverter &typeConverter, mlir::MLIRContext *context,
-             GetFuncCallbackTy cb)
+             GetFuncCallbackTy cb, GetKaratsubaCallbackTy karatsubaCb)
       : OpConversionPattern<MulOp>(typeConverter, context),
-        getFuncOpCallback(cb) {}
+        getFuncOpCallback(cb),
+        getKaratsubaCallback(karatsubaCb) {}
 
   using OpConversionPattern::OpConversionPattern;
 
@@ -645,51 +1130,30 @@ struct ConvertMul : public OpConversionPattern<MulOp> {
     }
 
     ImplicitLocOpBuilder b(op.getLoc(), rewriter);
-    // Implementing a naive polymul operation which is a loop
-    //
-    // for i = 0, ..., N-1
-    //   for j = 0, ..., N-1
-    //     c[i+j] += a[i] * b[j]
-    //
     RankedTensorType polymulTensorType =
         polymulOutputTensorType(typeInfo.polynomialType);
+    FunctionType karatsubaType = FunctionType::get(
+        op.getContext(), {typeInfo.tensorType, typeInfo.tensorType},
+        {polymulTensorType});
+    func::FuncOp karatsuba = getKaratsubaCallback(karatsubaType);
+    bool foldable = hasFoldableModulus(typeInfo.ringAttr);
+
+    if (foldable && !karatsuba) {
+      rewriter.replaceOp(
+          op, foldedPolymul(b, typeInfo.ringAttr, typeInfo.tensorType,
+                            coeffType, adaptor.getLhs(), adaptor.getRhs()));
+      return success();
+    }
 
-    SmallVector<utils::IteratorType> iteratorTypes(
-        2, utils::IteratorType::parallel);
-    AffineExpr d0, d1;
-    bindDims(getContext(), d0, d1);
-    SmallVector<AffineMap> indexingMaps = {
-        AffineMap::get(2, 0, {d0}),      // i
-        AffineMap::get(2, 0, {d1}),      // j
-        AffineMap::get(2, 0, {d0 + d1})  // i+j
-    };
-
-    auto intStorageType = coeffType.getModulus().getType();
-    auto storageTensorType =
-        RankedTensorType::get(polymulTensorType.getShape(), intStorageType);
-    auto tensor = b.create<arith::ConstantOp>(DenseElementsAttr::get(
-        storageTensorType, b.getIntegerAttr(intStorageType, 0)));
-    // The tensor of zeros in which to store the naive polymul output from the
-    // linalg.generic op below.
-    auto polymulOutput =
-        b.create<mod_arith::EncapsulateOp>(polymulTensorType, tensor);
-
-    auto polyMul = b.create<linalg::GenericOp>(
-        /*resultTypes=*/polymulTensorType,
-        /*inputs=*/adaptor.getOperands(),
-        /*outputs=*/polymulOutput.getResult(),
-        /*indexingMaps=*/indexingMaps,
-        /*iteratorTypes=*/iteratorTypes,
-        /*bodyBuilder=*/
-        [&](OpBuilder &nestedBuilder, Location nestedLoc, ValueRange args) {
-          ImplicitLocOpBuilder b(nestedLoc, nestedBuilder);
-          auto lhs = args[0];
-          auto rhs = args[1];
-          auto accum = args[2];
-          auto mulOp = b.create<mod_arith::MulOp>(lhs, rhs);
-          auto addOp = b.create<mod_arith::AddOp>(mulOp, accum);
-          b.create<linalg::YieldOp>(addOp.getResult());
-        });
+    Value polyMul =
+        karatsuba ? b.create<func::CallOp>(karatsuba, adaptor.getOperands())
+                        .getResult(0)
+                  : naivePolymul(b, adaptor.getLhs(), adaptor.getRhs());
+    if (foldable) {
+      rewriter.replaceOp(op, foldProduct(b, typeInfo.ringAttr,
+                                         typeInfo.tensorType, polyMul));
+      return success();
+    }
 
     auto postReductionType = convertPolynomialType(typeInfo.polynomialType);
     FunctionType funcType = FunctionType::get(
@@ -704,12 +1168,13 @@ struct ConvertMul : public OpConversionPattern<MulOp> {
       });
     }
 
-    rewriter.replaceOpWithNewOp<func::CallOp>(op, divMod, polyMul.getResult(0));
+    rewriter.replaceOpWithNewOp<func::CallOp>(op, divMod, polyMul);
     return success();
   }
 
  private:
   GetFuncCallbackTy getFuncOpCallback;
+  GetKaratsubaCallbackTy getKaratsubaCallback;
 };
 
 struct PolynomialToModArith
@@ -724,11 +1189,22 @@ struct PolynomialToModArith
 
   func::FuncOp buildPolynomialModFunc(FunctionType funcType, RingAttr ringAttr);
 
+  func::FuncOp getOrBuildKaratsubaFunc(RankedTensorType inputType);
+
+  // Move the tables of roots of unity of the NTT lowerings to one
+  // memref.global per distinct table if `pool-twiddles` is set, and otherwise
+  // keep them as constants.
+  void poolNTTTables();
+
   // A map containing modular reduction function implementations, generated once
   // at the beginning of this pass based on the ops to be converted, intended to
   // be retrieved by ConvertMul to construct CallOps so that later optimization
   // passes can determine when to inline the implementation.
   DenseMap<std::pair<Type, RingAttr>, func::FuncOp> modImpls;
+
+  // Karatsuba multiplication implementations, keyed by their function type and
+  // generated alongside modImpls.
+  DenseMap<Type, func::FuncOp> karatsubaImpls;
 };
 
 void PolynomialToModArith::generateOpImplementations() {
@@ -741,6 +1217,15 @@ void PolynomialToModArith::generateOpImplementations() {
              "convert-elementwise-to-affine pass before lowering polynomial.";
       return WalkResult::interrupt();
     }
+    auto tensorType = convertPolynomialType(polyTy);
+    if (karatsubaThreshold > 0 &&
+        tensorType.getShape()[0] > karatsubaThreshold &&
+        isa<ModArithType>(tensorType.getElementType()))
+      getOrBuildKaratsubaFunc(tensorType);
+
+    // ConvertMul reduces products in these rings without a helper function.
+    if (hasFoldableModulus(polyTy.getRing())) return WalkResult::advance();
+
     auto convType = polymulOutputTensorType(polyTy);
     auto postReductionType = convertPolynomialType(polyTy);
     FunctionType funcType =
@@ -757,6 +1242,122 @@ void PolynomialToModArith::generateOpImplementations() {
   });
 }
 
+// Returns a string identifying the coefficient type in helper function names.
+static std::string getCoefficientTypeId(Type coeffTy) {
+  std::string coeffTyId;
+  if (auto intTy = dyn_cast<IntegerType>(coeffTy)) {
+    coeffTyId = llvm::formatv("i{0}", intTy.getWidth());
+  } else if (auto modTy = dyn_cast<ModArithType>(coeffTy)) {
+    IntegerType intTy = cast<IntegerType>(modTy.getModulus().getType());
+    SmallString<10> modulusStr;
+    modTy.getModulus().getValue().toStringUnsigned(modulusStr);
+    coeffTyId =
+        llvm::formatv("{0}_i{1}", modulusStr, intTy.getIntOrFloatBitWidth());
+  }
+  return coeffTyId;
+}
+
+// Create a software implementation of the unreduced product of two polynomials
+// with n coefficients using Karatsuba's method. Each operand is split into a
+// low half of m = ceil(n/2) coefficients and a high half zero-padded to m
+// coefficients, a = a0 + x^m a1, so that
+//
+//   a * b = z0 + x^m (z1 - z0 - z2) + x^2m z2
+//
+// with z0 = a0 * b0, z1 = (a0 + a1) * (b0 + b1) and z2 = a1 * b1. The three
+// half-size products call the implementation for m coefficients, which uses
+// the naive convolution once m is at most karatsubaThreshold.
+func::FuncOp PolynomialToModArith::getOrBuildKaratsubaFunc(
+    RankedTensorType inputType) {
+  int64_t n = inputType.getShape()[0];
+  Type coeffTy = inputType.getElementType();
+  auto outputType = RankedTensorType::get({2 * n - 1}, coeffTy);
+  FunctionType funcType = FunctionType::get(
+      &getContext(), {inputType, inputType}, {outputType});
+  auto it = karatsubaImpls.find(funcType);
+  if (it != karatsubaImpls.end()) return it->second;
+
+  ModuleOp module = getOperation();
+  ImplicitLocOpBuilder builder =
+      ImplicitLocOpBuilder::atBlockEnd(module->getLoc(), module.getBody());
+  std::string funcName = llvm::formatv("__heir_poly_karatsuba_{0}_{1}",
+                                       getCoefficientTypeId(coeffTy), n);
+  auto funcOp = builder.create<func::FuncOp>(funcName, funcType);
+  LLVM::linkage::Linkage inlineLinkage = LLVM::linkage::Linkage::LinkonceODR;
+  Attribute linkage =
+      LLVM::LinkageAttr::get(builder.getContext(), inlineLinkage);
+  funcOp->setAttr("llvm.linkage", linkage);
+  funcOp.setPrivate();
+  karatsubaImpls.insert(std::pair(funcType, funcOp));
+
+  Block *funcBody = funcOp.addEntryBlock();
+  Value lhs = funcOp.getArgument(0);
+  Value rhs = funcOp.getArgument(1);
+  builder.setInsertionPointToStart(funcBody);
+
+  if (n <= karatsubaThreshold || n < 2) {
+    builder.create<func::ReturnOp>(naivePolymul(builder, lhs, rhs));
+    return funcOp;
+  }
+
+  int64_t m = (n + 1) / 2;
+  auto halfType = RankedTensorType::get({m}, coeffTy);
+  func::FuncOp halfMul = getOrBuildKaratsubaFunc(halfType);
+
+  SmallVector<OpFoldResult> strides = {builder.getIndexAttr(1)};
+  auto offset = [&](int64_t value) {
+    return SmallVector<OpFoldResult>{builder.getIndexAttr(value)};
+  };
+  auto size = offset;
+  auto split = [&](Value poly) -> std::pair<Value, Value> {
+    Value low = builder.create<tensor::ExtractSliceOp>(halfType, poly,
+                                                       offset(0), size(m),
+                                                       strides);
+    auto highType = RankedTensorType::get({n - m}, coeffTy);
+    Value high = builder.create<tensor::ExtractSliceOp>(
+        highType, poly, offset(m), size(n - m), strides);
+    if (n - m < m)
+      high = builder.create<tensor::InsertSliceOp>(
+          high, zeroTensor(builder, halfType), offset(0), size(n - m),
+          strides);
+    return {low, high};
+  };
+  auto [a0, a1] = split(lhs);
+  auto [b0, b1] = split(rhs);
+
+  Value z0 = builder.create<func::CallOp>(halfMul, ValueRange{a0, b0})
+                 .getResult(0);
+  Value z2 = builder.create<func::CallOp>(halfMul, ValueRange{a1, b1})
+                 .getResult(0);
+  Value z1 = builder
+                 .create<func::CallOp>(
+                     halfMul,
+                     ValueRange{builder.create<mod_arith::AddOp>(a0, a1),
+                                builder.create<mod_arith::AddOp>(b0, b1)})
+                 .getResult(0);
+  z1 = builder.create<mod_arith::SubOp>(z1, z0);
+  z1 = builder.create<mod_arith::SubOp>(z1, z2);
+
+  // z0 and z2 do not overlap, and for odd n the top two coefficients of the
+  // 4m - 1 accumulated coefficients are zero.
+  auto accType = RankedTensorType::get({4 * m - 1}, coeffTy);
+  Value acc = zeroTensor(builder, accType);
+  acc = builder.create<tensor::InsertSliceOp>(z0, acc, offset(0),
+                                              size(2 * m - 1), strides);
+  acc = builder.create<tensor::InsertSliceOp>(z2, acc, offset(2 * m),
+                                              size(2 * m - 1), strides);
+  Value middle = builder.create<tensor::ExtractSliceOp>(
+      z1.getType(), acc, offset(m), size(2 * m - 1), strides);
+  middle = builder.create<mod_arith::AddOp>(middle, z1);
+  acc = builder.create<tensor::InsertSliceOp>(middle, acc, offset(m),
+                                              size(2 * m - 1), strides);
+  if (4 * m - 1 != 2 * n - 1)
+    acc = builder.create<tensor::ExtractSliceOp>(outputType, acc, offset(0),
+                                                 size(2 * n - 1), strides);
+  builder.create<func::ReturnOp>(acc);
+  return funcOp;
+}
+
 // Create a software implementation that reduces a polynomial
 // modulo a statically known divisor polynomial.
 func::FuncOp PolynomialToModArith::buildPolynomialModFunc(FunctionType funcType,
@@ -780,19 +1381,9 @@ func::FuncOp PolynomialToModArith::buildPolynomialModFunc(FunctionType funcType,
   // TODO(#202): this function name probably also needs the input tensor type in
   // the name, or it could conflict with other implementations that have the
   // same cmod+ideal.
-  auto coeffTy = ring.getCoefficientType();
-  std::string coeffTyId;
-  if (auto intTy = dyn_cast<IntegerType>(coeffTy)) {
-    coeffTyId = llvm::formatv("i{0}", intTy.getWidth());
-  } else if (auto modTy = dyn_cast<ModArithType>(coeffTy)) {
-    IntegerType intTy = cast<IntegerType>(modTy.getModulus().getType());
-    SmallString<10> modulusStr;
-    modTy.getModulus().getValue().toStringUnsigned(modulusStr);
-    coeffTyId =
-        llvm::formatv("{0}_i{1}", modulusStr, intTy.getIntOrFloatBitWidth());
-  }
   std::string funcName =
-      llvm::formatv("__heir_poly_mod_{0}_{1}", coeffTyId,
+      llvm::formatv("__heir_poly_mod_{0}_{1}",
+                    getCoefficientTypeId(ring.getCoefficientType()),
                     ring.getPolynomialModulus().getPolynomial().toIdentifier());
 
   auto funcOp = builder.create<func::FuncOp>(funcName, funcType);
@@ -953,6 +1544,19 @@ static SmallVector<APInt> precomputeRoots(APInt root, const APInt &cmod,
   return vals;
 }
 
+// Marks the constant tables of roots of unity created by the NTT and INTT
+// lowerings, so that they can be moved to a shared pool of globals after the
+// conversion.
+static constexpr StringLiteral kNTTTableAttrName = "polynomial.ntt_table";
+
+static Value createNTTTable(ImplicitLocOpBuilder &b, RankedTensorType type,
+                            ArrayRef<APInt> values) {
+  auto table = b.create<arith::ConstantOp>(
+      type, DenseElementsAttr::get(type, values));
+  table->setAttr(kNTTTableAttrName, b.getUnitAttr());
+  return table;
+}
+
 static Value computeReverseBitOrder(ImplicitLocOpBuilder &b,
                                     RankedTensorType type, Value tensor) {
   unsigned degree = type.getShape()[0];
@@ -996,79 +1600,146 @@ static Value computeReverseBitOrder(ImplicitLocOpBuilder &b,
   return shuffleOp.getResult(0);
 }
 
+// Options controlling the arithmetic emitted by the NTT and INTT lowerings.
+struct NTTLoweringOptions {
+  // Multiply by the roots of unity using precomputed Shoup companions, and
+  // reduce sums and differences with conditional subtractions.
+  bool shoupTwiddles = false;
+  // Keep coefficients at their storage width and only widen the products.
+  bool nativeWidth = false;
+  // Compute each stage with one elementwise op over strided blocks of
+  // coefficients instead of a loop nest over single butterflies.
+  bool vectorizeStages = false;
+};
+
+// Compute floor(x * 2^width / cmod), the Shoup companion of x, as an integer
+// of the given width. Requires x < cmod.
+static APInt shoupCompanion(const APInt &x, const APInt &cmod,
+                            unsigned width) {
+  APInt wideX = x.zextOrTrunc(2 * width).shl(width);
+  return wideX.udiv(cmod.zextOrTrunc(2 * width)).trunc(width);
+}
+
+// Compute x * root % cmod given the Shoup companion of root, for x < 2^w and
+// root < cmod, where w is the width the companion was computed for. The
+// quotient estimate floor(x * rootShoup / 2^w) is off by at most one, so a
+// single conditional subtraction replaces the division by cmod.
+//
+// If nativeWidth is set, all values have width w and the quotient estimate is
+// the high half of the extended product. The low halves of the remaining
+// products wrap around, but their difference is the remainder in [0, 2 * cmod)
+// which fits in w bits. Otherwise, all values have width 2w and the quotient
+// is shifted down by `shift` = w.
+static Value mulModShoup(ImplicitLocOpBuilder &b, Value x, Value root,
+                         Value rootShoup, Value cMod, Value shift,
+                         bool nativeWidth) {
+  Value quotient;
+  if (nativeWidth) {
+    quotient = b.create<arith::MulUIExtendedOp>(x, rootShoup).getHigh();
+  } else {
+    auto quotientTimesShift = b.create<arith::MulIOp>(x, rootShoup);
+    quotient = b.create<arith::ShRUIOp>(quotientTimesShift, shift);
+  }
+  auto product = b.create<arith::MulIOp>(x, root);
+  auto quotientTimesMod = b.create<arith::MulIOp>(quotient, cMod);
+  // product - quotient * cmod -> [0, 2 * cmod)
+  auto remainder = b.create<arith::SubIOp>(product, quotientTimesMod);
+  return b.create<mod_arith::SubIfGEOp>(remainder, cMod);
+}
+
+// Compute x * root % cmod for x, root in [0, cmod). The Shoup companion and
+// shift are only used with Shoup twiddles.
+static Value mulModRoot(ImplicitLocOpBuilder &b, Value x, Value root,
+                        Value rootShoup, Value cMod, Value shift,
+                        const NTTLoweringOptions &options) {
+  if (options.shoupTwiddles) {
+    return mulModShoup(b, x, root, rootShoup, cMod, shift,
+                       options.nativeWidth);
+  }
+
+  if (options.nativeWidth) {
+    // Widen only for the product, since root * x -> [0, cmod^2)
+    auto type = cast<IntegerType>(x.getType());
+    auto wideType = IntegerType::get(b.getContext(), 2 * type.getWidth());
+    auto xExt = b.create<arith::ExtUIOp>(wideType, x);
+    auto rootExt = b.create<arith::ExtUIOp>(wideType, root);
+    auto cModExt = b.create<arith::ExtUIOp>(wideType, cMod);
+    auto rootX = b.create<arith::MulIOp>(xExt, rootExt);
+    auto rootXModded = b.create<arith::RemUIOp>(rootX, cModExt);
+    return b.create<arith::TruncIOp>(type, rootXModded);
+  }
+
+  // Since root * x -> [0, cmod^2) then RemUI will compute the modulus
+  auto rootX = b.create<arith::MulIOp>(x, root);
+  return b.create<arith::RemUIOp>(rootX, cMod);
+}
+
+// Reduce x in [0, 2 * cmod) modulo cmod.
+static Value reduceOnce(ImplicitLocOpBuilder &b, Value x, Value cMod,
+                        const NTTLoweringOptions &options) {
+  if (options.shoupTwiddles) return b.create<mod_arith::SubIfGEOp>(x, cMod);
+  return b.create<arith::RemUIOp>(x, cMod);
+}
+
 static std::pair<Value, Value> bflyCT(ImplicitLocOpBuilder &b, Value A, Value B,
-                                      Value root, Value cMod) {
-  // Since root * B -> [0, cmod^2) then RemUI will compute the modulus
-  auto rootB = b.create<arith::MulIOp>(B, root);
-  auto rootBModded = b.create<arith::RemUIOp>(rootB, cMod);
+                                      Value cMod,
+                                      const NTTLoweringOptions &options,
+                                      function_ref<Value(Value)> mulRoot) {
+  auto rootBModded = mulRoot(B);
 
-  // Since A + rootB -> [0, 2 * cmod) then RemUI will
+  // Since A + rootB -> [0, 2 * cmod) then a single reduction will
   // compute the modulus
   auto ctPlus = b.create<arith::AddIOp>(A, rootBModded);
-  auto ctPlusModded = b.create<arith::RemUIOp>(ctPlus, cMod);
+  auto ctPlusModded = reduceOnce(b, ctPlus, cMod, options);
 
   // Since A - rootB -> (-cmod, cmod) then we can add cmod
   // such that the range is shifted to (0, 2 * cmod) and use
-  // RemUI to compute the modulus
+  // a single reduction to compute the modulus
   auto ctMinus = b.create<arith::SubIOp>(A, rootBModded);
   auto ctMinusShifted = b.create<arith::AddIOp>(ctMinus, cMod);
-  auto ctMinusModded = b.create<arith::RemUIOp>(ctMinusShifted, cMod);
+  auto ctMinusModded = reduceOnce(b, ctMinusShifted, cMod, options);
 
   return {ctPlusModded, ctMinusModded};
 }
 
 static std::pair<Value, Value> bflyGS(ImplicitLocOpBuilder &b, Value A, Value B,
-                                      Value root, Value cMod) {
-  // Since A + B -> [0, 2 * cmod) then RemUI will
+                                      Value cMod,
+                                      const NTTLoweringOptions &options,
+                                      function_ref<Value(Value)> mulRoot) {
+  // Since A + B -> [0, 2 * cmod) then a single reduction will
   // compute the modulus
   auto gsPlus = b.create<arith::AddIOp>(A, B);
-  auto gsPlusModded = b.create<arith::RemUIOp>(gsPlus, cMod);
+  auto gsPlusModded = reduceOnce(b, gsPlus, cMod, options);
 
   // Since A - rootB -> (-cmod, cmod) then we can add cmod such that the range
-  // is shifted to (0, 2 * cmod) and use RemUI to compute the modulus
+  // is shifted to (0, 2 * cmod) and use a single reduction to compute the
+  // modulus
   auto gsMinus = b.create<arith::SubIOp>(A, B);
   auto gsMinusShifted = b.create<arith::AddIOp>(gsMinus, cMod);
-  auto gsMinusModded = b.create<arith::RemUIOp>(gsMinusShifted, cMod);
+  auto gsMinusModded = reduceOnce(b, gsMinusShifted, cMod, options);
 
-  // Since root * (A - B) -> [0, cmod^2) then RemUI will compute the modulus
-  auto gsMinusRoot = b.create<arith::MulIOp>(gsMinusModded, root);
-  auto gsMinusRootModded = b.create<arith::RemUIOp>(gsMinusRoot, cMod);
+  auto gsMinusRootModded = mulRoot(gsMinusModded);
 
   return {gsPlusModded, gsMinusRootModded};
 }
 
+// Compute the stages of the NTT (or INTT, if inverse) of `input` as a nest of
+// affine loops over single butterflies. `rootValues` holds the powers of the
+// root of unity and `shoupValues` their Shoup companions, if enabled.
 template <bool inverse>
-static Value fastNTT(ImplicitLocOpBuilder &b, RingAttr ring,
-                     PrimitiveRootAttr rootAttr, RankedTensorType inputType,
-                     Value input) {
-  // Cast to intermediate type to avoid integer overflow during arithmetic
-  auto intermediateElemType =
-      IntegerType::get(b.getContext(), 2 * inputType.getElementTypeBitWidth());
-  auto intermediateType =
-      inputType.clone(inputType.getShape(), intermediateElemType);
-
-  Value initialValue = b.create<arith::ExtUIOp>(intermediateType, input);
-
-  // Create cmod for modulo arithmetic ops
-  auto modArithType = cast<ModArithType>(ring.getCoefficientType());
-  APInt cmod = modArithType.getModulus().getValue();
-  Value cMod =
-      b.create<arith::ConstantIntOp>(cmod.getZExtValue(), intermediateElemType);
-
-  // Compute the number of stages required to compute the NTT
-  auto degree = intermediateType.getShape()[0];
+static Value loopedNTTStages(ImplicitLocOpBuilder &b, Value input,
+                             ArrayRef<APInt> rootValues,
+                             ArrayRef<APInt> shoupValues, Value cMod,
+                             Value shift, const NTTLoweringOptions &options) {
+  auto inputType = cast<RankedTensorType>(input.getType());
+  auto degree = inputType.getShape()[0];
   unsigned stages = (unsigned)std::log2((double)degree);
 
-  // Precompute the roots
-  APInt root = rootAttr.getValue().getValue();
-  root = !inverse ? root
-                  : multiplicativeInverse(root.zext(cmod.getBitWidth()), cmod)
-                        .trunc(root.getBitWidth());
-
-  auto rootsType = intermediateType.clone({degree});
-  auto roots = b.create<arith::ConstantOp>(
-      rootsType,
-      DenseElementsAttr::get(rootsType, precomputeRoots(root, cmod, degree)));
+  Value roots = createNTTTable(b, inputType, rootValues);
+  Value shoupRoots;
+  if (options.shoupTwiddles) {
+    shoupRoots = createNTTTable(b, inputType, shoupValues);
+  }
 
   // Here is a slightly modified implementation of the standard iterative NTT
   // computation using Cooley-Turkey/Gentleman-Sande butterfly. For reader
@@ -1105,6 +1776,10 @@ static Value fastNTT(ImplicitLocOpBuilder &b, RingAttr ring,
   //
   //    bflyGS(A, B, root, cmod):
   //      (A + B % cmod, (A - B) * root % cmod)
+  //
+  //  With Shoup twiddles, the butterflies compute the products with roots using
+  //  the precomputed companions (see mulModShoup), and reduce sums and
+  //  differences with a conditional subtraction instead of a remainder.
 
   // Initialize the variables
   Value initialBatchSize =
@@ -1121,7 +1796,7 @@ static Value fastNTT(ImplicitLocOpBuilder &b, RingAttr ring,
 
   auto stagesLoop = b.create<affine::AffineForOp>(
       /*lowerBound=*/0, /* upperBound=*/stages, /*step=*/1,
-      /*iterArgs=*/ValueRange{initialValue, initialBatchSize, initialRootExp},
+      /*iterArgs=*/ValueRange{input, initialBatchSize, initialRootExp},
       /*bodyBuilder=*/
       [&](OpBuilder &nestedBuilder, Location nestedLoc, Value index,
           ValueRange args) {
@@ -1168,8 +1843,19 @@ static Value fastNTT(ImplicitLocOpBuilder &b, RingAttr ring,
                         (2 * x + 1) * y, ValueRange{indexJ, rootExp});
                     Value root = b.create<tensor::ExtractOp>(roots, rootIndex);
 
-                    auto bflyResult = inverse ? bflyGS(b, A, B, root, cMod)
-                                              : bflyCT(b, A, B, root, cMod);
+                    Value rootShoup;
+                    if (options.shoupTwiddles) {
+                      rootShoup =
+                          b.create<tensor::ExtractOp>(shoupRoots, rootIndex);
+                    }
+                    auto mulRoot = [&](Value x) {
+                      return mulModRoot(b, x, root, rootShoup, cMod, shift,
+                                        options);
+                    };
+
+                    auto bflyResult =
+                        inverse ? bflyGS(b, A, B, cMod, options, mulRoot)
+                                : bflyCT(b, A, B, cMod, options, mulRoot);
 
                     // Store updated values into accumulator
                     auto insertPlus = b.create<tensor::InsertOp>(
@@ -1194,22 +1880,225 @@ static Value fastNTT(ImplicitLocOpBuilder &b, RingAttr ring,
             ValueRange{innerLoop.getResult(0), batchSize, rootExp});
       });
 
-  Value result = stagesLoop.getResult(0);
+  return stagesLoop.getResult(0);
+}
+
+// Compute the stages of the NTT (or INTT, if inverse) of `input` with one
+// linalg.generic per stage, so that the butterflies of a stage are applied to
+// contiguous blocks of coefficients at once.
+//
+// At a stage with batch size m, the coefficients are viewed as a
+// tensor<n/m x 2 x m/2>: the butterfly inputs A = coeffs[k * m + j] and
+// B = coeffs[k * m + j + m / 2] are the entries [k, 0, j] and [k, 1, j], and
+// the root roots[(2 * j + 1) * rootExp] only depends on j. Slicing out the two
+// halves of all batches gives two tensor<n/m x m/2> operands that the stage
+// combines elementwise with a tensor<m/2> of roots broadcast along k. Once
+// lowered to loops, the innermost loop runs over unit-stride memory and can be
+// vectorized by LLVM.
+template <bool inverse>
+static Value vectorizedNTTStages(ImplicitLocOpBuilder &b, Value input,
+                                 ArrayRef<APInt> rootValues,
+                                 ArrayRef<APInt> shoupValues, Value cMod,
+                                 Value shift,
+                                 const NTTLoweringOptions &options) {
+  auto inputType = cast<RankedTensorType>(input.getType());
+  Type elementType = inputType.getElementType();
+  int64_t degree = inputType.getShape()[0];
+  unsigned stages = (unsigned)std::log2((double)degree);
+
+  AffineExpr d0, d1;
+  bindDims(b.getContext(), d0, d1);
+  AffineMap blockMap = AffineMap::get(2, 0, {d0, d1}, b.getContext());
+  AffineMap rootMap = AffineMap::get(2, 0, {d1}, b.getContext());
+  SmallVector<AffineMap> indexingMaps = {blockMap, blockMap, rootMap};
+  if (options.shoupTwiddles) indexingMaps.push_back(rootMap);
+  indexingMaps.append({blockMap, blockMap});
+  SmallVector<utils::IteratorType> iteratorTypes(2,
+                                                 utils::IteratorType::parallel);
+  SmallVector<ReassociationIndices> reassociation = {{0, 1, 2}};
+  SmallVector<OpFoldResult> strides(3, b.getIndexAttr(1));
+
+  int64_t batchSize = inverse ? degree : 2;
+  int64_t rootExp = inverse ? 1 : degree / 2;
+  Value coeffs = input;
+  for (unsigned stage = 0; stage < stages; ++stage) {
+    int64_t half = batchSize / 2;
+    int64_t numBatches = degree / batchSize;
+    auto blocksType = RankedTensorType::get({numBatches, 2, half}, elementType);
+    auto halfType = RankedTensorType::get({numBatches, half}, elementType);
+    auto stageRootsType = RankedTensorType::get({half}, elementType);
+
+    SmallVector<OpFoldResult> sizes = {b.getIndexAttr(numBatches),
+                                       b.getIndexAttr(1),
+                                       b.getIndexAttr(half)};
+    auto offsets = [&](int64_t i) -> SmallVector<OpFoldResult> {
+      return {b.getIndexAttr(0), b.getIndexAttr(i), b.getIndexAttr(0)};
+    };
+
+    Value blocks =
+        b.create<tensor::ExpandShapeOp>(blocksType, coeffs, reassociation);
+    Value A = b.create<tensor::ExtractSliceOp>(halfType, blocks, offsets(0),
+                                               sizes, strides);
+    Value B = b.create<tensor::ExtractSliceOp>(halfType, blocks, offsets(1),
+                                               sizes, strides);
+
+    // Gather the roots used by this stage
+    SmallVector<APInt> stageRootValues;
+    SmallVector<APInt> stageShoupValues;
+    for (int64_t j = 0; j < half; ++j) {
+      stageRootValues.push_back(rootValues[(2 * j + 1) * rootExp]);
+      if (options.shoupTwiddles) {
+        stageShoupValues.push_back(shoupValues[(2 * j + 1) * rootExp]);
+      }
+    }
+    SmallVector<Value> inputs = {
+        A, B, createNTTTable(b, stageRootsType, stageRootValues)};
+    if (options.shoupTwiddles) {
+      inputs.push_back(createNTTTable(b, stageRootsType, stageShoupValues));
+    }
+
+    // Write both halves of the butterflies into slices of a fresh tensor so
+    // that bufferization can compute the stage in place.
+    Value dest = b.create<tensor::EmptyOp>(blocksType.getShape(), elementType);
+    Value plusInit = b.create<tensor::ExtractSliceOp>(
+        halfType, dest, offsets(0), sizes, strides);
+    Value minusInit = b.create<tensor::ExtractSliceOp>(
+        halfType, dest, offsets(1), sizes, strides);
+
+    auto stageOp = b.create<linalg::GenericOp>(
+        /*resultTypes=*/TypeRange{halfType, halfType},
+        /*inputs=*/inputs,
+        /*outputs=*/ValueRange{plusInit, minusInit},
+        /*indexingMaps=*/indexingMaps,
+        /*iteratorTypes=*/iteratorTypes,
+        /*bodyBuilder=*/
+        [&](OpBuilder &nestedBuilder, Location nestedLoc, ValueRange args) {
+          ImplicitLocOpBuilder b(nestedLoc, nestedBuilder);
+          Value root = args[2];
+          Value rootShoup = options.shoupTwiddles ? args[3] : Value();
+          auto mulRoot = [&](Value x) {
+            return mulModRoot(b, x, root, rootShoup, cMod, shift, options);
+          };
+          auto bflyResult =
+              inverse ? bflyGS(b, args[0], args[1], cMod, options, mulRoot)
+                      : bflyCT(b, args[0], args[1], cMod, options, mulRoot);
+          b.create<linalg::YieldOp>(
+              ValueRange{bflyResult.first, bflyResult.second});
+        });
+
+    Value result = b.create<tensor::InsertSliceOp>(
+        stageOp.getResult(0), dest, offsets(0), sizes, strides);
+    result = b.create<tensor::InsertSliceOp>(stageOp.getResult(1), result,
+                                             offsets(1), sizes, strides);
+    coeffs =
+        b.create<tensor::CollapseShapeOp>(inputType, result, reassociation);
+
+    batchSize = inverse ? batchSize / 2 : batchSize * 2;
+    rootExp = inverse ? rootExp * 2 : rootExp / 2;
+  }
+
+  return coeffs;
+}
+
+template <bool inverse>
+static Value fastNTT(ImplicitLocOpBuilder &b, RingAttr ring,
+                     PrimitiveRootAttr rootAttr, RankedTensorType inputType,
+                     Value input, const NTTLoweringOptions &options) {
+  // Cast to intermediate type to avoid integer overflow during arithmetic,
+  // unless only the products are widened.
+  unsigned inputWidth = inputType.getElementTypeBitWidth();
+  auto intermediateElemType = IntegerType::get(
+      b.getContext(), options.nativeWidth ? inputWidth : 2 * inputWidth);
+  auto intermediateType =
+      inputType.clone(inputType.getShape(), intermediateElemType);
+
+  Value initialValue =
+      options.nativeWidth
+          ? input
+          : b.create<arith::ExtUIOp>(intermediateType, input).getResult();
+
+  // Create cmod for modulo arithmetic ops
+  auto modArithType = cast<ModArithType>(ring.getCoefficientType());
+  APInt cmod = modArithType.getModulus().getValue();
+  Value cMod =
+      b.create<arith::ConstantIntOp>(cmod.getZExtValue(), intermediateElemType);
+
+  auto degree = intermediateType.getShape()[0];
+
+  // Precompute the roots
+  APInt root = rootAttr.getValue().getValue();
+  root = !inverse ? root
+                  : multiplicativeInverse(root.zext(cmod.getBitWidth()), cmod)
+                        .trunc(root.getBitWidth());
+
+  auto rootsType = intermediateType.clone({degree});
+  SmallVector<APInt> rootValues = precomputeRoots(root, cmod, degree);
+
+  // With Shoup twiddles, also precompute floor(root * 2^w / cmod) for each
+  // root, where w is the input width. All butterfly operands are below
+  // cmod < 2^w, so the products with the companions fit the intermediate type.
+  SmallVector<APInt> companions;
+  Value shift;
+  if (options.shoupTwiddles) {
+    companions = llvm::map_to_vector(rootValues, [&](const APInt &rootValue) {
+      return shoupCompanion(rootValue, cmod, inputWidth)
+          .zext(intermediateElemType.getWidth());
+    });
+    if (!options.nativeWidth) {
+      shift = b.create<arith::ConstantIntOp>(inputWidth, intermediateElemType);
+    }
+  }
+
+  Value result =
+      options.vectorizeStages
+          ? vectorizedNTTStages<inverse>(b, initialValue, rootValues,
+                                         companions, cMod, shift, options)
+          : loopedNTTStages<inverse>(b, initialValue, rootValues, companions,
+                                     cMod, shift, options);
   if (inverse) {
     APInt degreeInv =
         multiplicativeInverse(APInt(cmod.getBitWidth(), degree), cmod)
             .trunc(root.getBitWidth());
-    Value nInv = b.create<arith::ConstantOp>(
-        rootsType, DenseElementsAttr::get(rootsType, degreeInv));
-    Value cModVec = b.create<arith::ConstantOp>(
-        rootsType, DenseElementsAttr::get(
-                       rootsType, cmod.zextOrTrunc(root.getBitWidth() + 1)));
-
-    auto mulOp = b.create<arith::MulIOp>(result, nInv);
-    auto remOp = b.create<arith::RemUIOp>(mulOp, cModVec);
-    result = remOp.getResult();
+    if (options.shoupTwiddles) {
+      unsigned intermediateWidth = intermediateElemType.getWidth();
+      auto constant = [&](const APInt &value) -> Value {
+        return b.create<arith::ConstantOp>(
+            rootsType, DenseElementsAttr::get(
+                           rootsType, value.zextOrTrunc(intermediateWidth)));
+      };
+      Value nInv = constant(degreeInv);
+      Value nInvShoup = constant(shoupCompanion(degreeInv, cmod, inputWidth));
+      Value cModVec = constant(cmod);
+      Value shiftVec;
+      if (!options.nativeWidth) {
+        shiftVec = constant(APInt(intermediateWidth, inputWidth));
+      }
+      result = mulModShoup(b, result, nInv, nInvShoup, cModVec, shiftVec,
+                           options.nativeWidth);
+    } else {
+      // Widen to avoid overflow in the product with n^{-1}
+      auto wideType = rootsType.clone(
+          IntegerType::get(b.getContext(), 2 * inputWidth));
+      if (options.nativeWidth) {
+        result = b.create<arith::ExtUIOp>(wideType, result);
+      }
+      Value nInv = b.create<arith::ConstantOp>(
+          wideType, DenseElementsAttr::get(wideType, degreeInv));
+      Value cModVec = b.create<arith::ConstantOp>(
+          wideType, DenseElementsAttr::get(
+                        wideType, cmod.zextOrTrunc(root.getBitWidth() + 1)));
+
+      auto mulOp = b.create<arith::MulIOp>(result, nInv);
+      auto remOp = b.create<arith::RemUIOp>(mulOp, cModVec);
+      result = remOp.getResult();
+      if (options.nativeWidth) {
+        result = b.create<arith::TruncIOp>(inputType, result);
+      }
+    }
   }
 
+  if (options.nativeWidth) return result;
+
   // Truncate back to cmod bitwidth as nttRes < cmod
   auto truncOp = b.create<arith::TruncIOp>(inputType, result);
 
@@ -1217,10 +2106,9 @@ static Value fastNTT(ImplicitLocOpBuilder &b, RingAttr ring,
 }
 
 struct ConvertNTT : public OpConversionPattern<NTTOp> {
-  ConvertNTT(mlir::MLIRContext *context)
-      : OpConversionPattern<NTTOp>(context) {}
-
-  using OpConversionPattern::OpConversionPattern;
+  ConvertNTT(const TypeConverter &typeConverter, mlir::MLIRContext *context,
+             const NTTLoweringOptions &options)
+      : OpConversionPattern<NTTOp>(typeConverter, context), options(options) {}
 
   LogicalResult matchAndRewrite(
       NTTOp op, OpAdaptor adaptor,
@@ -1256,7 +2144,8 @@ struct ConvertNTT : public OpConversionPattern<NTTOp> {
         b.create<mod_arith::ExtractOp>(intTensorType, adaptor.getInput());
     auto nttResult = fastNTT<false>(
         b, ring, op.getRoot().value(), intTensorType,
-        computeReverseBitOrder(b, intTensorType, inputConvertedFromModArith));
+        computeReverseBitOrder(b, intTensorType, inputConvertedFromModArith),
+        options);
 
     // Insert the ring encoding here to the input type
     auto intResultType =
@@ -1266,13 +2155,15 @@ struct ConvertNTT : public OpConversionPattern<NTTOp> {
 
     return success();
   }
+
+ private:
+  NTTLoweringOptions options;
 };
 
 struct ConvertINTT : public OpConversionPattern<INTTOp> {
-  ConvertINTT(mlir::MLIRContext *context)
-      : OpConversionPattern<INTTOp>(context) {}
-
-  using OpConversionPattern::OpConversionPattern;
+  ConvertINTT(const TypeConverter &typeConverter, mlir::MLIRContext *context,
+              const NTTLoweringOptions &options)
+      : OpConversionPattern<INTTOp>(typeConverter, context), options(options) {}
 
   LogicalResult matchAndRewrite(
       INTTOp op, OpAdaptor adaptor,
@@ -1299,7 +2190,7 @@ struct ConvertINTT : public OpConversionPattern<INTTOp> {
 
     auto input = b.create<tensor::CastOp>(resultType, adaptor.getInput());
     auto nttResult = fastNTT<true>(b, typeInfo.ringAttr, op.getRoot().value(),
-                                   resultType, input);
+                                   resultType, input, options);
 
     auto reversedBitOrder = computeReverseBitOrder(b, resultType, nttResult);
     auto outputType = typeConverter->convertType(op.getOutput().getType());
@@ -1310,8 +2201,62 @@ struct ConvertINTT : public OpConversionPattern<INTTOp> {
 
     return success();
   }
+
+ private:
+  NTTLoweringOptions options;
 };
 
+void PolynomialToModArith::poolNTTTables() {
+  ModuleOp module = getOperation();
+  SmallVector<arith::ConstantOp> tables;
+  module.walk([&](arith::ConstantOp op) {
+    if (op->hasAttr(kNTTTableAttrName)) tables.push_back(op);
+  });
+
+  // Identical tables, such as the roots of the same ring and primitive root,
+  // share a global. Each function reads a global through a single restrict
+  // tensor created at its entry, since bufferization requires the restrict
+  // tensors of a buffer to be unique. The symbol table renames a global whose
+  // name is already taken in the module.
+  DenseMap<Attribute, StringAttr> globals;
+  DenseMap<std::pair<Operation *, Attribute>, Value> functionTables;
+  SymbolTable symbolTable(module);
+  Block::iterator globalsInsertPt = module.getBody()->begin();
+  OpBuilder builder(module.getContext());
+  for (arith::ConstantOp op : tables) {
+    op->removeAttr(kNTTTableAttrName);
+    if (!poolTwiddles) continue;
+
+    auto value = cast<DenseElementsAttr>(op.getValue());
+    auto tensorType = cast<RankedTensorType>(value.getType());
+    auto memrefType =
+        MemRefType::get(tensorType.getShape(), tensorType.getElementType());
+    StringAttr &globalName = globals[value];
+    if (!globalName) {
+      auto global = builder.create<memref::GlobalOp>(
+          op.getLoc(),
+          llvm::formatv("__heir_ntt_table_{0}", globals.size() - 1).str(),
+          /*sym_visibility=*/builder.getStringAttr("private"), memrefType,
+          value, /*constant=*/true, /*alignment=*/IntegerAttr());
+      globalName = symbolTable.insert(global, globalsInsertPt);
+    }
+
+    auto funcOp = op->getParentOfType<func::FuncOp>();
+    Operation *scope = funcOp ? funcOp.getOperation() : op.getOperation();
+    Value &table = functionTables[std::make_pair(scope, value)];
+    if (!table) {
+      ImplicitLocOpBuilder b(op.getLoc(), op);
+      if (funcOp) b.setInsertionPointToStart(&funcOp.getBody().front());
+      auto getGlobal =
+          b.create<memref::GetGlobalOp>(memrefType, globalName.getValue());
+      table = b.create<bufferization::ToTensorOp>(getGlobal.getResult(),
+                                                  /*restrict=*/true);
+    }
+    op.replaceAllUsesWith(table);
+    op.erase();
+  }
+}
+
 void PolynomialToModArith::runOnOperation() {
   MLIRContext *context = &getContext();
   // generateOpImplementations must be called before the conversion begins to
@@ -1331,21 +2276,35 @@ void PolynomialToModArith::runOnOperation() {
   PolynomialToModArithTypeConverter typeConverter(context);
 
   target.addIllegalDialect<PolynomialDialect>();
+  target.addIllegalOp<rns::PackOp, rns::UnpackOp, rns::ExtendBasisOp,
+                      rns::RescaleOp>();
   RewritePatternSet patterns(context);
 
   patterns.add<ConvertFromTensor, ConvertToTensor,
                ConvertBinop<AddOp, arith::AddIOp, mod_arith::AddOp>,
                ConvertBinop<SubOp, arith::SubIOp, mod_arith::SubOp>,
                ConvertLeadingTerm, ConvertMonomial, ConvertMonicMonomialMul,
-               ConvertConstant, ConvertMulScalar, ConvertNTT, ConvertINTT>(
-      typeConverter, context);
-  patterns.add<ConvertMul>(typeConverter, patterns.getContext(), getDivmodOp);
+               ConvertConstant, ConvertMulScalar, ConvertPack, ConvertUnpack,
+               ConvertExtendBasis, ConvertRescale>(typeConverter, context);
+  NTTLoweringOptions nttOptions;
+  nttOptions.shoupTwiddles = shoupTwiddles;
+  nttOptions.nativeWidth = nativeWidth;
+  nttOptions.vectorizeStages = vectorizeStages;
+  patterns.add<ConvertNTT, ConvertINTT>(typeConverter, context, nttOptions);
+  auto getKaratsubaOp = [&](FunctionType funcType) -> func::FuncOp {
+    return karatsubaImpls.lookup(funcType);
+  };
+  patterns.add<ConvertMul>(typeConverter, patterns.getContext(), getDivmodOp,
+                           getKaratsubaOp);
   addStructuralConversionPatterns(typeConverter, patterns, target);
   addTensorOfTensorConversionPatterns(typeConverter, patterns, target);
 
   if (failed(applyPartialConversion(module, target, std::move(patterns)))) {
     signalPassFailure();
+    return;
   }
+
+  poolNTTTables();
 }
 
 }  // namespace polynomial
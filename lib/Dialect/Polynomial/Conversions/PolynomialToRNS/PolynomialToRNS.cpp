@@ -0,0 +1,361 @@
+#include "lib/Dialect/Polynomial/Conversions/PolynomialToRNS/PolynomialToRNS.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <tuple>
+#include <utility>
+
+#include "lib/Dialect/ModArith/IR/ModArithDialect.h"
+#include "lib/Dialect/ModArith/IR/ModArithOps.h"
+#include "lib/Dialect/ModArith/IR/ModArithTypes.h"
+#include "lib/Dialect/Polynomial/IR/Polynomial.h"
+#include "lib/Dialect/Polynomial/IR/PolynomialAttributes.h"
+#include "lib/Dialect/Polynomial/IR/PolynomialDialect.h"
+#include "lib/Dialect/Polynomial/IR/PolynomialOps.h"
+#include "lib/Dialect/Polynomial/IR/PolynomialTypes.h"
+#include "lib/Dialect/RNS/IR/RNSDialect.h"
+#include "lib/Dialect/RNS/IR/RNSOps.h"
+#include "lib/Dialect/RNS/IR/RNSTypes.h"
+#include "llvm/include/llvm/ADT/APInt.h"        // from @llvm-project
+#include "llvm/include/llvm/ADT/SmallVector.h"  // from @llvm-project
+#include "mlir/include/mlir/Dialect/Arith/IR/Arith.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/BuiltinAttributes.h"    // from @llvm-project
+#include "mlir/include/mlir/IR/BuiltinTypes.h"         // from @llvm-project
+#include "mlir/include/mlir/IR/ImplicitLocOpBuilder.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/Location.h"              // from @llvm-project
+#include "mlir/include/mlir/IR/MLIRContext.h"           // from @llvm-project
+#include "mlir/include/mlir/IR/PatternMatch.h"          // from @llvm-project
+#include "mlir/include/mlir/IR/ValueRange.h"            // from @llvm-project
+#include "mlir/include/mlir/Support/LLVM.h"             // from @llvm-project
+#include "mlir/include/mlir/Support/LogicalResult.h"    // from @llvm-project
+#include "mlir/include/mlir/Transforms/DialectConversion.h"  // from @llvm-project
+
+namespace mlir {
+namespace heir {
+namespace polynomial {
+
+using mod_arith::ModArithType;
+using rns::RNSType;
+
+#define GEN_PASS_DEF_POLYNOMIALTORNS
+#include "lib/Dialect/Polynomial/Conversions/PolynomialToRNS/PolynomialToRNS.h.inc"
+
+/// Returns the limb types of the RNS decomposition of `type` with respect to
+/// `moduli`, or an empty vector if the coefficient modulus of `type` is not
+/// the product of at least two of the moduli.
+static SmallVector<Type> getLimbTypes(PolynomialType type,
+                                      ArrayRef<uint64_t> moduli) {
+  RingAttr ring = type.getRing();
+  auto coeffType = dyn_cast<ModArithType>(ring.getCoefficientType());
+  if (!coeffType) return {};
+
+  APInt rest = coeffType.getModulus().getValue();
+  unsigned width = rest.getBitWidth();
+  SmallVector<uint64_t> limbModuli;
+  unsigned maxLimbBits = 0;
+  for (uint64_t modulus : moduli) {
+    APInt limbModulus(64, modulus);
+    if (modulus < 2 || limbModulus.getActiveBits() > width) continue;
+    limbModulus = limbModulus.zextOrTrunc(width);
+    if (!rest.urem(limbModulus).isZero()) continue;
+    rest = rest.udiv(limbModulus);
+    limbModuli.push_back(modulus);
+    maxLimbBits = std::max(maxLimbBits, limbModulus.getActiveBits());
+  }
+  if (!rest.isOne() || limbModuli.size() < 2) return {};
+
+  MLIRContext *ctx = type.getContext();
+  // The storage type of a mod_arith type must be at least one bit wider than
+  // its modulus.
+  unsigned limbWidth = maxLimbBits < 32 ? 32 : maxLimbBits < 64 ? 64 : 128;
+  limbWidth = std::min(limbWidth, width);
+  auto limbStorageType = IntegerType::get(ctx, limbWidth);
+  SmallVector<Type> limbTypes;
+  for (uint64_t modulus : limbModuli) {
+    auto limbCoeffType = ModArithType::get(
+        ctx, IntegerAttr::get(limbStorageType, APInt(limbWidth, modulus)));
+    limbTypes.push_back(PolynomialType::get(
+        ctx, RingAttr::get(limbCoeffType, ring.getPolynomialModulus())));
+  }
+  return limbTypes;
+}
+
+static ModArithType getCoefficientType(Type polyType) {
+  return cast<ModArithType>(
+      cast<PolynomialType>(polyType).getRing().getCoefficientType());
+}
+
+static int64_t getDegree(PolynomialType polyType) {
+  return polyType.getRing().getPolynomialModulus().getPolynomial().getDegree();
+}
+
+/// Returns the inverse of `a` modulo `m`, assuming that they are coprime.
+static APInt inverseModulo(const APInt &a, const APInt &m) {
+  // The Bézout coefficients are bounded by m in absolute value, so one extra
+  // bit for the sign suffices.
+  unsigned width = m.getBitWidth() + 1;
+  APInt r0 = m.zext(width), r1 = a.zext(width);
+  APInt t0(width, 0), t1(width, 1);
+  while (!r1.isZero()) {
+    APInt q = r0.sdiv(r1);
+    std::tie(r0, r1) = std::make_pair(r1, r0 - q * r1);
+    std::tie(t0, t1) = std::make_pair(t1, t0 - q * t1);
+  }
+  if (t0.isNegative()) t0 += m.zext(width);
+  return t0.trunc(m.getBitWidth());
+}
+
+/// Reduces the storage integers `value` of a mod_arith value modulo the
+/// modulus of `limbType`, and returns the result as a value of `limbType`, or
+/// of a tensor of `limbType` if `value` is a tensor.
+static Value reduceToLimb(ImplicitLocOpBuilder &b, Value value,
+                          ModArithType limbType) {
+  auto limbStorageType = cast<IntegerType>(limbType.getModulus().getType());
+  APInt limbModulus = limbType.getModulus().getValue();
+  Type storageType = getElementTypeOrSelf(value.getType());
+  unsigned width = storageType.getIntOrFloatBitWidth();
+
+  TypedAttr modulusAttr =
+      IntegerAttr::get(storageType, limbModulus.zext(width));
+  Type resultStorageType = limbStorageType;
+  Type resultType = limbType;
+  if (auto tensorType = dyn_cast<RankedTensorType>(value.getType())) {
+    modulusAttr = DenseElementsAttr::get(tensorType, modulusAttr);
+    resultStorageType = tensorType.clone(limbStorageType);
+    resultType = tensorType.clone(limbType);
+  }
+  Value modulus = b.create<arith::ConstantOp>(modulusAttr);
+  Value residue = b.create<arith::RemUIOp>(value, modulus);
+  if (limbStorageType.getWidth() < width)
+    residue = b.create<arith::TruncIOp>(resultStorageType, residue);
+  return b.create<mod_arith::EncapsulateOp>(resultType, residue);
+}
+
+/// Decomposes a polynomial over the product modulus into its residues modulo
+/// the limb moduli of `rnsType`.
+static Value decompose(OpBuilder &builder, RNSType rnsType, ValueRange inputs,
+                       Location loc) {
+  assert(inputs.size() == 1);
+  ImplicitLocOpBuilder b(loc, builder);
+  auto polyType = cast<PolynomialType>(inputs[0].getType());
+  ModArithType coeffType = getCoefficientType(polyType);
+  int64_t degree = getDegree(polyType);
+
+  auto coeffs = b.create<ToTensorOp>(
+      RankedTensorType::get({degree}, coeffType), inputs[0]);
+  auto storage = b.create<mod_arith::ExtractOp>(
+      RankedTensorType::get({degree}, coeffType.getModulus().getType()),
+      coeffs);
+  SmallVector<Value> limbs;
+  for (Type limbType : rnsType.getBasisTypes()) {
+    Value residues = reduceToLimb(b, storage, getCoefficientType(limbType));
+    limbs.push_back(b.create<FromTensorOp>(limbType, residues));
+  }
+  return b.create<rns::PackOp>(rnsType, limbs);
+}
+
+/// Reconstructs a polynomial over the product modulus Q from its residues
+/// x_i modulo the limb moduli q_i with the Chinese remainder theorem,
+///
+///   x = sum_i [x_i * (Q/q_i)^{-1} mod q_i] * (Q/q_i) mod Q.
+///
+/// Only the final multiplication and sum need arithmetic modulo Q.
+static Value reconstruct(OpBuilder &builder, PolynomialType polyType,
+                         ValueRange inputs, Location loc) {
+  assert(inputs.size() == 1);
+  ImplicitLocOpBuilder b(loc, builder);
+  auto rnsType = cast<RNSType>(inputs[0].getType());
+  ModArithType coeffType = getCoefficientType(polyType);
+  auto storageType = cast<IntegerType>(coeffType.getModulus().getType());
+  APInt cmod = coeffType.getModulus().getValue();
+  int64_t degree = getDegree(polyType);
+  auto tensorType = RankedTensorType::get({degree}, coeffType);
+  auto storageTensorType = RankedTensorType::get({degree}, storageType);
+
+  auto limbs = b.create<rns::UnpackOp>(rnsType.getBasisTypes(), inputs[0]);
+  Value result;
+  for (auto [limb, limbType] :
+       llvm::zip(limbs.getResults(), rnsType.getBasisTypes())) {
+    ModArithType limbCoeffType = getCoefficientType(limbType);
+    auto limbStorageType =
+        cast<IntegerType>(limbCoeffType.getModulus().getType());
+    APInt limbModulus = limbCoeffType.getModulus().getValue();
+    APInt cofactor = cmod.udiv(limbModulus.zext(cmod.getBitWidth()));
+    APInt cofactorInverse = inverseModulo(
+        cofactor.urem(limbModulus.zext(cmod.getBitWidth()))
+            .trunc(limbModulus.getBitWidth()),
+        limbModulus);
+
+    auto limbTensorType = RankedTensorType::get({degree}, limbCoeffType);
+    auto limbStorageTensorType =
+        RankedTensorType::get({degree}, limbStorageType);
+    Value residues = b.create<ToTensorOp>(limbTensorType, limb);
+    auto inverse = b.create<mod_arith::EncapsulateOp>(
+        limbTensorType,
+        b.create<arith::ConstantOp>(
+            DenseElementsAttr::get(limbStorageTensorType, cofactorInverse)));
+    Value scaled = b.create<mod_arith::MulOp>(residues, inverse);
+    Value scaledStorage =
+        b.create<mod_arith::ExtractOp>(limbStorageTensorType, scaled);
+    if (limbStorageType.getWidth() < storageType.getWidth())
+      scaledStorage = b.create<arith::ExtUIOp>(storageTensorType, scaledStorage);
+    auto cofactorTensor = b.create<mod_arith::EncapsulateOp>(
+        tensorType, b.create<arith::ConstantOp>(
+                        DenseElementsAttr::get(storageTensorType, cofactor)));
+    Value term = b.create<mod_arith::MulOp>(
+        b.create<mod_arith::EncapsulateOp>(tensorType, scaledStorage),
+        cofactorTensor);
+    result = result ? b.create<mod_arith::AddOp>(result, term) : term;
+  }
+  return b.create<FromTensorOp>(polyType, result);
+}
+
+class PolynomialToRNSTypeConverter : public TypeConverter {
+ public:
+  PolynomialToRNSTypeConverter(MLIRContext *ctx, ArrayRef<uint64_t> moduli) {
+    addConversion([](Type type) { return type; });
+    addConversion([ctx, moduli](PolynomialType type) -> Type {
+      SmallVector<Type> limbTypes = getLimbTypes(type, moduli);
+      if (limbTypes.empty()) return type;
+      return RNSType::get(ctx, limbTypes);
+    });
+
+    addTargetMaterialization(decompose);
+    addSourceMaterialization(reconstruct);
+    addArgumentMaterialization(reconstruct);
+  }
+};
+
+// Applies an op separately to each limb of its RNS operands. Operands of the
+// coefficient type of the original ring are reduced to the coefficient type
+// of each limb, and other operands are passed through.
+template <typename SourceOp>
+struct ConvertLimbwise : public OpConversionPattern<SourceOp> {
+  using OpConversionPattern<SourceOp>::OpConversionPattern;
+
+  LogicalResult matchAndRewrite(
+      SourceOp op, typename SourceOp::Adaptor adaptor,
+      ConversionPatternRewriter &rewriter) const override {
+    auto rnsType = dyn_cast_or_null<RNSType>(
+        this->typeConverter->convertType(op.getType()));
+    if (!rnsType) return failure();
+    ModArithType coeffType = getCoefficientType(op.getType());
+
+    ImplicitLocOpBuilder b(op.getLoc(), rewriter);
+    SmallVector<ValueRange> unpacked;
+    for (Value operand : adaptor.getOperands()) {
+      if (operand.getType() == rnsType)
+        unpacked.push_back(
+            b.create<rns::UnpackOp>(rnsType.getBasisTypes(), operand)
+                .getResults());
+    }
+
+    SmallVector<Value> limbs;
+    for (auto [i, limbType] : llvm::enumerate(rnsType.getBasisTypes())) {
+      SmallVector<Value> operands;
+      unsigned rnsOperand = 0;
+      for (Value operand : adaptor.getOperands()) {
+        if (operand.getType() == rnsType) {
+          operands.push_back(unpacked[rnsOperand++][i]);
+        } else if (operand.getType() == coeffType) {
+          Value storage = b.create<mod_arith::ExtractOp>(
+              coeffType.getModulus().getType(), operand);
+          operands.push_back(
+              reduceToLimb(b, storage, getCoefficientType(limbType)));
+        } else {
+          operands.push_back(operand);
+        }
+      }
+      limbs.push_back(b.create<SourceOp>(TypeRange{limbType}, operands,
+                                         op->getAttrs())
+                          ->getResult(0));
+    }
+    rewriter.replaceOpWithNewOp<rns::PackOp>(op, rnsType, limbs);
+    return success();
+  }
+};
+
+// Reduces the coefficients of a constant modulo each limb modulus.
+struct ConvertConstant : public OpConversionPattern<ConstantOp> {
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult matchAndRewrite(
+      ConstantOp op, OpAdaptor adaptor,
+      ConversionPatternRewriter &rewriter) const override {
+    auto rnsType =
+        dyn_cast_or_null<RNSType>(typeConverter->convertType(op.getType()));
+    auto attr = dyn_cast<TypedIntPolynomialAttr>(op.getValue());
+    if (!rnsType || !attr) return failure();
+
+    ImplicitLocOpBuilder b(op.getLoc(), rewriter);
+    // See the use-after-free warning in PolynomialToModArith's ConvertConstant.
+    const IntPolynomial &poly = attr.getValue().getPolynomial();
+    SmallVector<Value> limbs;
+    for (Type limbType : rnsType.getBasisTypes()) {
+      APInt limbModulus = getCoefficientType(limbType).getModulus().getValue();
+      SmallVector<IntMonomial> monomials;
+      for (const auto &term : poly.getTerms()) {
+        // Constant coefficients have at most 64 bits, and the limb moduli fit
+        // in 64 bits as well.
+        APInt modulus = limbModulus.zextOrTrunc(apintBitWidth + 1);
+        APInt coeff =
+            term.getCoefficient().sextOrTrunc(apintBitWidth + 1).srem(modulus);
+        if (coeff.isNegative()) coeff += modulus;
+        if (coeff.isZero()) continue;
+        monomials.emplace_back(coeff.getZExtValue(),
+                               term.getExponent().getZExtValue());
+      }
+      FailureOr<IntPolynomial> limbPoly =
+          IntPolynomial::fromMonomials(monomials);
+      if (failed(limbPoly)) return failure();
+      limbs.push_back(b.create<ConstantOp>(
+          limbType, TypedIntPolynomialAttr::get(limbType, limbPoly.value())));
+    }
+    rewriter.replaceOpWithNewOp<rns::PackOp>(op, rnsType, limbs);
+    return success();
+  }
+};
+
+struct PolynomialToRNS : impl::PolynomialToRNSBase<PolynomialToRNS> {
+  using PolynomialToRNSBase::PolynomialToRNSBase;
+
+  void runOnOperation() override {
+    MLIRContext *context = &getContext();
+    SmallVector<uint64_t> limbModuli(moduli.begin(), moduli.end());
+    for (auto [i, a] : llvm::enumerate(limbModuli)) {
+      for (uint64_t b : ArrayRef(limbModuli).drop_front(i + 1)) {
+        if (std::gcd(a, b) != 1) {
+          getOperation()->emitError()
+              << "expected pairwise coprime RNS moduli, but " << a << " and "
+              << b << " are not coprime";
+          signalPassFailure();
+          return;
+        }
+      }
+    }
+
+    PolynomialToRNSTypeConverter typeConverter(context, limbModuli);
+    ConversionTarget target(*context);
+    target.addLegalDialect<arith::ArithDialect, mod_arith::ModArithDialect,
+                           PolynomialDialect, rns::RNSDialect>();
+    target.addDynamicallyLegalOp<AddOp, SubOp, MulOp, MulScalarOp,
+                                 MonicMonomialMulOp, ConstantOp>(
+        [&](Operation *op) { return typeConverter.isLegal(op); });
+
+    RewritePatternSet patterns(context);
+    patterns.add<ConvertLimbwise<AddOp>, ConvertLimbwise<SubOp>,
+                 ConvertLimbwise<MulOp>, ConvertLimbwise<MulScalarOp>,
+                 ConvertLimbwise<MonicMonomialMulOp>, ConvertConstant>(
+        typeConverter, context);
+
+    if (failed(applyPartialConversion(getOperation(), target,
+                                      std::move(patterns)))) {
+      signalPassFailure();
+    }
+  }
+};
+
+}  // namespace polynomial
+}  // namespace heir
+}  // namespace mlir
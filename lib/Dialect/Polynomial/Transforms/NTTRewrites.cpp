@@ -1,8 +1,27 @@
 #include "lib/Dialect/Polynomial/Transforms/NTTRewrites.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+#include "lib/Dialect/ModArith/IR/ModArithOps.h"
+#include "lib/Dialect/ModArith/IR/ModArithTypes.h"
+#include "lib/Dialect/Polynomial/IR/Polynomial.h"
+#include "lib/Dialect/Polynomial/IR/PolynomialAttributes.h"
 #include "lib/Dialect/Polynomial/IR/PolynomialOps.h"
-#include "mlir/include/mlir/IR/MLIRContext.h"   // from @llvm-project
-#include "mlir/include/mlir/IR/PatternMatch.h"  // from @llvm-project
+#include "lib/Dialect/Polynomial/IR/PolynomialTypes.h"
+#include "llvm/include/llvm/ADT/APInt.h"             // from @llvm-project
+#include "llvm/include/llvm/ADT/STLExtras.h"         // from @llvm-project
+#include "llvm/include/llvm/Support/MathExtras.h"    // from @llvm-project
+#include "mlir/include/mlir/Dialect/Arith/IR/Arith.h"    // from @llvm-project
+#include "mlir/include/mlir/Dialect/Tensor/IR/Tensor.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/BuiltinAttributes.h"      // from @llvm-project
+#include "mlir/include/mlir/IR/BuiltinTypes.h"           // from @llvm-project
+#include "mlir/include/mlir/IR/Location.h"               // from @llvm-project
+#include "mlir/include/mlir/IR/MLIRContext.h"            // from @llvm-project
+#include "mlir/include/mlir/IR/PatternMatch.h"           // from @llvm-project
+#include "mlir/include/mlir/IR/Value.h"                  // from @llvm-project
+#include "mlir/include/mlir/Support/LLVM.h"              // from @llvm-project
 #include "mlir/include/mlir/Transforms/GreedyPatternRewriteDriver.h"  // from @llvm-project
 
 namespace mlir {
@@ -10,19 +29,314 @@ namespace heir {
 namespace polynomial {
 
 #define GEN_PASS_DEF_POLYMULTONTT
+#define GEN_PASS_DEF_PROPAGATENTTFORM
 #include "lib/Dialect/Polynomial/Transforms/Passes.h.inc"
 
+// The number of small integers tried as generators when searching for a
+// primitive root of unity.
+static constexpr uint64_t kMaxRootCandidates = 256;
+
+// Compute base^exp mod cmod for base < cmod.
+static APInt powMod(const APInt &base, const APInt &exp, const APInt &cmod) {
+  unsigned width = 2 * cmod.getBitWidth();
+  APInt wideBase = base.zextOrTrunc(width);
+  APInt wideCmod = cmod.zextOrTrunc(width);
+  APInt result(width, 1);
+  for (unsigned i = exp.getActiveBits(); i > 0; --i) {
+    result = (result * result).urem(wideCmod);
+    if (exp[i - 1]) result = (result * wideBase).urem(wideCmod);
+  }
+  return result.trunc(cmod.getBitWidth());
+}
+
+/// Returns a primitive 2n-th root of unity modulo the coefficient modulus of
+/// the ring of the polynomial type `type`, as required to lower the NTT of a
+/// ring with polynomial modulus x^n + 1 for a power of two n. Returns nullptr
+/// if the ring has a different shape or no such root could be found.
+///
+/// The coefficient modulus q is expected to be prime, in which case a root
+/// exists if and only if 2n divides q - 1.
+static PrimitiveRootAttr getNTTRoot(Type type) {
+  auto polyType = dyn_cast<PolynomialType>(type);
+  if (!polyType) return nullptr;
+  RingAttr ring = polyType.getRing();
+  auto coeffType =
+      dyn_cast<mod_arith::ModArithType>(ring.getCoefficientType());
+  if (!coeffType || !ring.getPolynomialModulus()) return nullptr;
+
+  IntPolynomial ideal = ring.getPolynomialModulus().getPolynomial();
+  auto idealTerms = ideal.getTerms();
+  if (idealTerms.size() != 2 || !idealTerms[0].getExponent().isZero() ||
+      !idealTerms[0].getCoefficient().isOne() ||
+      !idealTerms[1].getCoefficient().isOne()) {
+    return nullptr;
+  }
+  unsigned degree = ideal.getDegree();
+  if (!llvm::isPowerOf2_32(degree)) return nullptr;
+
+  APInt cmod = coeffType.getModulus().getValue();
+  unsigned width = cmod.getBitWidth();
+  // 2n must divide q - 1, so in particular q > 2n.
+  if (cmod.getActiveBits() <= llvm::Log2_32(2 * degree)) return nullptr;
+  APInt rootDegree(width, 2 * degree);
+  APInt cmodMinusOne = cmod - 1;
+  if (!cmodMinusOne.urem(rootDegree).isZero()) return nullptr;
+
+  APInt exponent = cmodMinusOne.udiv(rootDegree);
+  APInt halfDegree(width, degree);
+  for (uint64_t g = 2; g < kMaxRootCandidates && cmod.ugt(g); ++g) {
+    APInt root = powMod(APInt(width, g), exponent, cmod);
+    // If root^n = -1, then root^2n = 1 and, as 2n is a power of two, the order
+    // of root is exactly 2n.
+    if (powMod(root, halfDegree, cmod) == cmodMinusOne) {
+      IntegerType storageType = coeffType.getModulus().getType();
+      return PrimitiveRootAttr::get(type.getContext(),
+                                    IntegerAttr::get(storageType, root),
+                                    IntegerAttr::get(storageType, rootDegree));
+    }
+  }
+  return nullptr;
+}
+
+/// Returns the type of the point-value representation of a polynomial of type
+/// `type`: a tensor of the coefficient storage type, encoded with the ring of
+/// the polynomial if `withRing` is set.
+static RankedTensorType getNTTTensorType(Type type, bool withRing) {
+  RingAttr ring = cast<PolynomialType>(type).getRing();
+  auto coeffType = cast<mod_arith::ModArithType>(ring.getCoefficientType());
+  int64_t degree = ring.getPolynomialModulus().getPolynomial().getDegree();
+  return RankedTensorType::get({degree}, coeffType.getModulus().getType(),
+                               withRing ? Attribute(ring) : Attribute());
+}
+
+/// Returns the type of the point-value representation of a polynomial of type
+/// `type` as a tensor of its mod_arith coefficient type.
+static RankedTensorType getModArithTensorType(Type type) {
+  RingAttr ring = cast<PolynomialType>(type).getRing();
+  int64_t degree = ring.getPolynomialModulus().getPolynomial().getDegree();
+  return RankedTensorType::get({degree}, ring.getCoefficientType());
+}
+
 namespace rewrites {
 // In an inner namespace to avoid conflicts with canonicalization patterns
 #include "lib/Dialect/Polynomial/Transforms/NTTRewrites.cpp.inc"
 }  // namespace rewrites
 
+/// Computes the NTT of `coeffs` with the 2n-th root of unity `root` modulo
+/// `cmod`, in the same order as the lowering of `polynomial.ntt`: the
+/// coefficients are permuted to bit-reversed order and transformed in place
+/// with Cooley-Tukey butterflies.
+static SmallVector<APInt> computeNTT(ArrayRef<APInt> coeffs, const APInt &root,
+                                     const APInt &cmod) {
+  unsigned width = cmod.getBitWidth();
+  unsigned wideWidth = 2 * width;
+  APInt wideCmod = cmod.zext(wideWidth);
+  auto mulMod = [&](const APInt &a, const APInt &b) {
+    return (a.zext(wideWidth) * b.zext(wideWidth)).urem(wideCmod).trunc(width);
+  };
+  auto addMod = [&](const APInt &a, const APInt &b) {
+    return (a.zext(wideWidth) + b.zext(wideWidth)).urem(wideCmod).trunc(width);
+  };
+
+  size_t degree = coeffs.size();
+  unsigned logDegree = llvm::Log2_64(degree);
+  SmallVector<APInt> values(degree, APInt(width, 0));
+  for (size_t i = 0; i < degree; ++i) {
+    values[i] = coeffs[APInt(logDegree, i).reverseBits().getZExtValue()];
+  }
+  SmallVector<APInt> roots(degree, APInt(width, 1));
+  for (size_t i = 1; i < degree; ++i) roots[i] = mulMod(roots[i - 1], root);
+
+  size_t rootExp = degree / 2;
+  for (size_t batchSize = 2; batchSize <= degree; batchSize *= 2) {
+    for (size_t k = 0; k < degree; k += batchSize) {
+      for (size_t j = 0; j < batchSize / 2; ++j) {
+        APInt a = values[k + j];
+        APInt rootB =
+            mulMod(values[k + j + batchSize / 2], roots[(2 * j + 1) * rootExp]);
+        values[k + j] = addMod(a, rootB);
+        values[k + j + batchSize / 2] = addMod(a, cmod - rootB);
+      }
+    }
+    rootExp /= 2;
+  }
+  return values;
+}
+
+/// Replaces the NTT of a `polynomial.constant` with its point values,
+/// computed at compile time. After `polynomial.mul` is rewritten to the NTT,
+/// a product with a constant, such as an encoded plaintext or a key, then
+/// needs one forward and one inverse transform instead of two forward
+/// transforms and one inverse transform.
+struct FoldNTTOfConstant : public OpRewritePattern<NTTOp> {
+  using OpRewritePattern::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(NTTOp op,
+                                PatternRewriter &rewriter) const override {
+    auto constant = op.getInput().getDefiningOp<ConstantOp>();
+    if (!constant || !op.getRoot()) return failure();
+    auto attr = dyn_cast<TypedIntPolynomialAttr>(constant.getValue());
+    if (!attr) return failure();
+
+    RankedTensorType nttType = op.getOutput().getType();
+    auto ring = cast<RingAttr>(nttType.getEncoding());
+    auto coeffType =
+        dyn_cast<mod_arith::ModArithType>(ring.getCoefficientType());
+    if (!coeffType) return failure();
+    APInt cmod = coeffType.getModulus().getValue();
+    unsigned width = cmod.getBitWidth();
+    int64_t degree = nttType.getShape()[0];
+
+    // Reduce the coefficients, which may be negative, modulo cmod.
+    unsigned signedWidth = std::max(width, apintBitWidth) + 1;
+    APInt signedCmod = cmod.zext(signedWidth);
+    SmallVector<APInt> coeffs(degree, APInt(width, 0));
+    // See the use-after-free warning in PolynomialToModArith's ConvertConstant.
+    const IntPolynomial &poly = attr.getValue().getPolynomial();
+    for (const auto &term : poly.getTerms()) {
+      uint64_t exponent = term.getExponent().getZExtValue();
+      if (exponent >= (uint64_t)degree) return failure();
+      APInt coeff =
+          term.getCoefficient().sextOrTrunc(signedWidth).srem(signedCmod);
+      if (coeff.isNegative()) coeff += signedCmod;
+      coeffs[exponent] = coeff.trunc(width);
+    }
+
+    APInt root = op.getRoot()->getValue().getValue().zextOrTrunc(width);
+    auto storageType =
+        RankedTensorType::get(nttType.getShape(), nttType.getElementType());
+    auto values = rewriter.create<arith::ConstantOp>(
+        op.getLoc(), storageType,
+        DenseElementsAttr::get(storageType, computeNTT(coeffs, root, cmod)));
+    rewriter.replaceOpWithNewOp<tensor::CastOp>(op, nttType, values);
+    return success();
+  }
+};
+
 struct PolyMulToNTT : impl::PolyMulToNTTBase<PolyMulToNTT> {
   void runOnOperation() override {
     MLIRContext *context = &getContext();
     RewritePatternSet patterns(context);
-    // TODO(#1095): migrate to mod arith type
-    // patterns.add<rewrites::NTTRewritePolyMul>(patterns.getContext());
+    patterns.add<rewrites::NTTRewritePolyMul, FoldNTTOfConstant>(
+        patterns.getContext());
+    (void)applyPatternsAndFoldGreedily(getOperation(), std::move(patterns));
+  }
+};
+
+/// Views the point-value tensor `tensor`, of type tensor<n x iK, #ring>, as a
+/// tensor of the mod_arith coefficient type of the ring.
+static Value toModArithTensor(PatternRewriter &rewriter, Location loc,
+                              Value tensor) {
+  auto nttType = cast<RankedTensorType>(tensor.getType());
+  auto ring = cast<RingAttr>(nttType.getEncoding());
+  auto storageType =
+      RankedTensorType::get(nttType.getShape(), nttType.getElementType());
+  auto modArithType =
+      RankedTensorType::get(nttType.getShape(), ring.getCoefficientType());
+  auto storage = rewriter.create<tensor::CastOp>(loc, storageType, tensor);
+  return rewriter.create<mod_arith::EncapsulateOp>(loc, modArithType, storage);
+}
+
+/// The inverse of toModArithTensor.
+static Value fromModArithTensor(PatternRewriter &rewriter, Location loc,
+                                Value tensor, RankedTensorType nttType) {
+  auto storageType =
+      RankedTensorType::get(nttType.getShape(), nttType.getElementType());
+  auto storage =
+      rewriter.create<mod_arith::ExtractOp>(loc, storageType, tensor);
+  return rewriter.create<tensor::CastOp>(loc, nttType, storage);
+}
+
+/// Returns true if `op` is the only user of the result of `intt`, so that the
+/// INTT is dead once `op` is rewritten.
+static bool onlyUsedBy(INTTOp intt, Operation *op) {
+  return llvm::all_of(intt->getUsers(),
+                      [&](Operation *user) { return user == op; });
+}
+
+/// Rewrites op(intt(a), intt(b)) to intt(op'(a, b)), where op' is the
+/// pointwise mod_arith equivalent of the polynomial op `PolyOp`. This is valid
+/// for add and sub because the NTT is linear, and for mul because it maps ring
+/// multiplication to pointwise multiplication.
+///
+/// The rewrite only applies if it does not increase the number of INTTs, i.e.,
+/// if at least one of the operand INTTs has no other use.
+template <typename PolyOp, typename ModArithOp>
+struct HoistINTTThroughBinop : public OpRewritePattern<PolyOp> {
+  using OpRewritePattern<PolyOp>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(PolyOp op,
+                                PatternRewriter &rewriter) const override {
+    auto lhs = op.getLhs().template getDefiningOp<INTTOp>();
+    auto rhs = op.getRhs().template getDefiningOp<INTTOp>();
+    if (!lhs || !rhs) return failure();
+    if (lhs.getRoot() != rhs.getRoot() ||
+        lhs.getInput().getType() != rhs.getInput().getType())
+      return failure();
+    if (!onlyUsedBy(lhs, op) && !onlyUsedBy(rhs, op)) return failure();
+    auto polyType = dyn_cast<PolynomialType>(op.getType());
+    if (!polyType ||
+        !isa<mod_arith::ModArithType>(polyType.getRing().getCoefficientType()))
+      return failure();
+
+    Location loc = op.getLoc();
+    auto nttType = lhs.getInput().getType();
+    auto pointwise = rewriter.create<ModArithOp>(
+        loc, toModArithTensor(rewriter, loc, lhs.getInput()),
+        toModArithTensor(rewriter, loc, rhs.getInput()));
+    rewriter.replaceOpWithNewOp<INTTOp>(
+        op, polyType, fromModArithTensor(rewriter, loc, pointwise, nttType),
+        lhs.getRootAttr());
+    return success();
+  }
+};
+
+/// Rewrites mul_scalar(intt(a), s) to intt(a * splat(s)), which is valid
+/// because the NTT is linear.
+struct HoistINTTThroughMulScalar : public OpRewritePattern<MulScalarOp> {
+  using OpRewritePattern::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(MulScalarOp op,
+                                PatternRewriter &rewriter) const override {
+    auto intt = op.getPolynomial().getDefiningOp<INTTOp>();
+    if (!intt || !onlyUsedBy(intt, op)) return failure();
+    auto coeffType =
+        dyn_cast<mod_arith::ModArithType>(op.getScalar().getType());
+    if (!coeffType) return failure();
+
+    Location loc = op.getLoc();
+    RankedTensorType nttType = intt.getInput().getType();
+    // SplatOp only accepts integer/float inputs, so we can't splat a mod_arith
+    // directly.
+    auto storageType = RankedTensorType::get(nttType.getShape(),
+                                             coeffType.getModulus().getType());
+    auto scalar = rewriter.create<mod_arith::ExtractOp>(
+        loc, storageType.getElementType(), op.getScalar());
+    auto splat = rewriter.create<tensor::SplatOp>(loc, scalar, storageType);
+    auto scalarTensor = rewriter.create<mod_arith::EncapsulateOp>(
+        loc, RankedTensorType::get(nttType.getShape(), coeffType), splat);
+    auto pointwise = rewriter.create<mod_arith::MulOp>(
+        loc, toModArithTensor(rewriter, loc, intt.getInput()), scalarTensor);
+    rewriter.replaceOpWithNewOp<INTTOp>(
+        op, op.getType(),
+        fromModArithTensor(rewriter, loc, pointwise, nttType),
+        intt.getRootAttr());
+    return success();
+  }
+};
+
+struct PropagateNTTForm : impl::PropagateNTTFormBase<PropagateNTTForm> {
+  void runOnOperation() override {
+    MLIRContext *context = &getContext();
+    RewritePatternSet patterns(context);
+    patterns.add<rewrites::NTTRewritePolyMul,
+                 HoistINTTThroughBinop<AddOp, mod_arith::AddOp>,
+                 HoistINTTThroughBinop<SubOp, mod_arith::SubOp>,
+                 HoistINTTThroughBinop<MulOp, mod_arith::MulOp>,
+                 HoistINTTThroughMulScalar, FoldNTTOfConstant>(context);
+    // Cancels the ntt(intt(x)) pairs left behind by the hoisting.
+    NTTOp::getCanonicalizationPatterns(patterns, context);
+    INTTOp::getCanonicalizationPatterns(patterns, context);
     (void)applyPatternsAndFoldGreedily(getOperation(), std::move(patterns));
   }
 };
@@ -2,14 +2,16 @@
 #define LIB_DIALECT_POLYNOMIAL_TRANSFORMS_NTTREWRITES_H_
 
 #include "lib/Dialect/ModArith/IR/ModArithOps.h"
-#include "mlir/include/mlir/Dialect/Arith/IR/Arith.h"  // from @llvm-project
-#include "mlir/include/mlir/Pass/Pass.h"               // from @llvm-project
+#include "mlir/include/mlir/Dialect/Arith/IR/Arith.h"    // from @llvm-project
+#include "mlir/include/mlir/Dialect/Tensor/IR/Tensor.h"  // from @llvm-project
+#include "mlir/include/mlir/Pass/Pass.h"                 // from @llvm-project
 
 namespace mlir {
 namespace heir {
 namespace polynomial {
 
 #define GEN_PASS_DECL_POLYMULTONTT
+#define GEN_PASS_DECL_PROPAGATENTTFORM
 #include "lib/Dialect/Polynomial/Transforms/Passes.h.inc"
 
 }  // namespace polynomial
@@ -1 +1,71 @@
 #include "lib/Dialect/RNS/IR/RNSOps.h"
+
+#include "lib/Dialect/RNS/IR/RNSTypes.h"
+#include "llvm/include/llvm/ADT/ArrayRef.h"           // from @llvm-project
+#include "llvm/include/llvm/ADT/STLExtras.h"          // from @llvm-project
+#include "llvm/include/llvm/ADT/SmallVector.h"        // from @llvm-project
+#include "mlir/include/mlir/IR/OpDefinition.h"        // from @llvm-project
+#include "mlir/include/mlir/IR/TypeRange.h"           // from @llvm-project
+#include "mlir/include/mlir/Support/LLVM.h"           // from @llvm-project
+#include "mlir/include/mlir/Support/LogicalResult.h"  // from @llvm-project
+
+namespace mlir {
+namespace heir {
+namespace rns {
+
+static LogicalResult verifyLimbTypes(Operation *op, RNSType rnsType,
+                                     TypeRange limbTypes) {
+  if (!llvm::equal(rnsType.getBasisTypes(), limbTypes)) {
+    return op->emitOpError()
+           << "expected limb types to match the basis types of " << rnsType;
+  }
+  return success();
+}
+
+LogicalResult PackOp::verify() {
+  return verifyLimbTypes(*this, getOutput().getType(), getLimbs().getTypes());
+}
+
+LogicalResult UnpackOp::verify() {
+  return verifyLimbTypes(*this, getInput().getType(), getLimbs().getTypes());
+}
+
+LogicalResult ExtendBasisOp::verify() {
+  ArrayRef<Type> inputBasis = getInput().getType().getBasisTypes();
+  ArrayRef<Type> outputBasis = getOutput().getType().getBasisTypes();
+  if (outputBasis.size() <= inputBasis.size() ||
+      outputBasis.take_front(inputBasis.size()) != inputBasis) {
+    return emitOpError()
+           << "expected the output basis types to extend the input basis "
+              "types, but got "
+           << getInput().getType() << " and " << getOutput().getType();
+  }
+  return success();
+}
+
+LogicalResult RescaleOp::verify() {
+  ArrayRef<Type> inputBasis = getInput().getType().getBasisTypes();
+  ArrayRef<Type> outputBasis = getOutput().getType().getBasisTypes();
+  if (inputBasis.size() < 2 || outputBasis != inputBasis.drop_back()) {
+    return emitOpError()
+           << "expected the output basis types to be the input basis types "
+              "without the last one, but got "
+           << getInput().getType() << " and " << getOutput().getType();
+  }
+  if (getPlaintextModulus().has_value() && *getPlaintextModulus() < 2) {
+    return emitOpError() << "expected a plaintext modulus of at least 2";
+  }
+  return success();
+}
+
+LogicalResult UnpackOp::fold(FoldAdaptor adaptor,
+                             SmallVectorImpl<OpFoldResult> &results) {
+  auto pack = getInput().getDefiningOp<PackOp>();
+  if (!pack) return failure();
+  results.append(pack.getLimbs().begin(), pack.getLimbs().end());
+  return success();
+}
+
+}  // namespace rns
+}  // namespace heir
+}  // namespace mlir
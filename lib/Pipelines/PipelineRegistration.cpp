@@ -9,10 +9,14 @@
 #include "lib/Transforms/ConvertSecretWhileToStaticFor/ConvertSecretWhileToStaticFor.h"
 #include "lib/Transforms/ElementwiseToAffine/ElementwiseToAffine.h"
 #include "lib/Transforms/MemrefToArith/MemrefToArith.h"
+#include "lib/Transforms/SliceWritesToForall/SliceWritesToForall.h"
 #include "mlir/include/mlir/Conversion/AffineToStandard/AffineToStandard.h"  // from @llvm-project
 #include "mlir/include/mlir/Conversion/BufferizationToMemRef/BufferizationToMemRef.h"  // from @llvm-project
 #include "mlir/include/mlir/Conversion/ConvertToLLVM/ToLLVMPass.h"  // from @llvm-project
+#include "mlir/include/mlir/Conversion/OpenMPToLLVM/ConvertOpenMPToLLVM.h"  // from @llvm-project
+#include "mlir/include/mlir/Conversion/ReconcileUnrealizedCasts/ReconcileUnrealizedCasts.h"  // from @llvm-project
 #include "mlir/include/mlir/Conversion/SCFToControlFlow/SCFToControlFlow.h"  // from @llvm-project
+#include "mlir/include/mlir/Conversion/SCFToOpenMP/SCFToOpenMP.h"  // from @llvm-project
 #include "mlir/include/mlir/Conversion/TensorToLinalg/TensorToLinalgPass.h"  // from @llvm-project
 #include "mlir/include/mlir/Conversion/TosaToArith/TosaToArith.h"  // from @llvm-project
 #include "mlir/include/mlir/Conversion/TosaToLinalg/TosaToLinalg.h"  // from @llvm-project
@@ -24,6 +28,7 @@
 #include "mlir/include/mlir/Dialect/Func/IR/FuncOps.h"  // from @llvm-project
 #include "mlir/include/mlir/Dialect/Linalg/Passes.h"    // from @llvm-project
 #include "mlir/include/mlir/Dialect/MemRef/Transforms/Passes.h"  // from @llvm-project
+#include "mlir/include/mlir/Dialect/SCF/Transforms/Passes.h"  // from @llvm-project
 #include "mlir/include/mlir/Pass/PassManager.h"   // from @llvm-project
 #include "mlir/include/mlir/Pass/PassOptions.h"   // from @llvm-project
 #include "mlir/include/mlir/Pass/PassRegistry.h"  // from @llvm-project
@@ -90,7 +95,8 @@ void tosaPipelineBuilder(OpPassManager &manager) {
   manager.addPass(createSymbolDCEPass());
 }
 
-void polynomialToLLVMPipelineBuilder(OpPassManager &manager) {
+void polynomialToLLVMPipelineBuilder(
+    OpPassManager &manager, const PolynomialToLLVMPipelineOptions &options) {
   // Poly
   manager.addPass(createElementwiseToAffine());
   manager.addPass(::mlir::heir::polynomial::createPolynomialToModArith());
@@ -103,6 +109,11 @@ void polynomialToLLVMPipelineBuilder(OpPassManager &manager) {
   manager.addNestedPass<FuncOp>(affine::createAffineExpandIndexOpsPass());
   manager.addNestedPass<FuncOp>(affine::createSimplifyAffineStructuresPass());
   manager.addPass(createLowerAffinePass());
+  if (options.parallelize) {
+    // The loops over tensors of polynomials and the limbs of RNS values write
+    // disjoint slices, so they become scf.forall loops.
+    manager.addNestedPass<FuncOp>(createSliceWritesToForall());
+  }
   manager.addNestedPass<FuncOp>(memref::createExpandOpsPass());
   manager.addNestedPass<FuncOp>(memref::createExpandStridedMetadataPass());
 
@@ -111,7 +122,14 @@ void polynomialToLLVMPipelineBuilder(OpPassManager &manager) {
 
   // Linalg must be bufferized before it can be lowered
   // But lowering to loops also re-introduces affine.apply, so re-lower that
-  manager.addNestedPass<FuncOp>(createConvertLinalgToLoopsPass());
+  if (options.parallelize) {
+    manager.addNestedPass<FuncOp>(createForallToParallelLoopPass());
+    // The parallel iterators of linalg ops, such as the output coefficients of
+    // products and the elements of elementwise ops, become scf.parallel loops.
+    manager.addNestedPass<FuncOp>(createConvertLinalgToParallelLoopsPass());
+  } else {
+    manager.addNestedPass<FuncOp>(createConvertLinalgToLoopsPass());
+  }
   manager.addPass(createLowerAffinePass());
   manager.addPass(createBufferizationToMemRefPass());
 
@@ -122,10 +140,20 @@ void polynomialToLLVMPipelineBuilder(OpPassManager &manager) {
   manager.addPass(createSymbolDCEPass());
 
   // ToLLVM
+  if (options.parallelize) {
+    // Fuse adjacent parallel loops, such as consecutive elementwise ops, so
+    // that each OpenMP region does more work per thread.
+    manager.addNestedPass<FuncOp>(createParallelLoopFusionPass());
+    manager.addPass(createConvertSCFToOpenMPPass());
+  }
   manager.addPass(arith::createArithExpandOpsPass());
   manager.addPass(createConvertSCFToCFPass());
   manager.addNestedPass<FuncOp>(memref::createExpandStridedMetadataPass());
   manager.addPass(createConvertToLLVMPass());
+  if (options.parallelize) {
+    manager.addPass(createConvertOpenMPToLLVMPass());
+    manager.addPass(createReconcileUnrealizedCastsPass());
+  }
 
   // Cleanup
   manager.addPass(createCanonicalizerPass());
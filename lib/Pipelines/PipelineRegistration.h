@@ -13,7 +13,19 @@ void oneShotBufferize(OpPassManager &manager);
 
 void tosaPipelineBuilder(OpPassManager &manager);
 
-void polynomialToLLVMPipelineBuilder(OpPassManager &manager);
+struct PolynomialToLLVMPipelineOptions
+    : public PassPipelineOptions<PolynomialToLLVMPipelineOptions> {
+  PassOptions::Option<bool> parallelize{
+      *this, "parallelize",
+      llvm::cl::desc("Lower the parallel iterators of the linalg ops in "
+                     "polynomial kernels, the loops over tensors of "
+                     "polynomials and the limbs of RNS values to OpenMP "
+                     "worksharing loops."),
+      llvm::cl::init(false)};
+};
+
+void polynomialToLLVMPipelineBuilder(
+    OpPassManager &manager, const PolynomialToLLVMPipelineOptions &options);
 
 void basicMLIRToLLVMPipelineBuilder(OpPassManager &manager);
 
@@ -9,18 +9,22 @@
 
 #include "lib/Analysis/SelectVariableNames/SelectVariableNames.h"
 #include "lib/Dialect/LWE/IR/LWEOps.h"
+#include "lib/Dialect/Openfhe/IR/OpenfheDialect.h"
 #include "lib/Dialect/Openfhe/IR/OpenfheOps.h"
 #include "lib/Target/OpenFhePke/OpenFheUtils.h"
+#include "lib/Utils/Graph/Graph.h"
 #include "lib/Utils/TargetUtils/TargetUtils.h"
 #include "llvm/include/llvm/ADT/STLExtras.h"             // from @llvm-project
 #include "llvm/include/llvm/ADT/SmallVector.h"           // from @llvm-project
 #include "llvm/include/llvm/ADT/StringExtras.h"          // from @llvm-project
 #include "llvm/include/llvm/ADT/TypeSwitch.h"            // from @llvm-project
+#include "llvm/include/llvm/Support/ErrorHandling.h"     // from @llvm-project
 #include "llvm/include/llvm/Support/FormatVariadic.h"    // from @llvm-project
 #include "llvm/include/llvm/Support/raw_ostream.h"       // from @llvm-project
 #include "mlir/include/mlir/Dialect/Arith/IR/Arith.h"    // from @llvm-project
 #include "mlir/include/mlir/Dialect/Func/IR/FuncOps.h"   // from @llvm-project
 #include "mlir/include/mlir/Dialect/Tensor/IR/Tensor.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/Block.h"                  // from @llvm-project
 #include "mlir/include/mlir/IR/BuiltinAttributes.h"      // from @llvm-project
 #include "mlir/include/mlir/IR/BuiltinOps.h"             // from @llvm-project
 #include "mlir/include/mlir/IR/Diagnostics.h"            // from @llvm-project
@@ -62,12 +66,22 @@ FailureOr<std::string> getStringForConstant(Value value) {
   return failure();
 }
 
+// Returns true if `op` is a ciphertext operation that may run in parallel with
+// the other ciphertext operations it does not depend on.
+bool isParallelizableOp(Operation *op) {
+  return isa<AddOp, AddPlainOp, SubOp, MulNoRelinOp, MulOp, MulPlainOp,
+             MulConstOp, NegateOp, SquareOp, RelinOp, ModReduceOp,
+             LevelReduceOp, RotOp, FastRotationPrecomputeOp, FastRotationOp,
+             AutomorphOp, KeySwitchOp>(op);
+}
+
 }  // namespace
 
 LogicalResult translateToOpenFhePke(Operation *op, llvm::raw_ostream &os,
-                                    const OpenfheScheme &scheme) {
+                                    const OpenfheScheme &scheme, bool parallel,
+                                    int numThreads) {
   SelectVariableNames variableNames(op);
-  OpenFhePkeEmitter emitter(os, &variableNames, scheme);
+  OpenFhePkeEmitter emitter(os, &variableNames, scheme, parallel, numThreads);
   LogicalResult result = emitter.translate(*op);
   return result;
 }
@@ -92,9 +106,10 @@ LogicalResult OpenFhePkeEmitter::translate(Operation &op) {
           // OpenFHE ops
           .Case<AddOp, AddPlainOp, SubOp, MulNoRelinOp, MulOp, MulPlainOp,
                 SquareOp, NegateOp, MulConstOp, RelinOp, ModReduceOp,
-                LevelReduceOp, RotOp, AutomorphOp, KeySwitchOp, EncryptOp,
-                DecryptOp, GenParamsOp, GenContextOp, GenMulKeyOp, GenRotKeyOp,
-                MakePackedPlaintextOp, MakeCKKSPackedPlaintextOp>(
+                LevelReduceOp, RotOp, FastRotationPrecomputeOp, FastRotationOp,
+                AutomorphOp, KeySwitchOp, EncryptOp, DecryptOp, GenParamsOp,
+                GenContextOp, GenMulKeyOp, GenRotKeyOp, MakePackedPlaintextOp,
+                MakeCKKSPackedPlaintextOp, ReleaseOp>(
               [&](auto op) { return printOperation(op); })
           .Default([&](Operation &) {
             return emitError(op.getLoc(), "unable to find printer for op");
@@ -156,10 +171,8 @@ LogicalResult OpenFhePkeEmitter::printOperation(func::FuncOp funcOp) {
   os.indent();
 
   for (Block &block : funcOp.getBlocks()) {
-    for (Operation &op : block.getOperations()) {
-      if (failed(translate(op))) {
-        return failure();
-      }
+    if (failed(translateBlock(block))) {
+      return failure();
     }
   }
 
@@ -168,6 +181,101 @@ LogicalResult OpenFhePkeEmitter::printOperation(func::FuncOp funcOp) {
   return success();
 }
 
+LogicalResult OpenFhePkeEmitter::translateBlock(Block &block) {
+  auto it = block.begin();
+  while (it != block.end()) {
+    if (!parallel_ || !isParallelizableOp(&*it)) {
+      if (failed(translate(*it))) {
+        return failure();
+      }
+      ++it;
+      continue;
+    }
+
+    // Compute the dependency graph of the maximal run of ciphertext
+    // operations starting at `it`. Releases of ciphertexts within the run are
+    // deferred to its end, so that they neither split the run nor race with
+    // the parallel sections.
+    graph::Graph<Operation *> graph;
+    SmallVector<Operation *> releases;
+    for (; it != block.end() &&
+           (isParallelizableOp(&*it) || isa<ReleaseOp>(&*it));
+         ++it) {
+      Operation *op = &*it;
+      if (isa<ReleaseOp>(op)) {
+        releases.push_back(op);
+        continue;
+      }
+      graph.addVertex(op);
+      for (Value operand : op->getOperands()) {
+        Operation *definingOp = operand.getDefiningOp();
+        if (definingOp && graph.contains(definingOp)) {
+          graph.addEdge(definingOp, op);
+        }
+      }
+    }
+    if (failed(emitLevels(graph))) {
+      return failure();
+    }
+    for (Operation *op : releases) {
+      if (failed(translate(*op))) {
+        return failure();
+      }
+    }
+  }
+  return success();
+}
+
+LogicalResult OpenFhePkeEmitter::emitLevels(graph::Graph<Operation *> &graph) {
+  auto sortedGraph = graph.sortGraphByLevels();
+  if (failed(sortedGraph)) {
+    llvm_unreachable("Only possible failure is a cycle in the SSA graph!");
+  }
+
+  for (auto &level : sortedGraph.value()) {
+    // Emit the ops of a level in program order for deterministic output.
+    llvm::sort(level, [](Operation *a, Operation *b) {
+      return a->isBeforeInBlock(b);
+    });
+    if (level.size() == 1) {
+      if (failed(translate(*level.front()))) {
+        return failure();
+      }
+      continue;
+    }
+
+    // The results are declared outside of the parallel section so that they
+    // remain in scope after it.
+    for (Operation *op : level) {
+      Value result = op->getResult(0);
+      if (failed(emitType(result.getType()))) {
+        return failure();
+      }
+      os << " " << variableNames->getNameForValue(result) << ";\n";
+      predeclaredValues_.insert(result);
+    }
+
+    os << "#pragma omp parallel sections";
+    if (numThreads_ > 0) {
+      os << " num_threads(" << numThreads_ << ")";
+    }
+    os << "\n{\n";
+    os.indent();
+    for (Operation *op : level) {
+      os << "#pragma omp section\n{\n";
+      os.indent();
+      if (failed(translate(*op))) {
+        return failure();
+      }
+      os.unindent();
+      os << "}\n";
+    }
+    os.unindent();
+    os << "}\n";
+  }
+  return success();
+}
+
 LogicalResult OpenFhePkeEmitter::printOperation(func::ReturnOp op) {
   if (op.getNumOperands() != 1) {
     return emitError(op.getLoc(), "Only one return value supported");
@@ -178,6 +286,18 @@ LogicalResult OpenFhePkeEmitter::printOperation(func::ReturnOp op) {
 }
 
 void OpenFhePkeEmitter::emitAutoAssignPrefix(Value result) {
+  if (predeclaredValues_.contains(result)) {
+    os << variableNames->getNameForValue(result) << " = ";
+    return;
+  }
+  // A ciphertext that is released after its last use needs a variable that
+  // owns its reference.
+  if (llvm::any_of(result.getUsers(),
+                   [](Operation *user) { return isa<ReleaseOp>(user); })) {
+    os << convertType(result.getType()).value() << " "
+       << variableNames->getNameForValue(result) << " = ";
+    return;
+  }
   // Use const auto& because most OpenFHE API methods would perform a copy
   // if using a plain `auto`.
   os << "const auto& " << variableNames->getNameForValue(result) << " = ";
@@ -280,6 +400,26 @@ LogicalResult OpenFhePkeEmitter::printOperation(RotOp op) {
   return success();
 }
 
+LogicalResult OpenFhePkeEmitter::printOperation(FastRotationPrecomputeOp op) {
+  return printEvalMethod(op.getResult(), op.getCryptoContext(),
+                         {op.getCiphertext()}, "EvalFastRotationPrecompute");
+}
+
+LogicalResult OpenFhePkeEmitter::printOperation(FastRotationOp op) {
+  // EvalFastRotation also takes the cyclotomic order m = 2N of the ring, which
+  // OpenFHE uses to map the rotation index to an automorphism.
+  emitAutoAssignPrefix(op.getResult());
+
+  std::string contextName =
+      variableNames->getNameForValue(op.getCryptoContext());
+  os << contextName << "->EvalFastRotation("
+     << variableNames->getNameForValue(op.getCiphertext()) << ", "
+     << op.getIndex().getValue() << ", " << contextName
+     << "->GetCyclotomicOrder(), "
+     << variableNames->getNameForValue(op.getPrecomputed()) << ");\n";
+  return success();
+}
+
 LogicalResult OpenFhePkeEmitter::printOperation(AutomorphOp op) {
   // EvalAutomorphism has a bit of a strange function signature in OpenFHE:
   //
@@ -509,14 +649,8 @@ LogicalResult OpenFhePkeEmitter::printOperation(
 
 LogicalResult OpenFhePkeEmitter::printOperation(
     openfhe::MakePackedPlaintextOp op) {
-  std::string inputVarName = variableNames->getNameForValue(op.getValue());
-
-  emitAutoAssignPrefix(op.getResult());
-  FailureOr<Value> resultCC = getContextualCryptoContext(op.getOperation());
-  if (failed(resultCC)) return resultCC;
-  os << variableNames->getNameForValue(resultCC.value())
-     << "->MakePackedPlaintext(" << inputVarName << ");\n";
-  return success();
+  return printPlaintextEncoding(op.getOperation(), op.getValue(),
+                                op.getResult(), "MakePackedPlaintext");
 }
 
 LogicalResult OpenFhePkeEmitter::printOperation(
@@ -526,13 +660,62 @@ LogicalResult OpenFhePkeEmitter::printOperation(
                      "encoding CKKS plaintext not supported by chosen scheme");
   }
 
-  std::string inputVarName = variableNames->getNameForValue(op.getValue());
+  return printPlaintextEncoding(op.getOperation(), op.getValue(),
+                                op.getResult(), "MakeCKKSPackedPlaintext");
+}
 
-  emitAutoAssignPrefix(op.getResult());
-  FailureOr<Value> resultCC = getContextualCryptoContext(op.getOperation());
+LogicalResult OpenFhePkeEmitter::printPlaintextEncoding(
+    Operation *op, Value cleartexts, Value result, std::string_view method) {
+  std::string inputVarName = variableNames->getNameForValue(cleartexts);
+  FailureOr<Value> resultCC = getContextualCryptoContext(op);
   if (failed(resultCC)) return resultCC;
-  os << variableNames->getNameForValue(resultCC.value())
-     << "->MakeCKKSPackedPlaintext(" << inputVarName << ");\n";
+  std::string contextName = variableNames->getNameForValue(resultCC.value());
+
+  if (!op->hasAttr(kCachedPlaintextAttrName)) {
+    emitAutoAssignPrefix(result);
+    os << contextName << "->" << method << "(" << inputVarName << ");\n";
+    return success();
+  }
+
+  // The plaintext only depends on the crypto context, so it is encoded on the
+  // first call with each crypto context and copied from a static cache on
+  // later calls. The cache is keyed by the address of the crypto context and
+  // only holds a weak reference to it, so it does not keep the context alive.
+  // An entry whose context was destroyed is never hit, even if a new context
+  // reuses its address, and such entries are dropped on the next miss. The
+  // mutex guards the cache against concurrent calls.
+  std::string resultName = variableNames->getNameForValue(result);
+  std::string cacheName = resultName + "_cache";
+  std::string mutexName = resultName + "_mutex";
+  os << "static std::map<const void*, std::pair<std::weak_ptr<const void>, "
+        "PlaintextT>> "
+     << cacheName << ";\n";
+  os << "static std::mutex " << mutexName << ";\n";
+  os << "PlaintextT " << resultName << ";\n";
+  os << "{\n";
+  os.indent();
+  os << "std::lock_guard<std::mutex> lock(" << mutexName << ");\n";
+  os << "auto cached = " << cacheName << ".find(" << contextName
+     << ".get());\n";
+  os << "if (cached == " << cacheName << ".end() || "
+     << "cached->second.first.expired()) {\n";
+  os.indent();
+  os << "for (auto entry = " << cacheName << ".begin(); entry != " << cacheName
+     << ".end();) {\n";
+  os.indent();
+  os << "entry = entry->second.first.expired() ? " << cacheName
+     << ".erase(entry) : std::next(entry);\n";
+  os.unindent();
+  os << "}\n";
+  os << "cached = " << cacheName << ".insert_or_assign(" << contextName
+     << ".get(), std::make_pair(std::weak_ptr<const void>(" << contextName
+     << "), " << contextName << "->" << method << "(" << inputVarName
+     << "))).first;\n";
+  os.unindent();
+  os << "}\n";
+  os << resultName << " = cached->second.second;\n";
+  os.unindent();
+  os << "}\n";
   return success();
 }
 
@@ -601,6 +784,19 @@ LogicalResult OpenFhePkeEmitter::printOperation(GenParamsOp op) {
   os << "CCParamsT " << paramsName << ";\n";
   os << paramsName << ".SetMultiplicativeDepth(" << mulDepth << ");\n";
   os << paramsName << ".SetPlaintextModulus(" << plainMod << ");\n";
+  if (op.getRingDim() != 0)
+    os << paramsName << ".SetRingDim(" << op.getRingDim() << ");\n";
+  if (op.getFirstModSize() != 0)
+    os << paramsName << ".SetFirstModSize(" << op.getFirstModSize() << ");\n";
+  if (op.getScalingModSize() != 0) {
+    os << paramsName << ".SetScalingModSize(" << op.getScalingModSize()
+       << ");\n";
+  }
+  return success();
+}
+
+LogicalResult OpenFhePkeEmitter::printOperation(ReleaseOp op) {
+  os << variableNames->getNameForValue(op.getCiphertext()) << ".reset();\n";
   return success();
 }
 
@@ -648,8 +844,13 @@ LogicalResult OpenFhePkeEmitter::emitType(Type type) {
 
 OpenFhePkeEmitter::OpenFhePkeEmitter(raw_ostream &os,
                                      SelectVariableNames *variableNames,
-                                     const OpenfheScheme &scheme)
-    : scheme_(scheme), os(os), variableNames(variableNames) {}
+                                     const OpenfheScheme &scheme,
+                                     bool parallel, int numThreads)
+    : scheme_(scheme),
+      parallel_(parallel),
+      numThreads_(numThreads),
+      os(os),
+      variableNames(variableNames) {}
 }  // namespace openfhe
 }  // namespace heir
 }  // namespace mlir
@@ -7,10 +7,13 @@
 #include "lib/Dialect/LWE/IR/LWEOps.h"
 #include "lib/Dialect/Openfhe/IR/OpenfheOps.h"
 #include "lib/Target/OpenFhePke/OpenFheUtils.h"
+#include "lib/Utils/Graph/Graph.h"
+#include "llvm/include/llvm/ADT/DenseSet.h"              // from @llvm-project
 #include "llvm/include/llvm/Support/raw_ostream.h"       // from @llvm-project
 #include "mlir/include/mlir/Dialect/Arith/IR/Arith.h"    // from @llvm-project
 #include "mlir/include/mlir/Dialect/Func/IR/FuncOps.h"   // from @llvm-project
 #include "mlir/include/mlir/Dialect/Tensor/IR/Tensor.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/Block.h"                  // from @llvm-project
 #include "mlir/include/mlir/IR/BuiltinOps.h"             // from @llvm-project
 #include "mlir/include/mlir/IR/Operation.h"              // from @llvm-project
 #include "mlir/include/mlir/IR/Types.h"                  // from @llvm-project
@@ -24,15 +27,20 @@ namespace mlir {
 namespace heir {
 namespace openfhe {
 
-/// Translates the given operation to OpenFhePke.
+/// Translates the given operation to OpenFhePke. If `parallel` is set,
+/// independent ciphertext operations are emitted in OpenMP parallel sections
+/// with `numThreads` threads, or the OpenMP default if `numThreads` is zero.
 ::mlir::LogicalResult translateToOpenFhePke(::mlir::Operation *op,
                                             llvm::raw_ostream &os,
-                                            const OpenfheScheme &scheme);
+                                            const OpenfheScheme &scheme,
+                                            bool parallel = false,
+                                            int numThreads = 0);
 
 class OpenFhePkeEmitter {
  public:
   OpenFhePkeEmitter(raw_ostream &os, SelectVariableNames *variableNames,
-                    const OpenfheScheme &scheme);
+                    const OpenfheScheme &scheme, bool parallel = false,
+                    int numThreads = 0);
 
   LogicalResult translate(::mlir::Operation &operation);
 
@@ -40,6 +48,17 @@ class OpenFhePkeEmitter {
   /// OpenFHE scheme to emit.
   OpenfheScheme scheme_;
 
+  /// Whether to emit independent ciphertext operations in parallel sections.
+  bool parallel_;
+
+  /// The number of threads of the parallel sections, or zero for the OpenMP
+  /// default.
+  int numThreads_;
+
+  /// Values declared ahead of the parallel section computing them, which are
+  /// assigned to instead of declared by their defining op.
+  DenseSet<Value> predeclaredValues_;
+
   /// Output stream to emit to.
   raw_indented_ostream os;
 
@@ -47,6 +66,14 @@ class OpenFhePkeEmitter {
   /// values.
   SelectVariableNames *variableNames;
 
+  // Translates the ops of a block, grouping independent ciphertext
+  // operations in parallel sections if parallel_ is set.
+  LogicalResult translateBlock(::mlir::Block &block);
+
+  // Emits the ops of `graph`, which are consecutive ciphertext operations of a
+  // block, level by level, with the ops of each level in a parallel section.
+  LogicalResult emitLevels(graph::Graph<::mlir::Operation *> &graph);
+
   // Functions for printing individual ops
   LogicalResult printOperation(::mlir::ModuleOp op);
   LogicalResult printOperation(::mlir::arith::ConstantOp op);
@@ -67,6 +94,8 @@ class OpenFhePkeEmitter {
   LogicalResult printOperation(AutomorphOp op);
   LogicalResult printOperation(DecryptOp op);
   LogicalResult printOperation(EncryptOp op);
+  LogicalResult printOperation(FastRotationOp op);
+  LogicalResult printOperation(FastRotationPrecomputeOp op);
   LogicalResult printOperation(GenParamsOp op);
   LogicalResult printOperation(GenContextOp op);
   LogicalResult printOperation(GenMulKeyOp op);
@@ -82,6 +111,7 @@ class OpenFhePkeEmitter {
   LogicalResult printOperation(MulPlainOp op);
   LogicalResult printOperation(NegateOp op);
   LogicalResult printOperation(RelinOp op);
+  LogicalResult printOperation(ReleaseOp op);
   LogicalResult printOperation(RotOp op);
   LogicalResult printOperation(SquareOp op);
   LogicalResult printOperation(SubOp op);
@@ -92,6 +122,14 @@ class OpenFhePkeEmitter {
                                 ::mlir::ValueRange nonEvalOperands,
                                 std::string_view op);
 
+  // Emits the encoding of `cleartexts` into the plaintext `result` of `op`
+  // with the crypto context method `method`, cached per crypto context if
+  // `op` is marked with kCachedPlaintextAttrName.
+  LogicalResult printPlaintextEncoding(::mlir::Operation *op,
+                                       ::mlir::Value cleartexts,
+                                       ::mlir::Value result,
+                                       std::string_view method);
+
   // Emit an OpenFhe type
   LogicalResult emitType(Type type);
 
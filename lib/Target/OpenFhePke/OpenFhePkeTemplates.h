@@ -12,12 +12,18 @@ namespace openfhe {
 
 // clang-format off
 constexpr std::string_view kModulePreludeTemplate = R"cpp(
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
 #include "src/pke/include/openfhe.h" // from @openfhe
 
 using namespace lbcrypto;
 using CiphertextT = ConstCiphertext<DCRTPoly>;
 using CCParamsT = CCParams<CryptoContext{0}RNS>;
 using CryptoContextT = CryptoContext<DCRTPoly>;
+using DigitDecompT = std::shared_ptr<std::vector<DCRTPoly>>;
 using EvalKeyT = EvalKey<DCRTPoly>;
 using PlaintextT = Plaintext;
 using PrivateKeyT = PrivateKey<DCRTPoly>;
@@ -31,6 +31,17 @@ struct TranslateOptions {
                                   "bgv", "Emit with OpenFHE BGV scheme"),
                        clEnumValN(mlir::heir::openfhe::OpenfheScheme::CKKS,
                                   "ckks", "Emit with OpenFHE CKKS scheme"))};
+  llvm::cl::opt<bool> parallel{
+      "openfhe-parallel",
+      llvm::cl::desc("Emit independent ciphertext operations in OpenMP "
+                     "parallel sections"),
+      llvm::cl::init(false)};
+  llvm::cl::opt<int> numThreads{
+      "openfhe-num-threads",
+      llvm::cl::desc("The number of threads of the OpenMP parallel sections "
+                     "emitted with --openfhe-parallel, or 0 for the OpenMP "
+                     "default"),
+      llvm::cl::init(0)};
 };
 static llvm::ManagedStatic<TranslateOptions> options;
 
@@ -44,7 +55,8 @@ void registerToOpenFhePkeTranslation() {
       "emit-openfhe-pke",
       "translate the openfhe dialect to C++ code against the OpenFHE pke API",
       [](Operation *op, llvm::raw_ostream &output) {
-        return translateToOpenFhePke(op, output, options->openfheScheme);
+        return translateToOpenFhePke(op, output, options->openfheScheme,
+                                     options->parallel, options->numThreads);
       },
       [](DialectRegistry &registry) {
         registry.insert<arith::ArithDialect, func::FuncDialect,
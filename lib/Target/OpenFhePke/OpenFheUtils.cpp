@@ -35,6 +35,8 @@ FailureOr<std::string> convertType(Type type) {
           [&](auto ty) { return std::string("CiphertextT"); })
       .Case<lwe::RLWEPlaintextType>(
           [&](auto ty) { return std::string("Plaintext"); })
+      .Case<openfhe::DigitDecompType>(
+          [&](auto ty) { return std::string("DigitDecompT"); })
       .Case<openfhe::EvalKeyType>(
           [&](auto ty) { return std::string("EvalKeyT"); })
       .Case<openfhe::PrivateKeyType>(
@@ -0,0 +1,433 @@
+#include "lib/Transforms/ManageLevels/ManageLevels.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+#include "lib/Analysis/MulDepthAnalysis/MulDepthAnalysis.h"
+#include "lib/Dialect/BGV/IR/BGVDialect.h"
+#include "lib/Dialect/BGV/IR/BGVOps.h"
+#include "lib/Dialect/CKKS/IR/CKKSDialect.h"
+#include "lib/Dialect/CKKS/IR/CKKSOps.h"
+#include "lib/Dialect/LWE/IR/LWEAttributes.h"
+#include "lib/Dialect/LWE/IR/LWEDialect.h"
+#include "lib/Dialect/LWE/IR/LWEOps.h"
+#include "lib/Dialect/LWE/IR/LWETypes.h"
+#include "lib/Dialect/ModArith/IR/ModArithTypes.h"
+#include "lib/Dialect/Polynomial/IR/PolynomialAttributes.h"
+#include "llvm/include/llvm/ADT/APInt.h"                   // from @llvm-project
+#include "llvm/include/llvm/ADT/DenseMap.h"                // from @llvm-project
+#include "llvm/include/llvm/ADT/DenseSet.h"                // from @llvm-project
+#include "llvm/include/llvm/ADT/STLExtras.h"               // from @llvm-project
+#include "llvm/include/llvm/ADT/SmallVector.h"             // from @llvm-project
+#include "mlir/include/mlir/Analysis/DataFlow/ConstantPropagationAnalysis.h"  // from @llvm-project
+#include "mlir/include/mlir/Analysis/DataFlow/DeadCodeAnalysis.h"  // from @llvm-project
+#include "mlir/include/mlir/Analysis/DataFlowFramework.h"  // from @llvm-project
+#include "mlir/include/mlir/Dialect/Func/IR/FuncOps.h"     // from @llvm-project
+#include "mlir/include/mlir/IR/Builders.h"                 // from @llvm-project
+#include "mlir/include/mlir/IR/BuiltinAttributes.h"        // from @llvm-project
+#include "mlir/include/mlir/IR/BuiltinTypes.h"             // from @llvm-project
+#include "mlir/include/mlir/IR/MLIRContext.h"              // from @llvm-project
+#include "mlir/include/mlir/IR/SymbolTable.h"              // from @llvm-project
+#include "mlir/include/mlir/IR/Value.h"                    // from @llvm-project
+#include "mlir/include/mlir/Support/LLVM.h"                // from @llvm-project
+
+namespace mlir {
+namespace heir {
+
+#define GEN_PASS_DEF_MANAGELEVELS
+#include "lib/Transforms/ManageLevels/ManageLevels.h.inc"
+
+namespace {
+
+// Returns the rings of the levels of the modulus chain `moduli`, where the
+// ring of level i has the product of the first i + 1 moduli as its
+// coefficient modulus, or failure if the coefficient modulus of `topRing` is
+// not the product of all moduli.
+FailureOr<SmallVector<polynomial::RingAttr>> getLevelRings(
+    polynomial::RingAttr topRing, ArrayRef<uint64_t> moduli) {
+  auto coeffType =
+      dyn_cast<mod_arith::ModArithType>(topRing.getCoefficientType());
+  if (!coeffType) return failure();
+  IntegerAttr topModulus = coeffType.getModulus();
+  unsigned width = topModulus.getValue().getBitWidth();
+
+  SmallVector<polynomial::RingAttr> rings;
+  APInt product(width, 1);
+  for (uint64_t modulus : moduli) {
+    if (APInt(64, modulus).getActiveBits() > width) return failure();
+    bool overflow = false;
+    product = product.umul_ov(APInt(width, modulus), overflow);
+    if (overflow) return failure();
+    auto levelCoeffType = mod_arith::ModArithType::get(
+        topRing.getContext(), IntegerAttr::get(topModulus.getType(), product));
+    rings.push_back(polynomial::RingAttr::get(
+        levelCoeffType, topRing.getPolynomialModulus()));
+  }
+  if (product != topModulus.getValue()) return failure();
+  return rings;
+}
+
+bool isMultiplication(Operation *op) {
+  return isa<bgv::MulOp, bgv::MulPlainOp, ckks::MulOp, ckks::MulPlainOp>(op);
+}
+
+bool isRelinearization(Operation *op) {
+  return isa<bgv::RelinearizeOp, ckks::RelinearizeOp>(op);
+}
+
+bool isLevelSwitch(Operation *op) {
+  return isa<bgv::ModulusSwitchOp, ckks::RescaleOp, ckks::LevelReduceOp>(op);
+}
+
+lwe::RLWECiphertextType getCiphertextTypeWithRing(lwe::RLWECiphertextType type,
+                                                  polynomial::RingAttr ring) {
+  MLIRContext *ctx = type.getContext();
+  return lwe::RLWECiphertextType::get(
+      ctx, type.getEncoding(),
+      lwe::RLWEParamsAttr::get(ctx, type.getRlweParams().getDimension(), ring),
+      type.getUnderlyingType());
+}
+
+// The results of the functions whose levels are managed that are products
+// whose modulus has not been switched yet, as pairs of the function and the
+// result number.
+using PendingResults = DenseSet<std::pair<Operation *, unsigned>>;
+
+// Inserts the level switches of a single function.
+class LevelManager {
+ public:
+  LevelManager(ArrayRef<polynomial::RingAttr> rings, bool eager, bool ckks,
+               PendingResults &pendingResults)
+      : rings(rings), eager(eager), ckks(ckks), pendingResults(pendingResults) {
+    for (const auto &[level, ring] : llvm::enumerate(rings))
+      levelOfRing[ring] = level;
+  }
+
+  LogicalResult run(func::FuncOp funcOp) {
+    SmallVector<Operation *> ops;
+    for (Operation &op : funcOp.getBody().getOps()) ops.push_back(&op);
+    for (Operation *op : ops) {
+      if (isa<func::ReturnOp>(op) || isLevelSwitch(op)) continue;
+      if (failed(processOp(op))) return failure();
+    }
+
+    // The results may now be at lower levels than declared by the function.
+    // The calls of the function are updated when their callers are managed,
+    // which happens after the function itself.
+    auto returnOp = dyn_cast<func::ReturnOp>(funcOp.getBody().back().back());
+    if (!returnOp) return success();
+    funcOp.setFunctionType(FunctionType::get(funcOp.getContext(),
+                                             funcOp.getArgumentTypes(),
+                                             returnOp.getOperandTypes()));
+    for (OpOperand &operand : returnOp->getOpOperands()) {
+      if (pending.contains(operand.get()))
+        pendingResults.insert({funcOp, operand.getOperandNumber()});
+    }
+    return success();
+  }
+
+ private:
+  // Returns the level of a ciphertext type, or -1 if its ring is not in the
+  // modulus chain.
+  int getLevel(Type type) {
+    auto ciphertextType = dyn_cast<lwe::RLWECiphertextType>(type);
+    if (!ciphertextType) return -1;
+    auto it = levelOfRing.find(ciphertextType.getRlweParams().getRing());
+    return it == levelOfRing.end() ? -1 : it->second;
+  }
+
+  int getLevel(Value value) { return getLevel(value.getType()); }
+
+  // Returns `value` switched down to `level`, one modulus at a time. The
+  // switches are inserted right after the definition of `value` and shared
+  // by all ops that need `value` at the same level.
+  //
+  // In CKKS, only the first switch of a pending product is a rescale, which
+  // divides out the extra scale of the product. All other switches drop
+  // moduli with level reductions, which keep the scale of the message.
+  Value switchToLevel(Value value, int level) {
+    int fromLevel = getLevel(value);
+    if (fromLevel <= level) return value;
+    auto cached = switchedValues.find({value, level});
+    if (cached != switchedValues.end()) return cached->second;
+
+    Value previous = switchToLevel(value, level + 1);
+    OpBuilder b(value.getContext());
+    b.setInsertionPointAfterValue(previous);
+    polynomial::RingAttr ring = rings[level];
+    Type resultType = getCiphertextTypeWithRing(
+        cast<lwe::RLWECiphertextType>(previous.getType()), ring);
+    Value switched;
+    if (!ckks) {
+      switched = b.create<bgv::ModulusSwitchOp>(previous.getLoc(), resultType,
+                                                previous, ring);
+    } else if (previous == value && pending.contains(value)) {
+      switched = b.create<ckks::RescaleOp>(previous.getLoc(), resultType,
+                                           previous, ring);
+    } else {
+      switched = b.create<ckks::LevelReduceOp>(previous.getLoc(), resultType,
+                                               previous, ring);
+    }
+    switchedValues[{value, level}] = switched;
+    return switched;
+  }
+
+  // Returns the plaintext `value` encoded in the ring of `level`.
+  FailureOr<Value> encodeAtLevel(Value value, int level) {
+    auto type = cast<lwe::RLWEPlaintextType>(value.getType());
+    polynomial::RingAttr ring = rings[level];
+    if (type.getRing() == ring) return value;
+    auto cached = switchedValues.find({value, level});
+    if (cached != switchedValues.end()) return cached->second;
+
+    auto encodeOp = value.getDefiningOp<lwe::RLWEEncodeOp>();
+    if (!encodeOp) return failure();
+    OpBuilder b(encodeOp);
+    b.setInsertionPointAfter(encodeOp);
+    auto resultType = lwe::RLWEPlaintextType::get(
+        value.getContext(), type.getEncoding(), ring, type.getUnderlyingType());
+    Value encoded = b.create<lwe::RLWEEncodeOp>(
+        encodeOp.getLoc(), resultType, encodeOp.getInput(),
+        encodeOp.getEncoding(), ring);
+    switchedValues[{value, level}] = encoded;
+    return encoded;
+  }
+
+  // Switches the ciphertext operands of a call down to the levels of the
+  // arguments of the callee, and gives its results the types of the results
+  // of the callee, which has been managed before.
+  LogicalResult processCall(func::CallOp callOp) {
+    auto callee = SymbolTable::lookupNearestSymbolFrom<func::FuncOp>(
+        callOp, callOp.getCalleeAttr());
+    if (!callee) return success();
+    for (auto [operand, argType] :
+         llvm::zip(callOp->getOpOperands(), callee.getArgumentTypes())) {
+      int argLevel = getLevel(argType);
+      if (argLevel < 0 || getLevel(operand.get()) < 0) continue;
+      if (getLevel(operand.get()) < argLevel) {
+        return callOp.emitError()
+               << "operand " << operand.getOperandNumber()
+               << " is at a lower level than the argument of the callee";
+      }
+      operand.set(switchToLevel(operand.get(), argLevel));
+    }
+    for (auto [result, resultType] :
+         llvm::zip(callOp->getResults(), callee.getResultTypes())) {
+      result.setType(resultType);
+      if (pendingResults.contains({callee, result.getResultNumber()}))
+        pending.insert(result);
+    }
+    return success();
+  }
+
+  LogicalResult processOp(Operation *op) {
+    if (auto callOp = dyn_cast<func::CallOp>(op)) return processCall(callOp);
+
+    bool multiplication = isMultiplication(op);
+
+    // In CKKS, pending products have a larger scale than the other
+    // ciphertexts, so they must be rescaled before they are combined.
+    bool mixedScales = false;
+    if (ckks) {
+      bool anyPending = false;
+      bool anyNotPending = false;
+      for (Value operand : op->getOperands()) {
+        if (getLevel(operand) < 0) continue;
+        if (pending.contains(operand)) {
+          anyPending = true;
+        } else {
+          anyNotPending = true;
+        }
+      }
+      mixedScales = anyPending && anyNotPending;
+    }
+
+    // Lazily switched products are switched right before they are multiplied
+    // again, or combined with ciphertexts of another scale.
+    int level = -1;
+    for (OpOperand &operand : op->getOpOperands()) {
+      int operandLevel = getLevel(operand.get());
+      if (operandLevel < 0) continue;
+      if ((multiplication || mixedScales) && pending.contains(operand.get()) &&
+          operandLevel > 0) {
+        operand.set(switchToLevel(operand.get(), operandLevel - 1));
+        --operandLevel;
+      }
+      level = level < 0 ? operandLevel : std::min(level, operandLevel);
+    }
+    if (level < 0) return success();
+
+    // Align all ciphertext and plaintext operands to the lowest level.
+    bool resultPending = multiplication;
+    for (OpOperand &operand : op->getOpOperands()) {
+      Value value = operand.get();
+      if (isa<lwe::RLWEPlaintextType>(value.getType())) {
+        FailureOr<Value> encoded = encodeAtLevel(value, level);
+        if (failed(encoded)) {
+          return op->emitError()
+                 << "cannot lower the level of plaintext operand "
+                 << operand.getOperandNumber()
+                 << ", which is not produced by lwe.rlwe_encode";
+        }
+        operand.set(encoded.value());
+        continue;
+      }
+      if (getLevel(value) < 0) continue;
+      if (getLevel(value) > level) {
+        operand.set(switchToLevel(value, level));
+      } else if (pending.contains(value)) {
+        resultPending = true;
+      }
+    }
+
+    for (OpResult result : op->getResults()) {
+      auto type = dyn_cast<lwe::RLWECiphertextType>(result.getType());
+      if (!type) continue;
+      result.setType(getCiphertextTypeWithRing(type, rings[level]));
+      if (resultPending) pending.insert(result);
+    }
+
+    if (!eager || !resultPending || level == 0) return success();
+
+    // Eagerly switched products are switched right after the multiplication,
+    // or after the relinearization that follows it.
+    for (OpResult result : op->getResults()) {
+      if (!pending.contains(result)) continue;
+      if (result.hasOneUse() && isRelinearization(*result.getUsers().begin()))
+        continue;
+      Value switched = switchToLevel(result, level - 1);
+      result.replaceAllUsesExcept(switched, switched.getDefiningOp());
+      pending.erase(result);
+    }
+    return success();
+  }
+
+  ArrayRef<polynomial::RingAttr> rings;
+  bool eager;
+  bool ckks;
+  PendingResults &pendingResults;
+  DenseMap<Attribute, int> levelOfRing;
+  // Products whose modulus has not been switched yet, and values computed
+  // from them.
+  DenseSet<Value> pending;
+  // The values switched down to a level, keyed by the original value and the
+  // level.
+  DenseMap<std::pair<Value, int>, Value> switchedValues;
+};
+
+}  // namespace
+
+struct ManageLevels : impl::ManageLevelsBase<ManageLevels> {
+  using ManageLevelsBase::ManageLevelsBase;
+
+  LogicalResult processFunc(func::FuncOp funcOp, DataFlowSolver &solver,
+                            PendingResults &pendingResults) {
+    if (funcOp.isDeclaration()) return success();
+
+    auto ciphertextArg =
+        llvm::find_if(funcOp.getArgumentTypes(), [](Type type) {
+          return isa<lwe::RLWECiphertextType>(type);
+        });
+    if (ciphertextArg == funcOp.getArgumentTypes().end()) return success();
+    polynomial::RingAttr topRing = cast<lwe::RLWECiphertextType>(*ciphertextArg)
+                                       .getRlweParams()
+                                       .getRing();
+
+    auto rings = getLevelRings(topRing, moduli);
+    if (failed(rings)) {
+      return funcOp.emitError()
+             << "the coefficient modulus of the ciphertext arguments is not "
+                "the product of the moduli of the modulus chain";
+    }
+
+    bool hasRegions = false;
+    bool ckks = false;
+    int64_t maxMulDepth = 0;
+    funcOp.getBody().walk([&](Operation *op) {
+      hasRegions |= op->getNumRegions() > 0;
+      ckks |= isa_and_nonnull<ckks::CKKSDialect>(op->getDialect());
+      for (Value result : op->getResults()) {
+        const MulDepthLattice *lattice =
+            solver.lookupState<MulDepthLattice>(result);
+        if (lattice && lattice->getValue().isInitialized())
+          maxMulDepth = std::max(maxMulDepth, lattice->getValue().getValue());
+      }
+    });
+    if (hasRegions) {
+      funcOp.emitWarning() << "skipping level management of a function with "
+                              "regions";
+      return success();
+    }
+
+    int64_t maxLevel = rings->size() - 1;
+    if (maxMulDepth > maxLevel) {
+      return funcOp.emitError()
+             << "the multiplicative depth " << maxMulDepth
+             << " exceeds the " << maxLevel
+             << " modulus switches allowed by the modulus chain";
+    }
+
+    LevelManager manager(rings.value(), strategy == "eager", ckks,
+                         pendingResults);
+    return manager.run(funcOp);
+  }
+
+  void runOnOperation() override {
+    if (strategy != "eager" && strategy != "lazy") {
+      getOperation()->emitError()
+          << "unknown strategy '" << strategy << "', expected eager or lazy";
+      return signalPassFailure();
+    }
+    if (moduli.empty()) {
+      getOperation()->emitError() << "the moduli option is required";
+      return signalPassFailure();
+    }
+
+    DataFlowSolver solver;
+    solver.load<dataflow::DeadCodeAnalysis>();
+    solver.load<dataflow::SparseConstantPropagation>();
+    solver.load<MulDepthAnalysis>();
+    if (failed(solver.initializeAndRun(getOperation()))) {
+      getOperation()->emitOpError() << "Failed to run the analysis.\n";
+      return signalPassFailure();
+    }
+
+    // Manage the callees before their callers, so that the calls get the
+    // levels of the results of the managed callees.
+    SymbolTable symbolTable(getOperation());
+    SmallVector<func::FuncOp> funcOps;
+    DenseSet<Operation *> visited;
+    std::function<void(func::FuncOp)> visit = [&](func::FuncOp funcOp) {
+      if (!visited.insert(funcOp).second) return;
+      funcOp.walk([&](func::CallOp callOp) {
+        if (auto callee = symbolTable.lookup<func::FuncOp>(callOp.getCallee()))
+          visit(callee);
+      });
+      funcOps.push_back(funcOp);
+    };
+    for (auto funcOp : getOperation().getOps<func::FuncOp>()) visit(funcOp);
+
+    PendingResults pendingResults;
+    for (func::FuncOp funcOp : funcOps) {
+      if (failed(processFunc(funcOp, solver, pendingResults)))
+        return signalPassFailure();
+    }
+
+    // Calls in functions whose levels are not managed keep the result types
+    // of their callees before management.
+    auto result = getOperation()->walk([&](func::CallOp callOp) {
+      auto callee = symbolTable.lookup<func::FuncOp>(callOp.getCallee());
+      if (!callee || callOp.getResultTypes() == callee.getResultTypes())
+        return WalkResult::advance();
+      callOp.emitError() << "cannot update the results of a call to a "
+                            "function whose levels were lowered";
+      return WalkResult::interrupt();
+    });
+    if (result.wasInterrupted()) signalPassFailure();
+  }
+};
+
+}  // namespace heir
+}  // namespace mlir
@@ -0,0 +1,18 @@
+#ifndef LIB_TRANSFORMS_MANAGELEVELS_MANAGELEVELS_H_
+#define LIB_TRANSFORMS_MANAGELEVELS_MANAGELEVELS_H_
+
+#include "mlir/include/mlir/Pass/Pass.h"  // from @llvm-project
+
+namespace mlir {
+namespace heir {
+
+#define GEN_PASS_DECL
+#include "lib/Transforms/ManageLevels/ManageLevels.h.inc"
+
+#define GEN_PASS_REGISTRATION
+#include "lib/Transforms/ManageLevels/ManageLevels.h.inc"
+
+}  // namespace heir
+}  // namespace mlir
+
+#endif  // LIB_TRANSFORMS_MANAGELEVELS_MANAGELEVELS_H_
@@ -1,8 +1,10 @@
 #include "lib/Transforms/OptimizeRelinearization/OptimizeRelinearization.h"
 
+#include <algorithm>
 #include <iterator>
 #include <numeric>
 #include <optional>
+#include <string>
 #include <vector>
 
 #include "lib/Analysis/OptimizeRelinearizationAnalysis/OptimizeRelinearizationAnalysis.h"
@@ -14,6 +16,7 @@
 #include "llvm/include/llvm/ADT/SmallVector.h"          // from @llvm-project
 #include "llvm/include/llvm/ADT/TypeSwitch.h"           // from @llvm-project
 #include "llvm/include/llvm/Support/Debug.h"            // from @llvm-project
+#include "llvm/include/llvm/Support/FormatVariadic.h"   // from @llvm-project
 #include "mlir/include/mlir/Dialect/Func/IR/FuncOps.h"  // from @llvm-project
 #include "mlir/include/mlir/IR/Builders.h"              // from @llvm-project
 #include "mlir/include/mlir/IR/BuiltinAttributes.h"     // from @llvm-project
@@ -116,12 +119,25 @@ struct OptimizeRelinearization
       op.erase();
     });
 
-    OptimizeRelinearizationAnalysis analysis(funcOp);
+    OptimizeRelinearizationAnalysis analysis(
+        funcOp, RelinearizationCostModel(), maxIlpSize,
+        /*boundHeuristicSolutions=*/reportOptimalityGap);
     if (failed(analysis.solve())) {
       funcOp->emitError("Failed to solve the optimization problem");
       return signalPassFailure();
     }
 
+    if (reportOptimalityGap) {
+      double cost = analysis.getObjectiveValue();
+      double bound = analysis.getObjectiveBound();
+      double gap = cost == 0 ? 0 : std::max(0.0, (cost - bound) / cost);
+      std::string report = llvm::formatv(
+          "relinearization placement has modeled cost {0:F1}, lower bound "
+          "{1:F1}, optimality gap {2:P}",
+          cost, bound, gap);
+      funcOp->emitRemark() << report;
+    }
+
     OpBuilder b(&getContext());
 
     funcOp->walk([&](Operation *op) {
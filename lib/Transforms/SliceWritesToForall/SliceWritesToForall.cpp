@@ -0,0 +1,257 @@
+#include "lib/Transforms/SliceWritesToForall/SliceWritesToForall.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+#include "llvm/include/llvm/ADT/STLExtras.h"    // from @llvm-project
+#include "llvm/include/llvm/ADT/SetVector.h"    // from @llvm-project
+#include "llvm/include/llvm/ADT/SmallVector.h"  // from @llvm-project
+#include "mlir/include/mlir/Dialect/Arith/IR/Arith.h"    // from @llvm-project
+#include "mlir/include/mlir/Dialect/SCF/IR/SCF.h"        // from @llvm-project
+#include "mlir/include/mlir/Dialect/Tensor/IR/Tensor.h"  // from @llvm-project
+#include "mlir/include/mlir/Dialect/Utils/StaticValueUtils.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/BuiltinTypes.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/PatternMatch.h"  // from @llvm-project
+#include "mlir/include/mlir/Interfaces/SideEffectInterfaces.h"  // from @llvm-project
+#include "mlir/include/mlir/Support/LLVM.h"  // from @llvm-project
+#include "mlir/include/mlir/Support/LogicalResult.h"  // from @llvm-project
+#include "mlir/include/mlir/Transforms/GreedyPatternRewriteDriver.h"  // from @llvm-project
+
+namespace mlir {
+namespace heir {
+
+#define GEN_PASS_DEF_SLICEWRITESTOFORALL
+#include "lib/Transforms/SliceWritesToForall/SliceWritesToForall.h.inc"
+
+namespace {
+
+// Returns the dimension along which `insertOp` writes a slice of size 1 at
+// offset `iv`, if any.
+std::optional<unsigned> getInductionDim(tensor::InsertSliceOp insertOp,
+                                        Value iv) {
+  SmallVector<OpFoldResult> offsets = insertOp.getMixedOffsets();
+  SmallVector<OpFoldResult> sizes = insertOp.getMixedSizes();
+  for (unsigned dim = 0; dim < offsets.size(); ++dim) {
+    if (dyn_cast<Value>(offsets[dim]) == iv &&
+        isConstantIntValue(sizes[dim], 1))
+      return dim;
+  }
+  return std::nullopt;
+}
+
+// Returns the row that `insertOp` writes, if it writes a single full row of
+// its destination at a static offset.
+std::optional<int64_t> getInsertedRow(tensor::InsertSliceOp insertOp) {
+  RankedTensorType destType = insertOp.getDestType();
+  if (destType.getRank() < 2 || !destType.hasStaticShape())
+    return std::nullopt;
+  if (!llvm::all_of(insertOp.getMixedStrides(),
+                    [](OpFoldResult s) { return isConstantIntValue(s, 1); }))
+    return std::nullopt;
+
+  SmallVector<OpFoldResult> offsets = insertOp.getMixedOffsets();
+  SmallVector<OpFoldResult> sizes = insertOp.getMixedSizes();
+  std::optional<int64_t> row = getConstantIntValue(offsets[0]);
+  if (!row.has_value() || !isConstantIntValue(sizes[0], 1))
+    return std::nullopt;
+  for (int64_t dim = 1; dim < destType.getRank(); ++dim) {
+    if (!isConstantIntValue(offsets[dim], 0) ||
+        !isConstantIntValue(sizes[dim], destType.getDimSize(dim)))
+      return std::nullopt;
+  }
+  return row;
+}
+
+// Returns the ops in the block of `insertOp` whose results only contribute to
+// the source of `insertOp`, in program order. These can be moved next to the
+// write without changing the values seen by any other op.
+SmallVector<Operation *> getExclusiveSlice(tensor::InsertSliceOp insertOp) {
+  Block *block = insertOp->getBlock();
+  OpOperand *source = &insertOp.getSourceMutable();
+  llvm::SetVector<Operation *> exclusive;
+  for (Operation &op : llvm::reverse(
+           llvm::make_range(block->begin(), insertOp->getIterator()))) {
+    if (op.use_empty() || !isMemoryEffectFree(&op)) continue;
+    bool onlyFeedsSource = llvm::all_of(op.getUses(), [&](OpOperand &use) {
+      if (&use == source) return true;
+      Operation *ancestor = block->findAncestorOpInBlock(*use.getOwner());
+      return ancestor != insertOp && exclusive.contains(ancestor);
+    });
+    if (onlyFeedsSource) exclusive.insert(&op);
+  }
+  return llvm::to_vector(llvm::reverse(exclusive));
+}
+
+// Converts an scf.for loop that writes a disjoint slice of its only
+// loop-carried tensor in each iteration to an scf.forall loop.
+struct ConvertSliceWritingFor : public OpRewritePattern<scf::ForOp> {
+  using OpRewritePattern<scf::ForOp>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(scf::ForOp forOp,
+                                PatternRewriter &rewriter) const override {
+    if (forOp.getNumRegionIterArgs() != 1 ||
+        !isa<RankedTensorType>(forOp.getResult(0).getType()))
+      return rewriter.notifyMatchFailure(
+          forOp, "requires a single loop-carried tensor");
+
+    BlockArgument iterArg = forOp.getRegionIterArgs()[0];
+    if (!iterArg.hasOneUse())
+      return rewriter.notifyMatchFailure(
+          forOp, "loop-carried tensor must be written exactly once");
+    auto insertOp = dyn_cast<tensor::InsertSliceOp>(*iterArg.user_begin());
+    if (!insertOp || insertOp.getDest() != iterArg ||
+        insertOp->getBlock() != forOp.getBody())
+      return rewriter.notifyMatchFailure(
+          forOp, "loop-carried tensor must be the destination of a slice");
+
+    auto yieldOp = cast<scf::YieldOp>(forOp.getBody()->getTerminator());
+    if (yieldOp.getOperand(0) != insertOp.getResult() ||
+        !insertOp.getResult().hasOneUse())
+      return rewriter.notifyMatchFailure(
+          forOp, "the written tensor must be yielded and otherwise unused");
+
+    if (!getInductionDim(insertOp, forOp.getInductionVar()).has_value())
+      return rewriter.notifyMatchFailure(
+          forOp, "slices written by different iterations may overlap");
+
+    auto forallOp = rewriter.create<scf::ForallOp>(
+        forOp.getLoc(), getAsOpFoldResult(forOp.getLowerBound()),
+        getAsOpFoldResult(forOp.getUpperBound()),
+        getAsOpFoldResult(forOp.getStep()), ValueRange{forOp.getInitArgs()},
+        /*mapping=*/std::nullopt);
+    scf::InParallelOp terminator = forallOp.getTerminator();
+    rewriter.inlineBlockBefore(forOp.getBody(), terminator,
+                               {forallOp.getInductionVars()[0],
+                                forallOp.getRegionIterArgs()[0]});
+
+    rewriter.setInsertionPointToStart(&terminator.getRegion().front());
+    rewriter.create<tensor::ParallelInsertSliceOp>(
+        insertOp.getLoc(), insertOp.getSource(), insertOp.getDest(),
+        insertOp.getMixedOffsets(), insertOp.getMixedSizes(),
+        insertOp.getMixedStrides());
+    rewriter.eraseOp(yieldOp);
+    rewriter.eraseOp(insertOp);
+    rewriter.replaceOp(forOp, forallOp.getResults());
+    return success();
+  }
+};
+
+// Converts a chain of writes of single rows, such as the limbs of an RNS
+// value, to an scf.forall loop that computes and writes one row per
+// iteration.
+struct ConvertRowInsertChain : public OpRewritePattern<tensor::InsertSliceOp> {
+  using OpRewritePattern<tensor::InsertSliceOp>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(tensor::InsertSliceOp tailOp,
+                                PatternRewriter &rewriter) const override {
+    if (!getInsertedRow(tailOp).has_value())
+      return rewriter.notifyMatchFailure(tailOp, "not a row write");
+    if (tailOp.getResult().hasOneUse()) {
+      auto next = dyn_cast<tensor::InsertSliceOp>(
+          *tailOp.getResult().user_begin());
+      if (next && next.getDest() == tailOp.getResult() &&
+          next->getBlock() == tailOp->getBlock() &&
+          getInsertedRow(next).has_value())
+        return rewriter.notifyMatchFailure(tailOp, "not the end of a chain");
+    }
+
+    // Collect the chain in program order.
+    SmallVector<tensor::InsertSliceOp> chain = {tailOp};
+    while (auto prev = chain.back().getDest().getDefiningOp<
+                       tensor::InsertSliceOp>()) {
+      if (prev->getBlock() != tailOp->getBlock() ||
+          !prev.getResult().hasOneUse() || !getInsertedRow(prev).has_value())
+        break;
+      chain.push_back(prev);
+    }
+    std::reverse(chain.begin(), chain.end());
+    if (chain.size() < 2)
+      return rewriter.notifyMatchFailure(tailOp, "chain is too short");
+
+    Type sourceType = tailOp.getSourceType();
+    int64_t minRow = *getInsertedRow(chain.front());
+    for (tensor::InsertSliceOp op : chain) {
+      if (op.getSourceType() != sourceType)
+        return rewriter.notifyMatchFailure(op, "rows have different types");
+      minRow = std::min(minRow, *getInsertedRow(op));
+    }
+    int64_t numRows = chain.size();
+    SmallVector<tensor::InsertSliceOp> byRow(numRows);
+    for (tensor::InsertSliceOp op : chain) {
+      int64_t index = *getInsertedRow(op) - minRow;
+      if (index >= numRows || byRow[index])
+        return rewriter.notifyMatchFailure(op, "rows are not contiguous");
+      byRow[index] = op;
+    }
+
+    SmallVector<SmallVector<Operation *>> slices;
+    bool hasWork = false;
+    for (tensor::InsertSliceOp op : byRow) {
+      slices.push_back(getExclusiveSlice(op));
+      hasWork |= !slices.back().empty();
+    }
+    if (!hasWork)
+      return rewriter.notifyMatchFailure(tailOp, "rows are already computed");
+
+    Location loc = tailOp.getLoc();
+    rewriter.setInsertionPoint(tailOp);
+    auto forallOp = rewriter.create<scf::ForallOp>(
+        loc, ArrayRef<OpFoldResult>{rewriter.getIndexAttr(0)},
+        ArrayRef<OpFoldResult>{rewriter.getIndexAttr(numRows)},
+        ArrayRef<OpFoldResult>{rewriter.getIndexAttr(1)},
+        ValueRange{chain.front().getDest()}, /*mapping=*/std::nullopt);
+    Value iv = forallOp.getInductionVars()[0];
+    scf::InParallelOp terminator = forallOp.getTerminator();
+
+    rewriter.setInsertionPoint(terminator);
+    auto cases = llvm::to_vector(llvm::seq<int64_t>(0, numRows - 1));
+    auto switchOp = rewriter.create<scf::IndexSwitchOp>(
+        loc, TypeRange{sourceType}, iv, cases, cases.size());
+    for (auto [index, op] : llvm::enumerate(byRow)) {
+      Region &region = index + 1 == byRow.size()
+                           ? switchOp.getDefaultRegion()
+                           : switchOp.getCaseRegions()[index];
+      rewriter.createBlock(&region);
+      auto yieldOp = rewriter.create<scf::YieldOp>(loc, op.getSource());
+      for (Operation *sliceOp : slices[index])
+        rewriter.moveOpBefore(sliceOp, yieldOp);
+    }
+
+    rewriter.setInsertionPointAfter(switchOp);
+    Value row = iv;
+    if (minRow != 0) {
+      row = rewriter.create<arith::AddIOp>(
+          loc, iv, rewriter.create<arith::ConstantIndexOp>(loc, minRow));
+    }
+    SmallVector<OpFoldResult> offsets = tailOp.getMixedOffsets();
+    offsets[0] = row;
+    rewriter.setInsertionPointToStart(&terminator.getRegion().front());
+    rewriter.create<tensor::ParallelInsertSliceOp>(
+        loc, switchOp.getResult(0), forallOp.getRegionIterArgs()[0], offsets,
+        tailOp.getMixedSizes(), tailOp.getMixedStrides());
+
+    rewriter.replaceOp(tailOp, forallOp.getResults());
+    for (tensor::InsertSliceOp op : llvm::reverse(ArrayRef(chain).drop_back()))
+      rewriter.eraseOp(op);
+    return success();
+  }
+};
+
+}  // namespace
+
+struct SliceWritesToForall
+    : impl::SliceWritesToForallBase<SliceWritesToForall> {
+  using SliceWritesToForallBase::SliceWritesToForallBase;
+
+  void runOnOperation() override {
+    MLIRContext *context = &getContext();
+    RewritePatternSet patterns(context);
+    patterns.add<ConvertSliceWritingFor, ConvertRowInsertChain>(context);
+    (void)applyPatternsAndFoldGreedily(getOperation(), std::move(patterns));
+  }
+};
+
+}  // namespace heir
+}  // namespace mlir
@@ -0,0 +1,37 @@
+// RUN: heir-opt --manage-levels="moduli=17,41,97 strategy=eager" --ckks-to-openfhe %s | FileCheck %s
+
+#encoding = #lwe.polynomial_evaluation_encoding<cleartext_start=30, cleartext_bitwidth=3>
+#my_poly = #polynomial.int_polynomial<1 + x**1024>
+// 67609 = 17 * 41 * 97
+#ring = #polynomial.ring<coefficientType=!mod_arith.int<67609:i32>, polynomialModulus=#my_poly>
+#params = #lwe.rlwe_params<dimension=2, ring=#ring>
+#params1 = #lwe.rlwe_params<dimension=3, ring=#ring>
+
+!ct = !lwe.rlwe_ciphertext<encoding=#encoding, rlwe_params=#params, underlying_type=i3>
+!ct1 = !lwe.rlwe_ciphertext<encoding=#encoding, rlwe_params=#params1, underlying_type=i3>
+
+// Rescales become mod_reduce and the level adjustments of the fresh input
+// become level_reduce, keeping the ring chosen by manage-levels.
+// CHECK-LABEL: func.func @ckks_fresh_and_product
+// CHECK-SAME:    %[[CC:[^:]*]]: !openfhe.crypto_context
+// CHECK-SAME:    %[[X:[^:]*]]: !lwe.rlwe_ciphertext
+// CHECK-SAME:    %[[Y:[^:]*]]: !lwe.rlwe_ciphertext
+// CHECK-NEXT:    %[[X1:.*]] = openfhe.level_reduce %[[CC]], %[[X]] {{.*}}mod_arith.int<697 : i32>
+// CHECK-NEXT:    %[[X0:.*]] = openfhe.level_reduce %[[CC]], %[[X1]] {{.*}}mod_arith.int<17 : i32>
+// CHECK-NEXT:    %[[MUL0:.*]] = openfhe.mul_no_relin %[[CC]], %[[X]], %[[Y]]
+// CHECK-NEXT:    %[[RELIN0:.*]] = openfhe.relin %[[CC]], %[[MUL0]]
+// CHECK-NEXT:    %[[RESCALE0:.*]] = openfhe.mod_reduce %[[CC]], %[[RELIN0]] {{.*}}mod_arith.int<697 : i32>
+// CHECK-NEXT:    %[[MUL1:.*]] = openfhe.mul_no_relin %[[CC]], %[[RESCALE0]], %[[X1]]
+// CHECK-NEXT:    %[[RELIN1:.*]] = openfhe.relin %[[CC]], %[[MUL1]]
+// CHECK-NEXT:    %[[RESCALE1:.*]] = openfhe.mod_reduce %[[CC]], %[[RELIN1]] {{.*}}mod_arith.int<17 : i32>
+// CHECK-NEXT:    %[[ADD:.*]] = openfhe.add %[[CC]], %[[RESCALE1]], %[[X0]]
+// CHECK-NEXT:    return %[[ADD]]
+// CHECK-NOT:   ckks.
+func.func @ckks_fresh_and_product(%x: !ct, %y: !ct) -> !ct {
+  %0 = ckks.mul %x, %y : (!ct, !ct) -> !ct1
+  %1 = ckks.relinearize %0 {from_basis = array<i32: 0, 1, 2>, to_basis = array<i32: 0, 1>} : !ct1 -> !ct
+  %2 = ckks.mul %1, %x : (!ct, !ct) -> !ct1
+  %3 = ckks.relinearize %2 {from_basis = array<i32: 0, 1, 2>, to_basis = array<i32: 0, 1>} : !ct1 -> !ct
+  %4 = ckks.add %3, %x : !ct
+  return %4 : !ct
+}
@@ -31,6 +31,7 @@ module {
     %0 = ckks.mul %arg0, %arg1  : (!ct, !ct) -> !ct1
     %1 = ckks.relinearize %0  {from_basis = array<i32: 0, 1, 2>, to_basis = array<i32: 0, 1> } : !ct1 -> !ct
     %2 = ckks.rescale %1  {to_ring = #ring2} : !ct -> !ct2
+    %3 = ckks.level_reduce %arg0  {to_ring = #ring2} : !ct -> !ct2
     // CHECK: rlwe_params = <dimension = 3, ring = <coefficientType = !mod_arith.int<161729713 : i32>, polynomialModulus = <1 + x**1024>>>
     return %arg0 : !ct
   }
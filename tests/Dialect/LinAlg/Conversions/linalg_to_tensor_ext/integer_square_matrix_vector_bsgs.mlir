@@ -0,0 +1,41 @@
+// RUN: heir-opt %s --linalg-to-tensor-ext=bsgs-threshold=4 | FileCheck %s
+
+// With two baby steps and two giant steps, the last two diagonals (columns)
+// are pre-rotated by two, and the vector is rotated once by each step.
+// CHECK:      func.func @test_integer_square_matrix_vector_bsgs(%[[ARG:.*]]: !secret.secret<tensor<4x1xi16>>)
+// CHECK-DAG:  %[[ONE:.*]] = arith.constant 1 : index
+// CHECK-DAG:  %[[TWO:.*]] = arith.constant 2 : index
+// CHECK:      %[[DIAGONALIZED_MATRIX:.*]] = arith.constant dense
+// CHECK-SAME{LITERAL}: <[[1, 2, 9, 10], [6, 7, 14, 15], [11, 12, 3, 4], [16, 13, 8, 5]]> : tensor<4x4xi16>
+// CHECK:      %[[BIAS:.*]] = arith.constant dense
+// CHECK:      %[[OUT:.*]] = secret.generic ins(%[[ARG]] : !secret.secret<tensor<4x1xi16>>)
+// CHECK:      ^bb0(%[[VEC:.*]]: tensor<4x1xi16>):
+// CHECK-NOT:    affine.for
+// CHECK:        %[[BABY1:.*]] = tensor_ext.rotate %[[VEC]], %[[ONE]]
+// CHECK:        %[[SLICE0:.*]] = tensor.extract_slice %[[DIAGONALIZED_MATRIX]][0, 0] [4, 1] [1, 1]
+// CHECK:        %[[MUL0:.*]] = arith.muli %[[VEC]], %[[SLICE0]]
+// CHECK:        %[[SLICE1:.*]] = tensor.extract_slice %[[DIAGONALIZED_MATRIX]][0, 1] [4, 1] [1, 1]
+// CHECK:        %[[MUL1:.*]] = arith.muli %[[BABY1]], %[[SLICE1]]
+// CHECK:        %[[INNER0:.*]] = arith.addi %[[MUL0]], %[[MUL1]]
+// CHECK:        %[[SUM0:.*]] = arith.addi %[[BIAS]], %[[INNER0]]
+// CHECK:        %[[SLICE2:.*]] = tensor.extract_slice %[[DIAGONALIZED_MATRIX]][0, 2] [4, 1] [1, 1]
+// CHECK:        %[[MUL2:.*]] = arith.muli %[[VEC]], %[[SLICE2]]
+// CHECK:        %[[SLICE3:.*]] = tensor.extract_slice %[[DIAGONALIZED_MATRIX]][0, 3] [4, 1] [1, 1]
+// CHECK:        %[[MUL3:.*]] = arith.muli %[[BABY1]], %[[SLICE3]]
+// CHECK:        %[[INNER1:.*]] = arith.addi %[[MUL2]], %[[MUL3]]
+// CHECK:        %[[GIANT1:.*]] = tensor_ext.rotate %[[INNER1]], %[[TWO]]
+// CHECK:        %[[SUM1:.*]] = arith.addi %[[SUM0]], %[[GIANT1]]
+// CHECK:        secret.yield %[[SUM1]]
+// CHECK:      return %[[OUT]]
+module {
+func.func @test_integer_square_matrix_vector_bsgs(%vec : !secret.secret<tensor<4x1xi16>>) -> !secret.secret<tensor<4x1xi16>> {
+  %matrix = arith.constant dense<[[1, 2, 3, 4], [5, 6, 7, 8], [9, 10, 11, 12], [13, 14, 15, 16]]> : tensor<4x4xi16>
+  %bias = arith.constant dense<[[17], [18], [19], [20]]> : tensor<4x1xi16>
+  %out = secret.generic ins (%vec : !secret.secret<tensor<4x1xi16>>) {
+  ^bb0(%converted_vec: tensor<4x1xi16>):
+    %0 = linalg.matmul ins(%matrix, %converted_vec : tensor<4x4xi16>, tensor<4x1xi16>) outs(%bias : tensor<4x1xi16>) -> tensor<4x1xi16>
+    secret.yield %0 : tensor<4x1xi16>
+  } -> !secret.secret<tensor<4x1xi16>>
+  return %out : !secret.secret<tensor<4x1xi16>>
+}
+}
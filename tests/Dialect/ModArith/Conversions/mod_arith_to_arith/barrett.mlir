@@ -0,0 +1,91 @@
+// RUN: heir-opt -mod-arith-to-arith --split-input-file %s | FileCheck %s --enable-var-scope
+// RUN: heir-opt -mod-arith-to-arith=reduction=barrett --split-input-file %s | FileCheck %s --enable-var-scope --check-prefix=BARRETT
+
+!Zp = !mod_arith.int<65537 : i32>
+
+// CHECK-LABEL: @test_lower_add
+// CHECK-SAME: (%[[LHS:.*]]: i32, %[[RHS:.*]]: i32) -> i32 {
+func.func @test_lower_add(%lhs : !Zp, %rhs : !Zp) -> !Zp {
+  // CHECK: %[[CMOD:.*]] = arith.constant 65537 : i32
+  // CHECK: %[[ADD:.*]] = arith.addi %[[LHS]], %[[RHS]] : i32
+  // CHECK: %[[SUB:.*]] = arith.subi %[[ADD]], %[[CMOD]] : i32
+  // CHECK: %[[CMP:.*]] = arith.cmpi uge, %[[ADD]], %[[CMOD]] : i32
+  // CHECK: %[[RES:.*]] = arith.select %[[CMP]], %[[SUB]], %[[ADD]] : i32
+  // CHECK-NOT: arith.remui
+  // CHECK: return %[[RES]] : i32
+  %res = mod_arith.add %lhs, %rhs : !Zp
+  return %res : !Zp
+}
+
+// CHECK-LABEL: @test_lower_sub
+// CHECK-SAME: (%[[LHS:.*]]: i32, %[[RHS:.*]]: i32) -> i32 {
+func.func @test_lower_sub(%lhs : !Zp, %rhs : !Zp) -> !Zp {
+  // CHECK: %[[CMOD:.*]] = arith.constant 65537 : i32
+  // CHECK: %[[SUB:.*]] = arith.subi %[[LHS]], %[[RHS]] : i32
+  // CHECK: %[[ADD:.*]] = arith.addi %[[SUB]], %[[CMOD]] : i32
+  // CHECK: %[[CORR:.*]] = arith.subi %[[ADD]], %[[CMOD]] : i32
+  // CHECK: %[[CMP:.*]] = arith.cmpi uge, %[[ADD]], %[[CMOD]] : i32
+  // CHECK: %[[RES:.*]] = arith.select %[[CMP]], %[[CORR]], %[[ADD]] : i32
+  // CHECK-NOT: arith.remui
+  // CHECK: return %[[RES]] : i32
+  %res = mod_arith.sub %lhs, %rhs : !Zp
+  return %res : !Zp
+}
+
+// CHECK-LABEL: @test_lower_mul
+// CHECK-SAME: (%[[LHS:.*]]: i32, %[[RHS:.*]]: i32) -> i32 {
+func.func @test_lower_mul(%lhs : !Zp, %rhs : !Zp) -> !Zp {
+  // CHECK: %[[EXTL:.*]] = arith.extui %[[LHS]] : i32 to i64
+  // CHECK: %[[EXTR:.*]] = arith.extui %[[RHS]] : i32 to i64
+  // CHECK: %[[MUL:.*]] = arith.muli %[[EXTL]], %[[EXTR]] : i64
+  // CHECK: %[[KM1:.*]] = arith.constant 16 : i64
+  // CHECK: %[[Q1:.*]] = arith.shrui %[[MUL]], %[[KM1]] : i64
+  // CHECK: %[[MU:.*]] = arith.constant 262140 : i64
+  // CHECK: %[[Q2:.*]] = arith.muli %[[Q1]], %[[MU]] : i64
+  // CHECK: %[[SHIFT:.*]] = arith.constant 18 : i64
+  // CHECK: %[[Q3:.*]] = arith.shrui %[[Q2]], %[[SHIFT]] : i64
+  // CHECK: %[[CMOD:.*]] = arith.constant 65537 : i64
+  // CHECK: %[[Q3Q:.*]] = arith.muli %[[Q3]], %[[CMOD]] : i64
+  // CHECK: %[[R:.*]] = arith.subi %[[MUL]], %[[Q3Q]] : i64
+  // CHECK: arith.cmpi uge
+  // CHECK: arith.select
+  // CHECK: arith.cmpi uge
+  // CHECK: %[[SEL:.*]] = arith.select
+  // CHECK: %[[RES:.*]] = arith.trunci %[[SEL]] : i64 to i32
+  // CHECK-NOT: arith.remui
+  // CHECK: return %[[RES]] : i32
+  %res = mod_arith.mul %lhs, %rhs : !Zp
+  return %res : !Zp
+}
+
+// CHECK-LABEL: @test_lower_reduce
+// CHECK-SAME: (%[[ARG:.*]]: i32) -> i32 {
+func.func @test_lower_reduce(%arg : !Zp) -> !Zp {
+  // 2147516416 = ceil(2^31 / 65537) * 65537
+  // CHECK: %[[OFFSET:.*]] = arith.constant 2147516416 : i33
+  // CHECK: %[[EXT:.*]] = arith.extsi %[[ARG]] : i32 to i33
+  // CHECK: %[[ADD:.*]] = arith.addi %[[EXT]], %[[OFFSET]] : i33
+  // CHECK: arith.extui %[[ADD]] : i33 to i34
+  // CHECK: arith.constant 131070 : i34
+  // CHECK: %[[RES:.*]] = arith.trunci %{{.*}} : i34 to i32
+  // CHECK-NOT: arith.remui
+  // CHECK: return %[[RES]] : i32
+  %res = mod_arith.reduce %arg : !Zp
+  return %res : !Zp
+}
+
+// -----
+
+// A modulus that does not fit in a machine word falls back to remui in the
+// default strategy, but not when Barrett reduction is requested explicitly.
+!Zq = !mod_arith.int<340282366920938463463374607431768211297 : i130>
+
+// CHECK-LABEL: @test_lower_mul_wide
+// CHECK: arith.remui
+// BARRETT-LABEL: @test_lower_mul_wide
+// BARRETT-NOT: arith.remui
+// BARRETT: arith.shrui
+func.func @test_lower_mul_wide(%lhs : !Zq, %rhs : !Zq) -> !Zq {
+  %res = mod_arith.mul %lhs, %rhs : !Zq
+  return %res : !Zq
+}
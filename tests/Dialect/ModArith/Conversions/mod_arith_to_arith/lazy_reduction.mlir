@@ -0,0 +1,62 @@
+// RUN: heir-opt -mod-arith-to-arith="lazy-reduction=true reduction=remui" %s | FileCheck %s --enable-var-scope
+
+// 4 * 31 <= 2^7, so up to four canonical values can be summed without a
+// reduction.
+!Zp = !mod_arith.int<31 : i8>
+
+// CHECK-LABEL: @test_lazy_add_chain
+// CHECK-SAME: (%[[A:.*]]: i8, %[[B:.*]]: i8, %[[C:.*]]: i8, %[[D:.*]]: i8, %[[E:.*]]: i8) -> i8 {
+func.func @test_lazy_add_chain(%a : !Zp, %b : !Zp, %c : !Zp, %d : !Zp, %e : !Zp) -> !Zp {
+  // CHECK: %[[ADD0:.*]] = arith.addi %[[A]], %[[B]] : i8
+  // CHECK-NEXT: %[[ADD1:.*]] = arith.addi %[[ADD0]], %[[C]] : i8
+  // CHECK-NEXT: %[[ADD2:.*]] = arith.addi %[[ADD1]], %[[D]] : i8
+  // CHECK-NEXT: %[[ADD3:.*]] = arith.addi %[[ADD2]], %[[E]] : i8
+  // CHECK-NEXT: %[[CMOD:.*]] = arith.constant 31 : i8
+  // CHECK-NEXT: %[[RED3:.*]] = arith.remui %[[ADD3]], %[[CMOD]] : i8
+  // CHECK-NEXT: %[[ADD4:.*]] = arith.addi %[[RED3]], %[[A]] : i8
+  // CHECK-NEXT: %[[CMOD2:.*]] = arith.constant 31 : i8
+  // CHECK-NEXT: %[[REMS:.*]] = arith.remsi %[[ADD4]], %[[CMOD2]] : i8
+  // CHECK-NEXT: %[[ADDM:.*]] = arith.addi %[[REMS]], %[[CMOD2]] : i8
+  // CHECK-NEXT: %[[RES:.*]] = arith.remui %[[ADDM]], %[[CMOD2]] : i8
+  // CHECK-NEXT: return %[[RES]] : i8
+  %0 = mod_arith.add %a, %b : !Zp
+  %1 = mod_arith.add %0, %c : !Zp
+  %2 = mod_arith.add %1, %d : !Zp
+  // 5 * 31 > 2^7
+  %3 = mod_arith.add %2, %e : !Zp
+  %4 = mod_arith.add %3, %a : !Zp
+  return %4 : !Zp
+}
+
+// CHECK-LABEL: @test_lazy_sub_mul
+// CHECK-SAME: (%[[A:.*]]: i8, %[[B:.*]]: i8, %[[C:.*]]: i8) -> i8 {
+func.func @test_lazy_sub_mul(%a : !Zp, %b : !Zp, %c : !Zp) -> !Zp {
+  // CHECK: %[[OFFSET:.*]] = arith.constant 31 : i8
+  // CHECK-NEXT: %[[SUB:.*]] = arith.subi %[[A]], %[[B]] : i8
+  // CHECK-NEXT: %[[LAZY:.*]] = arith.addi %[[SUB]], %[[OFFSET]] : i8
+  // CHECK-NOT: arith.remui
+  // CHECK: %[[EXTL:.*]] = arith.extui %[[LAZY]] : i8 to i16
+  // CHECK-NEXT: %[[EXTR:.*]] = arith.extui %[[C]] : i8 to i16
+  // CHECK-NEXT: %[[MUL:.*]] = arith.muli %[[EXTL]], %[[EXTR]] : i16
+  // CHECK-NEXT: %[[CMOD:.*]] = arith.constant 31 : i16
+  // CHECK-NEXT: %[[REM:.*]] = arith.remui %[[MUL]], %[[CMOD]] : i16
+  // CHECK-NEXT: %[[RES:.*]] = arith.trunci %[[REM]] : i16 to i8
+  // CHECK-NEXT: return %[[RES]] : i8
+  %0 = mod_arith.sub %a, %b : !Zp
+  %1 = mod_arith.mul %0, %c : !Zp
+  return %1 : !Zp
+}
+
+// CHECK-LABEL: @test_reduced_ops_unchanged
+// CHECK-SAME: (%[[A:.*]]: i8, %[[B:.*]]: i8) -> i8 {
+func.func @test_reduced_ops_unchanged(%a : !Zp, %b : !Zp) -> !Zp {
+  // CHECK: %[[CMOD:.*]] = arith.constant 31 : i16
+  // CHECK: %[[EXTL:.*]] = arith.extui %[[A]] : i8 to i16
+  // CHECK: %[[EXTR:.*]] = arith.extui %[[B]] : i8 to i16
+  // CHECK: %[[MUL:.*]] = arith.muli %[[EXTL]], %[[EXTR]] : i16
+  // CHECK: %[[REM:.*]] = arith.remui %[[MUL]], %[[CMOD]] : i16
+  // CHECK: %[[RES:.*]] = arith.trunci %[[REM]] : i16 to i8
+  // CHECK: return %[[RES]] : i8
+  %0 = mod_arith.mul %a, %b : !Zp
+  return %0 : !Zp
+}
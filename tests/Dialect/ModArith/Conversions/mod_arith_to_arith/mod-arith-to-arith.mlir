@@ -1,4 +1,4 @@
-// RUN: heir-opt -mod-arith-to-arith --split-input-file %s | FileCheck %s --enable-var-scope
+// RUN: heir-opt -mod-arith-to-arith=reduction=remui --split-input-file %s | FileCheck %s --enable-var-scope
 
 !Zp = !mod_arith.int<65537 : i32>
 !Zpv = tensor<4x!Zp>
@@ -212,16 +212,20 @@ func.func @test_lower_subifge_int(%lhs : i8, %rhs : i8) -> i8 {
 // CHECK-SAME: (%[[ARG:.*]]: [[TENSOR_TYPE:.*]]) -> [[TENSOR_TYPE]] {
 func.func @test_lower_barrett_reduce(%arg : tensor<4xi10>) -> tensor<4xi10> {
 
-  // CHECK: %[[RATIO:.*]] = arith.constant dense<60> : [[INTER_TYPE:.*]]
-  // CHECK: %[[BITWIDTH:.*]] = arith.constant dense<10> : [[INTER_TYPE]]
+  // CHECK: %[[EXT:.*]] = arith.extui %[[ARG]] : [[TENSOR_TYPE]] to [[INTER_TYPE:.*]]
+  // CHECK: %[[KM1:.*]] = arith.constant dense<4> : [[INTER_TYPE]]
+  // CHECK: %[[Q1:.*]] = arith.shrui %[[EXT]], %[[KM1]] : [[INTER_TYPE]]
+  // CHECK: %[[RATIO:.*]] = arith.constant dense<60> : [[INTER_TYPE]]
+  // CHECK: %[[Q2:.*]] = arith.muli %[[Q1]], %[[RATIO]] : [[INTER_TYPE]]
+  // CHECK: %[[SHIFT:.*]] = arith.constant dense<6> : [[INTER_TYPE]]
+  // CHECK: %[[Q3:.*]] = arith.shrui %[[Q2]], %[[SHIFT]] : [[INTER_TYPE]]
   // CHECK: %[[CMOD:.*]] = arith.constant dense<17> : [[INTER_TYPE]]
-
-  // CHECK: %[[EXT:.*]] = arith.extui %[[ARG]] : [[TENSOR_TYPE]] to [[INTER_TYPE]]
-  // CHECK: %[[MULRATIO:.*]] = arith.muli %[[EXT]], %[[RATIO]] : [[INTER_TYPE]]
-  // CHECK: %[[SHIFTED:.*]] = arith.shrui %[[MULRATIO]], %[[BITWIDTH]] : [[INTER_TYPE]]
-  // CHECK: %[[MULCMOD:.*]] = arith.muli %[[SHIFTED]], %[[CMOD]] : [[INTER_TYPE]]
+  // CHECK: %[[MULCMOD:.*]] = arith.muli %[[Q3]], %[[CMOD]] : [[INTER_TYPE]]
   // CHECK: %[[SUB:.*]] = arith.subi %[[EXT]], %[[MULCMOD]] : [[INTER_TYPE]]
-  // CHECK: %[[RES:.*]] = arith.trunci %[[SUB]] : [[INTER_TYPE]] to [[TENSOR_TYPE]]
+  // CHECK: %[[CORR:.*]] = arith.subi %[[SUB]], %[[CMOD]] : [[INTER_TYPE]]
+  // CHECK: %[[CMP:.*]] = arith.cmpi uge, %[[SUB]], %[[CMOD]] : [[INTER_TYPE]]
+  // CHECK: %[[SEL:.*]] = arith.select %[[CMP]], %[[CORR]], %[[SUB]] : tensor<4xi1>, [[INTER_TYPE]]
+  // CHECK: %[[RES:.*]] = arith.trunci %[[SEL]] : [[INTER_TYPE]] to [[TENSOR_TYPE]]
   %res = mod_arith.barrett_reduce %arg { modulus = 17 } : tensor<4xi10>
 
   // CHECK: return %[[RES]] : [[TENSOR_TYPE]]
@@ -234,16 +238,20 @@ func.func @test_lower_barrett_reduce(%arg : tensor<4xi10>) -> tensor<4xi10> {
 // CHECK-SAME: (%[[ARG:.*]]: [[INT_TYPE:.*]]) -> [[INT_TYPE]] {
 func.func @test_lower_barrett_reduce_int(%arg : i10) -> i10 {
 
-  // CHECK: %[[RATIO:.*]] = arith.constant 60 : [[INTER_TYPE:.*]]
-  // CHECK: %[[BITWIDTH:.*]] = arith.constant 10 : [[INTER_TYPE]]
+  // CHECK: %[[EXT:.*]] = arith.extui %[[ARG]] : [[INT_TYPE]] to [[INTER_TYPE:.*]]
+  // CHECK: %[[KM1:.*]] = arith.constant 4 : [[INTER_TYPE]]
+  // CHECK: %[[Q1:.*]] = arith.shrui %[[EXT]], %[[KM1]] : [[INTER_TYPE]]
+  // CHECK: %[[RATIO:.*]] = arith.constant 60 : [[INTER_TYPE]]
+  // CHECK: %[[Q2:.*]] = arith.muli %[[Q1]], %[[RATIO]] : [[INTER_TYPE]]
+  // CHECK: %[[SHIFT:.*]] = arith.constant 6 : [[INTER_TYPE]]
+  // CHECK: %[[Q3:.*]] = arith.shrui %[[Q2]], %[[SHIFT]] : [[INTER_TYPE]]
   // CHECK: %[[CMOD:.*]] = arith.constant 17 : [[INTER_TYPE]]
-
-  // CHECK: %[[EXT:.*]] = arith.extui %[[ARG]] : [[INT_TYPE]] to [[INTER_TYPE]]
-  // CHECK: %[[MULRATIO:.*]] = arith.muli %[[EXT]], %[[RATIO]] : [[INTER_TYPE]]
-  // CHECK: %[[SHIFTED:.*]] = arith.shrui %[[MULRATIO]], %[[BITWIDTH]] : [[INTER_TYPE]]
-  // CHECK: %[[MULCMOD:.*]] = arith.muli %[[SHIFTED]], %[[CMOD]] : [[INTER_TYPE]]
+  // CHECK: %[[MULCMOD:.*]] = arith.muli %[[Q3]], %[[CMOD]] : [[INTER_TYPE]]
   // CHECK: %[[SUB:.*]] = arith.subi %[[EXT]], %[[MULCMOD]] : [[INTER_TYPE]]
-  // CHECK: %[[RES:.*]] = arith.trunci %[[SUB]] : [[INTER_TYPE]] to [[INT_TYPE]]
+  // CHECK: %[[CORR:.*]] = arith.subi %[[SUB]], %[[CMOD]] : [[INTER_TYPE]]
+  // CHECK: %[[CMP:.*]] = arith.cmpi uge, %[[SUB]], %[[CMOD]] : [[INTER_TYPE]]
+  // CHECK: %[[SEL:.*]] = arith.select %[[CMP]], %[[CORR]], %[[SUB]] : [[INTER_TYPE]]
+  // CHECK: %[[RES:.*]] = arith.trunci %[[SEL]] : [[INTER_TYPE]] to [[INT_TYPE]]
   %res = mod_arith.barrett_reduce %arg { modulus = 17 } : i10
 
   // CHECK: return %[[RES]] : [[INT_TYPE]]
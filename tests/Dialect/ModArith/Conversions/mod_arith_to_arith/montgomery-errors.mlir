@@ -0,0 +1,10 @@
+// RUN: heir-opt --verify-diagnostics -mod-arith-to-arith=use-montgomery=true %s
+
+!Zp = !mod_arith.int<7680 : i32>
+
+func.func @test_even_modulus(%lhs : !Zp, %rhs : !Zp) -> !Zp {
+  // expected-error@+2 {{Montgomery lowering requires an odd modulus}}
+  // expected-error@+1 {{failed to legalize operation 'mod_arith.mul'}}
+  %res = mod_arith.mul %lhs, %rhs : !Zp
+  return %res : !Zp
+}
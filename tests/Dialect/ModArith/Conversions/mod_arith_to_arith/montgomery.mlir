@@ -0,0 +1,97 @@
+// RUN: heir-opt -mod-arith-to-arith=use-montgomery=true %s | FileCheck %s --enable-var-scope
+
+!Zp = !mod_arith.int<7681 : i32>
+!Zpv = tensor<4x!Zp>
+
+// CHECK-LABEL: @test_lower_constant
+func.func @test_lower_constant() -> !Zp {
+  // 5 * 2^32 mod 7681 = 4802
+  // CHECK: %[[C:.*]] = arith.constant 4802 : i32
+  // CHECK: return %[[C]] : i32
+  %res = mod_arith.constant 5 : !Zp
+  return %res : !Zp
+}
+
+// CHECK-LABEL: @test_lower_encapsulate
+// CHECK-SAME: (%[[LHS:.*]]: i32) -> i32 {
+func.func @test_lower_encapsulate(%lhs : i32) -> !Zp {
+  // CHECK-NOT: mod_arith.encapsulate
+  // CHECK: %[[CMOD:.*]] = arith.constant 7681 : i32
+  // CHECK: %[[REMS:.*]] = arith.remsi %[[LHS]], %[[CMOD]] : i32
+  // CHECK: %[[ADD:.*]] = arith.addi %[[REMS]], %[[CMOD]] : i32
+  // CHECK: %[[REM:.*]] = arith.remui %[[ADD]], %[[CMOD]] : i32
+  // CHECK: %[[R2:.*]] = arith.constant 5564 : i64
+  // CHECK: %[[EXT:.*]] = arith.extui %[[REM]] : i32 to i64
+  // CHECK: %[[MUL:.*]] = arith.muli %[[EXT]], %[[R2]] : i64
+  // CHECK: arith.shrui
+  // CHECK: arith.select
+  %res = mod_arith.encapsulate %lhs: i32 -> !Zp
+  return %res : !Zp
+}
+
+// CHECK-LABEL: @test_lower_mul
+// CHECK-SAME: (%[[LHS:.*]]: i32, %[[RHS:.*]]: i32) -> i32 {
+func.func @test_lower_mul(%lhs : !Zp, %rhs : !Zp) -> !Zp {
+  // CHECK-NOT: mod_arith.mul
+  // CHECK-NOT: arith.remui
+  // CHECK: %[[EXT0:.*]] = arith.extui %[[LHS]] : i32 to i64
+  // CHECK: %[[EXT1:.*]] = arith.extui %[[RHS]] : i32 to i64
+  // CHECK: %[[MUL:.*]] = arith.muli %[[EXT0]], %[[EXT1]] : i64
+  // CHECK-DAG: %[[CMOD:.*]] = arith.constant 7681 : i32
+  // CHECK-DAG: %[[NEGINV:.*]] = arith.constant 1954291199 : i32
+  // CHECK-DAG: %[[CMODEXT:.*]] = arith.constant 7681 : i64
+  // CHECK-DAG: %[[SHIFT:.*]] = arith.constant 32 : i64
+  // CHECK: %[[LOW:.*]] = arith.trunci %[[MUL]] : i64 to i32
+  // CHECK: %[[M:.*]] = arith.muli %[[LOW]], %[[NEGINV]] : i32
+  // CHECK: %[[MEXT:.*]] = arith.extui %[[M]] : i32 to i64
+  // CHECK: %[[MQ:.*]] = arith.muli %[[MEXT]], %[[CMODEXT]] : i64
+  // CHECK: %[[SUM:.*]] = arith.addi %[[MUL]], %[[MQ]] : i64
+  // CHECK: %[[SHR:.*]] = arith.shrui %[[SUM]], %[[SHIFT]] : i64
+  // CHECK: %[[TRUNC:.*]] = arith.trunci %[[SHR]] : i64 to i32
+  // CHECK: %[[SUB:.*]] = arith.subi %[[TRUNC]], %[[CMOD]] : i32
+  // CHECK: %[[CMP:.*]] = arith.cmpi uge, %[[TRUNC]], %[[CMOD]] : i32
+  // CHECK: %[[SEL:.*]] = arith.select %[[CMP]], %[[SUB]], %[[TRUNC]] : i32
+  // CHECK: return %[[SEL]] : i32
+  %res = mod_arith.mul %lhs, %rhs : !Zp
+  return %res : !Zp
+}
+
+// CHECK-LABEL: @test_lower_mul_vec
+// CHECK-SAME: (%[[LHS:.*]]: tensor<4xi32>, %[[RHS:.*]]: tensor<4xi32>) -> tensor<4xi32> {
+func.func @test_lower_mul_vec(%lhs : !Zpv, %rhs : !Zpv) -> !Zpv {
+  // CHECK-NOT: mod_arith.mul
+  // CHECK-NOT: arith.remui
+  // CHECK: arith.muli %{{.*}}, %{{.*}} : tensor<4xi64>
+  // CHECK: arith.constant dense<1954291199> : tensor<4xi32>
+  // CHECK: arith.shrui
+  // CHECK: arith.select
+  %res = mod_arith.mul %lhs, %rhs : !Zpv
+  return %res : !Zpv
+}
+
+// CHECK-LABEL: @test_lower_mac
+// CHECK-SAME: (%[[X:.*]]: i32, %[[Y:.*]]: i32, %[[ACC:.*]]: i32) -> i32 {
+func.func @test_lower_mac(%x : !Zp, %y : !Zp, %acc : !Zp) -> !Zp {
+  // CHECK-NOT: mod_arith.mac
+  // CHECK-NOT: arith.remui
+  // CHECK: %[[RED:.*]] = arith.select
+  // CHECK: %[[ADD:.*]] = arith.addi %[[RED]], %[[ACC]] : i32
+  // CHECK: %[[CMP:.*]] = arith.cmpi uge, %[[ADD]]
+  // CHECK: %[[SEL:.*]] = arith.select %[[CMP]]
+  // CHECK: return %[[SEL]] : i32
+  %res = mod_arith.mac %x, %y, %acc : !Zp
+  return %res : !Zp
+}
+
+// CHECK-LABEL: @test_lower_extract
+// CHECK-SAME: (%[[LHS:.*]]: i32) -> i32 {
+func.func @test_lower_extract(%lhs : !Zp) -> i32 {
+  // CHECK-NOT: mod_arith.extract
+  // CHECK: %[[EXT:.*]] = arith.extui %[[LHS]] : i32 to i64
+  // CHECK: arith.shrui
+  // CHECK: %[[SEL:.*]] = arith.select
+  // CHECK: return %[[SEL]] : i32
+  %res = mod_arith.extract %lhs: !Zp -> i32
+  return %res : i32
+}
+
@@ -16,4 +16,4 @@ func.func @test_lower_barrett_reduce() {
   return
 }
 
-// CHECK_TEST_BARRETT: [3723, 7680, 17, 7681]
+// CHECK_TEST_BARRETT: [3723, 7680, 17, 0]
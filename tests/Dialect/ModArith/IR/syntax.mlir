@@ -70,3 +70,10 @@ func.func @test_arith_syntax() {
 
   return
 }
+
+// CHECK-LABEL: @test_montgomery_attr_syntax
+// CHECK-SAME: #mod_arith.montgomery<modulus = 17 : i8, negModulusInv = 15 : i8, rMod = 1 : i8, rSquared = 1 : i8>
+func.func @test_montgomery_attr_syntax() attributes {
+    montgomery = #mod_arith.montgomery<modulus = 17 : i8, negModulusInv = 15 : i8, rMod = 1 : i8, rSquared = 1 : i8>} {
+  return
+}
@@ -54,6 +54,34 @@ func.func @test_basic_emitter(%cc : !cc, %input1 : !ct, %input2 : !ct, %input3:
 
 // -----
 
+#encoding = #lwe.polynomial_evaluation_encoding<cleartext_start=30, cleartext_bitwidth=3>
+
+#my_poly = #polynomial.int_polynomial<1 + x**16384>
+#ring= #polynomial.ring<coefficientType=!mod_arith.int<7917:i32>, polynomialModulus=#my_poly>
+#params = #lwe.rlwe_params<dimension=1, ring=#ring>
+!cc = !openfhe.crypto_context
+!ct = !lwe.rlwe_ciphertext<encoding = #encoding, rlwe_params = #params, underlying_type=i3>
+
+// CHECK-LABEL: CiphertextT test_fast_rotation(
+// CHECK-SAME:    CryptoContextT [[CC:[^,]*]],
+// CHECK-SAME:    CiphertextT [[ARG1:[^)]*]]
+// CHECK-SAME:  ) {
+// CHECK-NEXT:      const auto& [[PRECOMP:.*]] = [[CC]]->EvalFastRotationPrecompute([[ARG1]]);
+// CHECK-NEXT:      const auto& [[v1:.*]] = [[CC]]->EvalFastRotation([[ARG1]], 1, [[CC]]->GetCyclotomicOrder(), [[PRECOMP]]);
+// CHECK-NEXT:      const auto& [[v2:.*]] = [[CC]]->EvalFastRotation([[ARG1]], 2, [[CC]]->GetCyclotomicOrder(), [[PRECOMP]]);
+// CHECK-NEXT:      const auto& [[v3:.*]] = [[CC]]->EvalAdd([[v1]], [[v2]]);
+// CHECK-NEXT:      return [[v3]];
+// CHECK-NEXT:  }
+func.func @test_fast_rotation(%cc : !cc, %input : !ct) -> !ct {
+  %precomputed = openfhe.fast_rot_precompute %cc, %input : (!cc, !ct) -> !openfhe.digit_decomp
+  %0 = openfhe.fast_rot %cc, %input, %precomputed { index = 1 } : (!cc, !ct, !openfhe.digit_decomp) -> !ct
+  %1 = openfhe.fast_rot %cc, %input, %precomputed { index = 2 } : (!cc, !ct, !openfhe.digit_decomp) -> !ct
+  %2 = openfhe.add %cc, %0, %1 : (!cc, !ct, !ct) -> !ct
+  return %2 : !ct
+}
+
+// -----
+
 #degree_32_poly = #polynomial.int_polynomial<1 + x**32>
 #eval_encoding = #lwe.polynomial_evaluation_encoding<cleartext_start = 16, cleartext_bitwidth = 16>
 #ring2 = #polynomial.ring<coefficientType=!mod_arith.int<463187969:i32>, polynomialModulus=#degree_32_poly>
@@ -121,3 +149,66 @@ func.func @test_constant() -> tensor<2xf32> {
   %cst_2d = arith.constant dense<[[1.5, 2.5]]> : tensor<1x2xf64>
   return %splat : tensor<2xf32>
 }
+
+// CHECK-LABEL: test_release
+// CHECK-NEXT:  CiphertextT [[v0:.*]] = [[CC:.*]]->EvalAdd([[ARG1:.*]], [[ARG2:.*]]);
+// CHECK-NEXT:  const auto& [[v1:.*]] = [[CC]]->EvalMult([[v0]], [[ARG2]]);
+// CHECK-NEXT:  [[v0]].reset();
+// CHECK-NEXT:  return [[v1]];
+func.func @test_release(%cc: !cc, %input1: !ct, %input2: !ct) -> !ct {
+  %add_res = openfhe.add %cc, %input1, %input2 : (!cc, !ct, !ct) -> !ct
+  %mul_res = openfhe.mul %cc, %add_res, %input2 : (!cc, !ct, !ct) -> !ct
+  openfhe.release %add_res : !ct
+  return %mul_res : !ct
+}
+
+// -----
+
+#encoding = #lwe.polynomial_evaluation_encoding<cleartext_start=30, cleartext_bitwidth=3>
+#my_poly = #polynomial.int_polynomial<1 + x**16384>
+#ring= #polynomial.ring<coefficientType=!mod_arith.int<7917:i32>, polynomialModulus=#my_poly>
+!cc = !openfhe.crypto_context
+!pt = !lwe.rlwe_plaintext<encoding = #encoding, ring=#ring, underlying_type=tensor<2xi16>>
+
+// CHECK-LABEL: test_cached_plaintext(
+// CHECK-SAME:    CryptoContextT [[CC:[^)]*]]
+// CHECK:       std::vector<int16_t> [[ints:.*]] = {1, 2};
+// CHECK-NEXT:  static std::map<const void*, std::pair<std::weak_ptr<const void>, PlaintextT>> [[pt:.*]]_cache;
+// CHECK-NEXT:  static std::mutex [[pt]]_mutex;
+// CHECK-NEXT:  PlaintextT [[pt]];
+// CHECK-NEXT:  {
+// CHECK-NEXT:    std::lock_guard<std::mutex> lock([[pt]]_mutex);
+// CHECK-NEXT:    auto cached = [[pt]]_cache.find([[CC]].get());
+// CHECK-NEXT:    if (cached == [[pt]]_cache.end() || cached->second.first.expired()) {
+// CHECK-NEXT:      for (auto entry = [[pt]]_cache.begin(); entry != [[pt]]_cache.end();) {
+// CHECK-NEXT:        entry = entry->second.first.expired() ? [[pt]]_cache.erase(entry) : std::next(entry);
+// CHECK-NEXT:      }
+// CHECK-NEXT:      cached = [[pt]]_cache.insert_or_assign([[CC]].get(), std::make_pair(std::weak_ptr<const void>([[CC]]), [[CC]]->MakePackedPlaintext([[ints]]))).first;
+// CHECK-NEXT:    }
+// CHECK-NEXT:    [[pt]] = cached->second.second;
+// CHECK-NEXT:  }
+// CHECK-NEXT:  return [[pt]];
+func.func @test_cached_plaintext(%cc: !cc) -> !pt {
+  %ints = arith.constant dense<[1, 2]> : tensor<2xi16>
+  %pt = openfhe.make_packed_plaintext %cc, %ints {openfhe.cached} : (!cc, tensor<2xi16>) -> !pt
+  return %pt : !pt
+}
+
+// -----
+
+!params = !openfhe.cc_params
+!cc = !openfhe.crypto_context
+
+// CHECK-LABEL: test_gen_params
+// CHECK:       CCParamsT [[params:.*]];
+// CHECK-NEXT:  [[params]].SetMultiplicativeDepth(2);
+// CHECK-NEXT:  [[params]].SetPlaintextModulus(65537);
+// CHECK-NEXT:  [[params]].SetRingDim(16384);
+// CHECK-NEXT:  [[params]].SetFirstModSize(60);
+// CHECK-NEXT:  [[params]].SetScalingModSize(50);
+// CHECK-NEXT:  CryptoContextT [[cc:.*]] = GenCryptoContext([[params]]);
+func.func @test_gen_params() -> !cc {
+  %params = openfhe.gen_params {mulDepth = 2 : i64, plainMod = 65537 : i64, ringDim = 16384 : i64, firstModSize = 60 : i64, scalingModSize = 50 : i64} : () -> !params
+  %cc = openfhe.gen_context %params : (!params) -> !cc
+  return %cc : !cc
+}
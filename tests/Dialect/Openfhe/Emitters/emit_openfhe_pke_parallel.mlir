@@ -0,0 +1,61 @@
+// RUN: heir-translate %s --emit-openfhe-pke --openfhe-parallel --openfhe-num-threads=8 | FileCheck %s
+
+#encoding = #lwe.polynomial_evaluation_encoding<cleartext_start=30, cleartext_bitwidth=3>
+
+#my_poly = #polynomial.int_polynomial<1 + x**16384>
+#ring= #polynomial.ring<coefficientType=!mod_arith.int<7917:i32>, polynomialModulus=#my_poly>
+#params = #lwe.rlwe_params<dimension=1, ring=#ring>
+!cc = !openfhe.crypto_context
+!ct = !lwe.rlwe_ciphertext<encoding = #encoding, rlwe_params = #params, underlying_type=i3>
+
+// The add, sub and rotation only depend on the inputs and run in parallel.
+// The products of the second level also run in parallel, and the last
+// addition runs alone.
+// CHECK-LABEL: CiphertextT test_parallel_emitter(
+// CHECK-SAME:    CryptoContextT [[CC:[^,]*]],
+// CHECK-SAME:    CiphertextT [[ARG1:[^,]*]],
+// CHECK-SAME:    CiphertextT [[ARG2:[^)]*]]
+// CHECK-SAME:  ) {
+// CHECK-NEXT:      CiphertextT [[v1:.*]];
+// CHECK-NEXT:      CiphertextT [[v2:.*]];
+// CHECK-NEXT:      CiphertextT [[v3:.*]];
+// CHECK-NEXT:      #pragma omp parallel sections num_threads(8)
+// CHECK-NEXT:      {
+// CHECK-NEXT:        #pragma omp section
+// CHECK-NEXT:        {
+// CHECK-NEXT:          [[v1]] = [[CC]]->EvalAdd([[ARG1]], [[ARG2]]);
+// CHECK-NEXT:        }
+// CHECK-NEXT:        #pragma omp section
+// CHECK-NEXT:        {
+// CHECK-NEXT:          [[v2]] = [[CC]]->EvalSub([[ARG1]], [[ARG2]]);
+// CHECK-NEXT:        }
+// CHECK-NEXT:        #pragma omp section
+// CHECK-NEXT:        {
+// CHECK-NEXT:          [[v3]] = [[CC]]->EvalRotate([[ARG1]], 1);
+// CHECK-NEXT:        }
+// CHECK-NEXT:      }
+// CHECK-NEXT:      CiphertextT [[v4:.*]];
+// CHECK-NEXT:      CiphertextT [[v5:.*]];
+// CHECK-NEXT:      #pragma omp parallel sections num_threads(8)
+// CHECK-NEXT:      {
+// CHECK-NEXT:        #pragma omp section
+// CHECK-NEXT:        {
+// CHECK-NEXT:          [[v4]] = [[CC]]->EvalMult([[v1]], [[v2]]);
+// CHECK-NEXT:        }
+// CHECK-NEXT:        #pragma omp section
+// CHECK-NEXT:        {
+// CHECK-NEXT:          [[v5]] = [[CC]]->EvalMult([[v3]], [[v3]]);
+// CHECK-NEXT:        }
+// CHECK-NEXT:      }
+// CHECK-NEXT:      const auto& [[v6:.*]] = [[CC]]->EvalAdd([[v4]], [[v5]]);
+// CHECK-NEXT:      return [[v6]];
+// CHECK-NEXT:  }
+func.func @test_parallel_emitter(%cc : !cc, %input1 : !ct, %input2 : !ct) -> !ct {
+  %add_res = openfhe.add %cc, %input1, %input2 : (!cc, !ct, !ct) -> !ct
+  %sub_res = openfhe.sub %cc, %input1, %input2 : (!cc, !ct, !ct) -> !ct
+  %rot_res = openfhe.rot %cc, %input1 { index = 1 } : (!cc, !ct) -> !ct
+  %mul_res = openfhe.mul %cc, %add_res, %sub_res : (!cc, !ct, !ct) -> !ct
+  %square_res = openfhe.mul %cc, %rot_res, %rot_res : (!cc, !ct, !ct) -> !ct
+  %res = openfhe.add %cc, %mul_res, %square_res : (!cc, !ct, !ct) -> !ct
+  return %res : !ct
+}
@@ -100,6 +100,14 @@ module {
     return
   }
 
+  // CHECK-LABEL: func @test_fast_rot
+  func.func @test_fast_rot(%cc : !cc, %pt : !pt, %pk: !pk) {
+    %ct = openfhe.encrypt %cc, %pt, %pk : (!cc, !pt, !pk) -> !ct
+    %precomputed = openfhe.fast_rot_precompute %cc, %ct : (!cc, !ct) -> !openfhe.digit_decomp
+    %out = openfhe.fast_rot %cc, %ct, %precomputed { index = 2 }: (!cc, !ct, !openfhe.digit_decomp) -> !ct
+    return
+  }
+
   // CHECK-LABEL: func @test_automorph
   func.func @test_automorph(%cc : !cc, %pt : !pt, %ek: !ek, %pk: !pk) {
     %ct = openfhe.encrypt %cc, %pt, %pk : (!cc, !pt, !pk) -> !ct
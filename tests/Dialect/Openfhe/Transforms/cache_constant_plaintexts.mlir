@@ -0,0 +1,22 @@
+// RUN: heir-opt --openfhe-cache-constant-plaintexts %s | FileCheck %s
+
+#encoding = #lwe.polynomial_evaluation_encoding<cleartext_start = 16, cleartext_bitwidth = 16>
+#ideal = #polynomial.int_polynomial<1 + x**32>
+#ring= #polynomial.ring<coefficientType=!mod_arith.int<463187969:i32>, polynomialModulus=#ideal>
+!pt_ty = !lwe.rlwe_plaintext<encoding = #encoding, ring = #ring, underlying_type = tensor<32xi16>>
+!ctxt_ty = !openfhe.crypto_context
+
+// The constant mask is encoded once per crypto context, while the encoding of
+// the argument depends on each call.
+// CHECK: func.func @cache_constant_plaintexts
+// CHECK:      openfhe.make_packed_plaintext %{{.*}}, %{{.*}} {openfhe.cached}
+// CHECK:      openfhe.make_packed_plaintext
+// CHECK-NOT:  openfhe.cached
+// CHECK:      return
+func.func @cache_constant_plaintexts(%arg0: !ctxt_ty, %arg1: tensor<32xi16>) -> (!pt_ty, !pt_ty) {
+  %cst = arith.constant dense<1> : tensor<32xi8>
+  %mask = arith.extsi %cst : tensor<32xi8> to tensor<32xi16>
+  %0 = openfhe.make_packed_plaintext %arg0, %mask : (!ctxt_ty, tensor<32xi16>) -> !pt_ty
+  %1 = openfhe.make_packed_plaintext %arg0, %arg1 : (!ctxt_ty, tensor<32xi16>) -> !pt_ty
+  return %0, %1 : !pt_ty, !pt_ty
+}
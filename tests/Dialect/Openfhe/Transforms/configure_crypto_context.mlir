@@ -37,6 +37,8 @@ func.func @simple_sum(%arg0: !ctxt_ty, %arg1: !in_ty) -> !out_ty {
 // CHECK: @simple_sum
 // CHECK: @simple_sum__generate_crypto_context
 // CHECK: mulDepth = 1
+// OpenFHE picks the ring dimension of BGV.
+// CHECK-NOT: ringDim = {{[1-9]}}
 
 // CHECK: @simple_sum__configure_crypto_context
 // CHECK: openfhe.gen_mulkey
@@ -0,0 +1,65 @@
+// RUN: heir-opt --openfhe-configure-crypto-context=entry-function=ckks_func --split-input-file --verify-diagnostics %s | FileCheck %s
+
+#encoding = #lwe.inverse_canonical_embedding_encoding<cleartext_start = 4, cleartext_bitwidth = 4>
+#ideal = #polynomial.int_polynomial<1 + x**32>
+#ring= #polynomial.ring<coefficientType=!mod_arith.int<463187969:i32>, polynomialModulus=#ideal>
+#params = #lwe.rlwe_params<ring=#ring>
+!ct_ty = !lwe.rlwe_ciphertext<encoding = #encoding, rlwe_params = #params, underlying_type = tensor<16xf32>>
+!ctxt_ty = !openfhe.crypto_context
+
+// A single product of fresh ciphertexts needs a 22-bit scaling modulus.
+// CHECK: @ckks_func__generate_crypto_context
+// CHECK: openfhe.gen_params
+// CHECK-SAME: firstModSize = 32
+// CHECK-SAME: mulDepth = 1
+// CHECK-SAME: ringDim = 4096
+// CHECK-SAME: scalingModSize = 22
+func.func @ckks_func(%cc: !ctxt_ty, %x: !ct_ty, %y: !ct_ty) -> !ct_ty {
+  %0 = openfhe.mul %cc, %x, %y : (!ctxt_ty, !ct_ty, !ct_ty) -> !ct_ty
+  return %0 : !ct_ty
+}
+
+// -----
+
+#encoding = #lwe.inverse_canonical_embedding_encoding<cleartext_start = 4, cleartext_bitwidth = 4>
+#ideal = #polynomial.int_polynomial<1 + x**32>
+#ring= #polynomial.ring<coefficientType=!mod_arith.int<463187969:i32>, polynomialModulus=#ideal>
+#params = #lwe.rlwe_params<ring=#ring>
+!ct_ty = !lwe.rlwe_ciphertext<encoding = #encoding, rlwe_params = #params, underlying_type = tensor<16xf32>>
+!ctxt_ty = !openfhe.crypto_context
+
+// Four successive squares need a longer chain of larger moduli, which only
+// fits a larger ring dimension, and the first modulus is capped at 60 bits.
+// CHECK: @ckks_func__generate_crypto_context
+// CHECK: openfhe.gen_params
+// CHECK-SAME: firstModSize = 60
+// CHECK-SAME: mulDepth = 4
+// CHECK-SAME: ringDim = 16384
+// CHECK-SAME: scalingModSize = 51
+func.func @ckks_func(%cc: !ctxt_ty, %x: !ct_ty) -> !ct_ty {
+  %0 = openfhe.mul %cc, %x, %x : (!ctxt_ty, !ct_ty, !ct_ty) -> !ct_ty
+  %1 = openfhe.mul %cc, %0, %0 : (!ctxt_ty, !ct_ty, !ct_ty) -> !ct_ty
+  %2 = openfhe.mul %cc, %1, %1 : (!ctxt_ty, !ct_ty, !ct_ty) -> !ct_ty
+  %3 = openfhe.mul %cc, %2, %2 : (!ctxt_ty, !ct_ty, !ct_ty) -> !ct_ty
+  return %3 : !ct_ty
+}
+
+// -----
+
+#encoding = #lwe.inverse_canonical_embedding_encoding<cleartext_start = 48, cleartext_bitwidth = 48>
+#ideal = #polynomial.int_polynomial<1 + x**32>
+#ring= #polynomial.ring<coefficientType=!mod_arith.int<463187969:i32>, polynomialModulus=#ideal>
+#params = #lwe.rlwe_params<ring=#ring>
+!ct_ty = !lwe.rlwe_ciphertext<encoding = #encoding, rlwe_params = #params, underlying_type = tensor<16xf32>>
+!ctxt_ty = !openfhe.crypto_context
+
+// 48 bits of precision on top of the noise need a scaling modulus larger than
+// OpenFHE supports, so the parameters are left to OpenFHE.
+// CHECK: @ckks_func__generate_crypto_context
+// CHECK: openfhe.gen_params
+// CHECK-NOT: ringDim = {{[1-9]}}
+// expected-warning@below {{no secure ring dimension fits the estimated noise}}
+func.func @ckks_func(%cc: !ctxt_ty, %x: !ct_ty, %y: !ct_ty) -> !ct_ty {
+  %0 = openfhe.mul %cc, %x, %y : (!ctxt_ty, !ct_ty, !ct_ty) -> !ct_ty
+  return %0 : !ct_ty
+}
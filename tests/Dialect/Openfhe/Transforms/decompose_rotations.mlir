@@ -0,0 +1,51 @@
+// RUN: heir-opt --openfhe-decompose-rotations=key-budget=4 %s | FileCheck %s
+// RUN: heir-opt --openfhe-decompose-rotations=key-budget=2 --verify-diagnostics %s | FileCheck %s --check-prefix=CHECK-TIGHT
+
+#encoding = #lwe.polynomial_evaluation_encoding<cleartext_start = 16, cleartext_bitwidth = 16>
+#ideal = #polynomial.int_polynomial<1 + x**32>
+#ring= #polynomial.ring<coefficientType=!mod_arith.int<463187969:i32>, polynomialModulus=#ideal>
+#params = #lwe.rlwe_params<ring=#ring>
+!ct_ty = !lwe.rlwe_ciphertext<encoding = #encoding, rlwe_params = #params, underlying_type = tensor<32xi16>>
+!ctxt_ty = !openfhe.crypto_context
+
+// The six distinct shifts exceed the budget. The binary basis {1, 2, 4} needs
+// 11 rotations, and beats radix 4, which needs the keys {1, 2, 3, 4} and 9
+// rotations. NAF would need 6 keys.
+// CHECK: func.func @decompose(%[[CC:.*]]: !openfhe.crypto_context, %[[CT:.*]]: [[CT_TY:.*]]) -> [[CT_TY]] {
+// CHECK:      openfhe.rot %[[CC]], %[[CT]] {index = 1 : i64}
+// CHECK:      openfhe.rot %[[CC]], %[[CT]] {index = 2 : i64}
+// CHECK:      %[[R3_0:.*]] = openfhe.rot %[[CC]], %[[CT]] {index = 1 : i64}
+// CHECK:      openfhe.rot %[[CC]], %[[R3_0]] {index = 2 : i64}
+// CHECK:      %[[R5_0:.*]] = openfhe.rot %[[CC]], %[[CT]] {index = 1 : i64}
+// CHECK:      openfhe.rot %[[CC]], %[[R5_0]] {index = 4 : i64}
+// CHECK:      %[[R6_0:.*]] = openfhe.rot %[[CC]], %[[CT]] {index = 2 : i64}
+// CHECK:      openfhe.rot %[[CC]], %[[R6_0]] {index = 4 : i64}
+// CHECK:      %[[R7_0:.*]] = openfhe.rot %[[CC]], %[[CT]] {index = 1 : i64}
+// CHECK:      %[[R7_1:.*]] = openfhe.rot %[[CC]], %[[R7_0]] {index = 2 : i64}
+// CHECK:      openfhe.rot %[[CC]], %[[R7_1]] {index = 4 : i64}
+// CHECK-NOT:  index = 3
+// CHECK:      return
+
+// With a budget of two keys, no basis fits, and the binary basis needs the
+// fewest keys.
+// CHECK-TIGHT: func.func @decompose
+// CHECK-TIGHT-NOT:  index = 3
+// CHECK-TIGHT:      return
+
+// expected-warning@below {{no rotation basis fits the key budget of 2 keys}}
+module {
+func.func @decompose(%arg0: !ctxt_ty, %arg1: !ct_ty) -> !ct_ty {
+  %0 = openfhe.rot %arg0, %arg1 { index = 1 } : (!ctxt_ty, !ct_ty) -> !ct_ty
+  %1 = openfhe.rot %arg0, %arg1 { index = 2 } : (!ctxt_ty, !ct_ty) -> !ct_ty
+  %2 = openfhe.rot %arg0, %arg1 { index = 3 } : (!ctxt_ty, !ct_ty) -> !ct_ty
+  %3 = openfhe.rot %arg0, %arg1 { index = 5 } : (!ctxt_ty, !ct_ty) -> !ct_ty
+  %4 = openfhe.rot %arg0, %arg1 { index = 6 } : (!ctxt_ty, !ct_ty) -> !ct_ty
+  %5 = openfhe.rot %arg0, %arg1 { index = 7 } : (!ctxt_ty, !ct_ty) -> !ct_ty
+  %6 = openfhe.add %arg0, %0, %1 : (!ctxt_ty, !ct_ty, !ct_ty) -> !ct_ty
+  %7 = openfhe.add %arg0, %2, %3 : (!ctxt_ty, !ct_ty, !ct_ty) -> !ct_ty
+  %8 = openfhe.add %arg0, %4, %5 : (!ctxt_ty, !ct_ty, !ct_ty) -> !ct_ty
+  %9 = openfhe.add %arg0, %6, %7 : (!ctxt_ty, !ct_ty, !ct_ty) -> !ct_ty
+  %10 = openfhe.add %arg0, %9, %8 : (!ctxt_ty, !ct_ty, !ct_ty) -> !ct_ty
+  return %10 : !ct_ty
+}
+}
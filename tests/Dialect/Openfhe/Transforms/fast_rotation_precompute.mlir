@@ -0,0 +1,42 @@
+// RUN: heir-opt --openfhe-fast-rotation-precompute %s | FileCheck %s
+
+#encoding = #lwe.polynomial_evaluation_encoding<cleartext_start = 16, cleartext_bitwidth = 16>
+#ideal = #polynomial.int_polynomial<1 + x**32>
+#ring= #polynomial.ring<coefficientType=!mod_arith.int<463187969:i32>, polynomialModulus=#ideal>
+#params = #lwe.rlwe_params<ring=#ring>
+!ct_ty = !lwe.rlwe_ciphertext<encoding = #encoding, rlwe_params = #params, underlying_type = tensor<32xi16>>
+!ctxt_ty = !openfhe.crypto_context
+
+// The three rotations of %arg1 share one decomposition.
+// CHECK: func.func @hoist_rotations(%[[CC:.*]]: !openfhe.crypto_context, %[[CT:.*]]: [[CT_TY:.*]]) -> [[CT_TY]] {
+// CHECK:      %[[PRECOMP:.*]] = openfhe.fast_rot_precompute %[[CC]], %[[CT]]
+// CHECK-NOT:  openfhe.fast_rot_precompute
+// CHECK:      %[[R1:.*]] = openfhe.fast_rot %[[CC]], %[[CT]], %[[PRECOMP]] {index = 1 : i64}
+// CHECK:      %[[R2:.*]] = openfhe.fast_rot %[[CC]], %[[CT]], %[[PRECOMP]] {index = 2 : i64}
+// CHECK:      openfhe.add %[[CC]], %[[R1]], %[[R2]]
+// CHECK:      %[[R3:.*]] = openfhe.fast_rot %[[CC]], %[[CT]], %[[PRECOMP]] {index = 3 : i64}
+// CHECK-NOT:  openfhe.rot
+// CHECK:      return
+func.func @hoist_rotations(%arg0: !ctxt_ty, %arg1: !ct_ty) -> !ct_ty {
+  %0 = openfhe.rot %arg0, %arg1 { index = 1 } : (!ctxt_ty, !ct_ty) -> !ct_ty
+  %1 = openfhe.rot %arg0, %arg1 { index = 2 } : (!ctxt_ty, !ct_ty) -> !ct_ty
+  %2 = openfhe.add %arg0, %0, %1 : (!ctxt_ty, !ct_ty, !ct_ty) -> !ct_ty
+  %3 = openfhe.rot %arg0, %arg1 { index = 3 } : (!ctxt_ty, !ct_ty) -> !ct_ty
+  %4 = openfhe.add %arg0, %2, %3 : (!ctxt_ty, !ct_ty, !ct_ty) -> !ct_ty
+  return %4 : !ct_ty
+}
+
+// Each ciphertext of a rotate-and-reduce chain is rotated once, so nothing
+// is shared.
+// CHECK: func.func @single_rotations
+// CHECK-NOT:  openfhe.fast_rot
+// CHECK:      openfhe.rot
+// CHECK:      openfhe.rot
+// CHECK-NOT:  openfhe.fast_rot
+func.func @single_rotations(%arg0: !ctxt_ty, %arg1: !ct_ty) -> !ct_ty {
+  %0 = openfhe.rot %arg0, %arg1 { index = 16 } : (!ctxt_ty, !ct_ty) -> !ct_ty
+  %1 = openfhe.add %arg0, %arg1, %0 : (!ctxt_ty, !ct_ty, !ct_ty) -> !ct_ty
+  %2 = openfhe.rot %arg0, %1 { index = 8 } : (!ctxt_ty, !ct_ty) -> !ct_ty
+  %3 = openfhe.add %arg0, %1, %2 : (!ctxt_ty, !ct_ty, !ct_ty) -> !ct_ty
+  return %3 : !ct_ty
+}
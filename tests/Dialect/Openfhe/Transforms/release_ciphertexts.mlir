@@ -0,0 +1,45 @@
+// RUN: heir-opt --openfhe-release-ciphertexts=report-peak=true --verify-diagnostics %s | FileCheck %s
+// RUN: heir-opt --openfhe-release-ciphertexts --openfhe-release-ciphertexts=report-peak=true --verify-diagnostics %s | FileCheck %s
+
+#encoding = #lwe.polynomial_evaluation_encoding<cleartext_start = 16, cleartext_bitwidth = 16>
+#ideal = #polynomial.int_polynomial<1 + x**32>
+#ring= #polynomial.ring<coefficientType=!mod_arith.int<463187969:i32>, polynomialModulus=#ideal>
+#params = #lwe.rlwe_params<ring=#ring>
+!in_ty = !lwe.rlwe_ciphertext<encoding = #encoding, rlwe_params = #params, underlying_type = tensor<32xi16>>
+!out_ty = !lwe.rlwe_ciphertext<encoding = #encoding, rlwe_params = #params, underlying_type = i16>
+!ctxt_ty = !openfhe.crypto_context
+
+// CHECK: @rotate_and_sum
+// CHECK-SAME: (%[[CC:.*]]: !openfhe.crypto_context, %[[ARG:[^:]*]]:
+// CHECK-NEXT: %[[V0:.*]] = openfhe.rot %[[CC]], %[[ARG]]
+// CHECK-NEXT: %[[V1:.*]] = openfhe.add %[[CC]], %[[ARG]], %[[V0]]
+// CHECK-NEXT: openfhe.release %[[V0]]
+// CHECK-NEXT: %[[V2:.*]] = openfhe.rot %[[CC]], %[[V1]]
+// CHECK-NEXT: %[[V3:.*]] = openfhe.add %[[CC]], %[[V1]], %[[V2]]
+// CHECK-NEXT: openfhe.release %[[V1]]
+// CHECK-NEXT: openfhe.release %[[V2]]
+// CHECK-NEXT: return %[[V3]]
+// expected-remark@below {{peak of 3 live ciphertexts, down from 4}}
+func.func @rotate_and_sum(%arg0: !ctxt_ty, %arg1: !in_ty) -> !in_ty {
+  %0 = openfhe.rot %arg0, %arg1 { index = 16 } : (!ctxt_ty, !in_ty) -> !in_ty
+  %1 = openfhe.add %arg0, %arg1, %0 : (!ctxt_ty, !in_ty, !in_ty) -> !in_ty
+  %2 = openfhe.rot %arg0, %1 { index = 8 } : (!ctxt_ty, !in_ty) -> !in_ty
+  %3 = openfhe.add %arg0, %1, %2 : (!ctxt_ty, !in_ty, !in_ty) -> !in_ty
+  return %3 : !in_ty
+}
+
+// The reinterpreted ciphertext refers to the variable of %0, which is
+// released after the last use of either.
+// CHECK: @release_through_reinterpret
+// CHECK: %[[V0:.*]] = openfhe.rot
+// CHECK-NEXT: %[[V1:.*]] = lwe.reinterpret_underlying_type %[[V0]]
+// CHECK-NEXT: %[[V2:.*]] = openfhe.rot %{{.*}}, %[[V1]]
+// CHECK-NEXT: openfhe.release %[[V0]]
+// CHECK-NEXT: return %[[V2]]
+// expected-remark@below {{peak of 2 live ciphertexts, down from 2}}
+func.func @release_through_reinterpret(%arg0: !ctxt_ty, %arg1: !in_ty) -> !out_ty {
+  %0 = openfhe.rot %arg0, %arg1 { index = 16 } : (!ctxt_ty, !in_ty) -> !in_ty
+  %1 = lwe.reinterpret_underlying_type %0 : !in_ty to !out_ty
+  %2 = openfhe.rot %arg0, %1 { index = 8 } : (!ctxt_ty, !out_ty) -> !out_ty
+  return %2 : !out_ty
+}
@@ -1,8 +1,10 @@
 // RUN: heir-opt --polynomial-to-mod-arith %s | FileCheck %s
 
-#cycl_2048 = #polynomial.int_polynomial<1 + x**1024>
+// Products in rings with polynomial modulus x^n + 1 or x^n - 1 are reduced
+// without a division, see lower_mul_folded.mlir.
+#ideal_2048 = #polynomial.int_polynomial<3 + x**1024>
 !coeff_ty = !mod_arith.int<65536:i32>
-#ring = #polynomial.ring<coefficientType=!coeff_ty, polynomialModulus=#cycl_2048>
+#ring = #polynomial.ring<coefficientType=!coeff_ty, polynomialModulus=#ideal_2048>
 !poly_ty = !polynomial.polynomial<ring=#ring>
 
 // CHECK: #[[LHS_MAP:.*]] = affine_map<(d0, d1) -> (d0)>
@@ -18,15 +20,14 @@
 // CHECK-SAME:     ins(%[[generic_arg0:.*]], %[[generic_arg1:.*]] : [[INPUT_TENSOR_TY]], [[INPUT_TENSOR_TY]])
 // CHECK-SAME:     outs(%[[NAIVE_POLYMUL_OUTPUT]] : [[NAIVE_POLYMUL_TENSOR_TY]])
 // CHECK:     ^[[BB0:.*]](%[[LHS_IN:.*]]: [[COEFF_TY:!mod_arith.int<65536 : i32>]], %[[RHS_IN:.*]]: [[COEFF_TY]], %[[OUT:.*]]: [[COEFF_TY]]):
-// CHECK:       %[[MULTED:.*]] = mod_arith.mul %[[LHS_IN]], %[[RHS_IN]]
-// CHECK:       %[[SUMMED:.*]] = mod_arith.add %[[MULTED]], %[[OUT]]
+// CHECK:       %[[SUMMED:.*]] = mod_arith.mac %[[LHS_IN]], %[[RHS_IN]], %[[OUT]]
 // CHECK:       linalg.yield %[[SUMMED]]
 // CHECK:     } -> [[NAIVE_POLYMUL_TENSOR_TY]]
-// CHECK:     %[[MODDED_RESULT:.*]] = call @__heir_poly_mod_65536_i32_1_x1024(%[[GENERIC_RESULT]]) : ([[NAIVE_POLYMUL_TENSOR_TY]]) -> [[INPUT_TENSOR_TY]]
+// CHECK:     %[[MODDED_RESULT:.*]] = call @__heir_poly_mod_65536_i32_3_x1024(%[[GENERIC_RESULT]]) : ([[NAIVE_POLYMUL_TENSOR_TY]]) -> [[INPUT_TENSOR_TY]]
 // CHECK:     return %[[MODDED_RESULT]]
 // CHECK: }
 
-// CHECK: func.func private @__heir_poly_mod_65536_i32_1_x1024(%[[MOD_ARG0:.*]]: [[NAIVE_POLYMUL_TENSOR_TY]]) -> [[INPUT_TENSOR_TY]] attributes {llvm.linkage = #llvm.linkage<linkonce_odr>} {
+// CHECK: func.func private @__heir_poly_mod_65536_i32_3_x1024(%[[MOD_ARG0:.*]]: [[NAIVE_POLYMUL_TENSOR_TY]]) -> [[INPUT_TENSOR_TY]] attributes {llvm.linkage = #llvm.linkage<linkonce_odr>} {
 // CHECK:    %[[c1_modarith:.*]] = mod_arith.constant 1 : [[COEFF_TY]]
 // CHECK:    %[[c1024:.*]] = arith.constant 1024 : index
 // CHECK:    %[[rem_result:.*]] = scf.while (%[[WHILE_ARG1:.*]] = %[[MOD_ARG0]]) : ([[NAIVE_POLYMUL_TENSOR_TY]]) -> [[NAIVE_POLYMUL_TENSOR_TY]] {
@@ -48,7 +49,7 @@
 // CHECK:      scf.condition(%[[CMP1]]) %[[WHILE_ARG1]]
 // CHECK:    } do {
 // CHECK:    ^[[bb0:.*]](%[[DIVIDEND:.*]]: [[NAIVE_POLYMUL_TENSOR_TY]]):
-// CHECK:      %[[DIVISOR:.*]] = arith.constant dense<"0x[[DIVISOR_COEFFS:010*10*]]"> : tensor<2047xi32>
+// CHECK:      %[[DIVISOR:.*]] = arith.constant dense<"0x[[DIVISOR_COEFFS:030*10*]]"> : tensor<2047xi32>
 // CHECK:      %[[DIVISOR_MODARITH:.*]] = mod_arith.encapsulate %[[DIVISOR]]
 // CHECK:      %[[c0_i32:.*]] = arith.constant 0 : i32
 // CHECK:      %[[c1:.*]] = arith.constant 1 : index
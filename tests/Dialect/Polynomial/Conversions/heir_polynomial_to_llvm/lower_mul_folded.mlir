@@ -0,0 +1,56 @@
+// RUN: heir-opt --polynomial-to-mod-arith %s | FileCheck %s
+
+!coeff_ty = !mod_arith.int<17:i32>
+#negacyclic = #polynomial.int_polynomial<1 + x**4>
+#negacyclic_ring = #polynomial.ring<coefficientType=!coeff_ty, polynomialModulus=#negacyclic>
+!negacyclic_poly_ty = !polynomial.polynomial<ring=#negacyclic_ring>
+#cyclic = #polynomial.int_polynomial<-1 + x**4>
+#cyclic_ring = #polynomial.ring<coefficientType=!coeff_ty, polynomialModulus=#cyclic>
+!cyclic_poly_ty = !polynomial.polynomial<ring=#cyclic_ring>
+
+// CHECK-DAG: #[[LHS_MAP:.*]] = affine_map<(d0, d1) -> (d1)>
+// CHECK-DAG: #[[RHS_MAP:.*]] = affine_map<(d0, d1) -> (d0 - d1 + 4)>
+// CHECK-DAG: #[[OUTPUT_MAP:.*]] = affine_map<(d0, d1) -> (d0)>
+
+// CHECK-NOT: func.func private @__heir_poly_mod
+
+// The upper coefficients of a product in x^n + 1 fold onto the lower ones with
+// a sign flip, so the lower half of the extended rhs is negated.
+// CHECK: func.func @lower_negacyclic_mul(%[[poly0:.*]]: [[TENSOR_TY:tensor<4x!mod_arith.int<17 : i32>>]], %[[poly1:.*]]: [[TENSOR_TY]]) -> [[TENSOR_TY]] {
+// CHECK:      %[[ZEROS_STORAGE:.*]] = arith.constant dense<0> : tensor<4xi32>
+// CHECK:      %[[ZEROS:.*]] = mod_arith.encapsulate %[[ZEROS_STORAGE]] : tensor<4xi32> -> [[TENSOR_TY]]
+// CHECK:      %[[NEG:.*]] = mod_arith.sub %[[ZEROS]], %[[poly1]] : [[TENSOR_TY]]
+// CHECK:      %[[EMPTY:.*]] = tensor.empty() : [[EXT_TY:tensor<8x!mod_arith.int<17 : i32>>]]
+// CHECK:      %[[LOWER:.*]] = tensor.insert_slice %[[NEG]] into %[[EMPTY]][0] [4] [1]
+// CHECK:      %[[EXT:.*]] = tensor.insert_slice %[[poly1]] into %[[LOWER]][4] [4] [1]
+// CHECK:      %[[ACC:.*]] = mod_arith.encapsulate
+// CHECK:      %[[RES:.*]] = linalg.generic
+// CHECK-SAME:     indexing_maps = [#[[LHS_MAP]], #[[RHS_MAP]], #[[OUTPUT_MAP]]]
+// CHECK-SAME:     iterator_types = ["parallel", "reduction"]
+// CHECK-SAME:     ins(%[[poly0]], %[[EXT]] : [[TENSOR_TY]], [[EXT_TY]])
+// CHECK-SAME:     outs(%[[ACC]] : [[TENSOR_TY]])
+// CHECK:     ^[[BB0:.*]](%[[LHS_IN:.*]]: [[COEFF_TY:!mod_arith.int<17 : i32>]], %[[RHS_IN:.*]]: [[COEFF_TY]], %[[OUT:.*]]: [[COEFF_TY]]):
+// CHECK:       %[[SUMMED:.*]] = mod_arith.mac %[[LHS_IN]], %[[RHS_IN]], %[[OUT]]
+// CHECK:       linalg.yield %[[SUMMED]]
+// CHECK:     } -> [[TENSOR_TY]]
+// CHECK-NOT: call
+// CHECK:     return %[[RES]]
+func.func @lower_negacyclic_mul(%poly0: !negacyclic_poly_ty, %poly1: !negacyclic_poly_ty) -> !negacyclic_poly_ty {
+  %poly2 = polynomial.mul %poly0, %poly1 : !negacyclic_poly_ty
+  return %poly2 : !negacyclic_poly_ty
+}
+
+// CHECK: func.func @lower_cyclic_mul(%[[poly0:.*]]: [[TENSOR_TY:.*]], %[[poly1:.*]]: [[TENSOR_TY]]) -> [[TENSOR_TY]] {
+// CHECK-NOT:  mod_arith.sub
+// CHECK:      %[[EMPTY:.*]] = tensor.empty()
+// CHECK:      %[[LOWER:.*]] = tensor.insert_slice %[[poly1]] into %[[EMPTY]][0] [4] [1]
+// CHECK:      %[[EXT:.*]] = tensor.insert_slice %[[poly1]] into %[[LOWER]][4] [4] [1]
+// CHECK:      %[[RES:.*]] = linalg.generic
+// CHECK-SAME:     indexing_maps = [#[[LHS_MAP]], #[[RHS_MAP]], #[[OUTPUT_MAP]]]
+// CHECK-SAME:     ins(%[[poly0]], %[[EXT]]
+// CHECK-NOT: call
+// CHECK:     return %[[RES]]
+func.func @lower_cyclic_mul(%poly0: !cyclic_poly_ty, %poly1: !cyclic_poly_ty) -> !cyclic_poly_ty {
+  %poly2 = polynomial.mul %poly0, %poly1 : !cyclic_poly_ty
+  return %poly2 : !cyclic_poly_ty
+}
@@ -0,0 +1,60 @@
+// RUN: heir-opt --polynomial-to-mod-arith=karatsuba-threshold=2 %s | FileCheck %s
+
+!coeff_ty = !mod_arith.int<65536:i32>
+#ideal = #polynomial.int_polynomial<3 + x**4>
+#ring = #polynomial.ring<coefficientType=!coeff_ty, polynomialModulus=#ideal>
+!poly_ty = !polynomial.polynomial<ring=#ring>
+#negacyclic = #polynomial.int_polynomial<1 + x**4>
+#negacyclic_ring = #polynomial.ring<coefficientType=!coeff_ty, polynomialModulus=#negacyclic>
+!negacyclic_poly_ty = !polynomial.polynomial<ring=#negacyclic_ring>
+
+// CHECK: func.func @lower_karatsuba_mul(%[[poly0:.*]]: [[TENSOR_TY:.*]], %[[poly1:.*]]: [[TENSOR_TY]]) -> [[TENSOR_TY]] {
+// CHECK-NOT:  linalg.generic
+// CHECK:      %[[PRODUCT:.*]] = call @__heir_poly_karatsuba_65536_i32_4(%[[poly0]], %[[poly1]])
+// CHECK:      %[[RES:.*]] = call @__heir_poly_mod_65536_i32_3_x4(%[[PRODUCT]])
+// CHECK:      return %[[RES]]
+func.func @lower_karatsuba_mul(%poly0: !poly_ty, %poly1: !poly_ty) -> !poly_ty {
+  %poly2 = polynomial.mul %poly0, %poly1 : !poly_ty
+  return %poly2 : !poly_ty
+}
+
+// The product is folded in place of the reduction modulo x^4 + 1.
+// CHECK: func.func @lower_negacyclic_karatsuba_mul(%[[poly0:.*]]: [[TENSOR_TY:.*]], %[[poly1:.*]]: [[TENSOR_TY]]) -> [[TENSOR_TY]] {
+// CHECK:      %[[PRODUCT:.*]] = call @__heir_poly_karatsuba_65536_i32_4(%[[poly0]], %[[poly1]])
+// CHECK:      %[[LOWER:.*]] = tensor.extract_slice %[[PRODUCT]][0] [4] [1]
+// CHECK:      %[[UPPER:.*]] = tensor.extract_slice %[[PRODUCT]][4] [3] [1]
+// CHECK:      %[[PADDED:.*]] = tensor.insert_slice %[[UPPER]] into %{{.*}}[0] [3] [1]
+// CHECK:      %[[RES:.*]] = mod_arith.sub %[[LOWER]], %[[PADDED]]
+// CHECK:      return %[[RES]]
+func.func @lower_negacyclic_karatsuba_mul(%poly0: !negacyclic_poly_ty, %poly1: !negacyclic_poly_ty) -> !negacyclic_poly_ty {
+  %poly2 = polynomial.mul %poly0, %poly1 : !negacyclic_poly_ty
+  return %poly2 : !negacyclic_poly_ty
+}
+
+// CHECK: func.func private @__heir_poly_karatsuba_65536_i32_4(%[[A:.*]]: [[INPUT_TY:tensor<4x!mod_arith.int<65536 : i32>>]], %[[B:.*]]: [[INPUT_TY]]) -> [[OUTPUT_TY:tensor<7x!mod_arith.int<65536 : i32>>]]
+// CHECK-NOT:  linalg.generic
+// CHECK-DAG:  %[[A0:.*]] = tensor.extract_slice %[[A]][0] [2] [1]
+// CHECK-DAG:  %[[A1:.*]] = tensor.extract_slice %[[A]][2] [2] [1]
+// CHECK-DAG:  %[[B0:.*]] = tensor.extract_slice %[[B]][0] [2] [1]
+// CHECK-DAG:  %[[B1:.*]] = tensor.extract_slice %[[B]][2] [2] [1]
+// CHECK:      %[[Z0:.*]] = call @__heir_poly_karatsuba_65536_i32_2(%[[A0]], %[[B0]])
+// CHECK:      %[[Z2:.*]] = call @__heir_poly_karatsuba_65536_i32_2(%[[A1]], %[[B1]])
+// CHECK:      %[[A01:.*]] = mod_arith.add %[[A0]], %[[A1]]
+// CHECK:      %[[B01:.*]] = mod_arith.add %[[B0]], %[[B1]]
+// CHECK:      %[[Z1:.*]] = call @__heir_poly_karatsuba_65536_i32_2(%[[A01]], %[[B01]])
+// CHECK:      %[[Z1_0:.*]] = mod_arith.sub %[[Z1]], %[[Z0]]
+// CHECK:      %[[Z1_1:.*]] = mod_arith.sub %[[Z1_0]], %[[Z2]]
+// CHECK:      %[[ACC0:.*]] = tensor.insert_slice %[[Z0]] into %{{.*}}[0] [3] [1]
+// CHECK:      %[[ACC1:.*]] = tensor.insert_slice %[[Z2]] into %[[ACC0]][4] [3] [1]
+// CHECK:      %[[MIDDLE:.*]] = tensor.extract_slice %[[ACC1]][2] [3] [1]
+// CHECK:      %[[SUM:.*]] = mod_arith.add %[[MIDDLE]], %[[Z1_1]]
+// CHECK:      %[[ACC2:.*]] = tensor.insert_slice %[[SUM]] into %[[ACC1]][2] [3] [1]
+// CHECK:      return %[[ACC2]]
+
+// The recursion stops at the threshold with the naive convolution.
+// CHECK: func.func private @__heir_poly_karatsuba_65536_i32_2
+// CHECK:      linalg.generic
+// CHECK-NOT:  call
+// CHECK:      return
+
+// CHECK: func.func private @__heir_poly_mod_65536_i32_3_x4
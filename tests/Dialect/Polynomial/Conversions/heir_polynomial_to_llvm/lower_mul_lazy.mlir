@@ -0,0 +1,33 @@
+// RUN: heir-opt --polynomial-to-mod-arith --mod-arith-to-arith="lazy-reduction=true reduction=barrett" %s | FileCheck %s
+
+!coeff_ty = !mod_arith.int<17:i32>
+#negacyclic = #polynomial.int_polynomial<1 + x**4>
+#negacyclic_ring = #polynomial.ring<coefficientType=!coeff_ty, polynomialModulus=#negacyclic>
+!negacyclic_poly_ty = !polynomial.polynomial<ring=#negacyclic_ring>
+
+// The negated rhs is stored into the extended operand without a reduction.
+// Each term is then accumulated by a mac whose Barrett reduction skips its
+// conditional subtractions, so the loop-carried output stays in [0, 3q) and
+// is only reduced once, after the linalg.generic.
+// CHECK: func.func @lower_negacyclic_mul
+// CHECK-NOT:   arith.select
+// CHECK:       arith.subi
+// CHECK:       arith.addi
+// CHECK-NOT:   arith.select
+// CHECK:       tensor.insert_slice
+// CHECK:       linalg.generic
+// CHECK:       ^{{.*}}(%[[LHS_IN:.*]]: i32, %[[RHS_IN:.*]]: i32, %[[OUT:.*]]: i32):
+// CHECK-NOT:     arith.select
+// CHECK:         %[[MUL:.*]] = arith.muli
+// CHECK:         %[[SUM:.*]] = arith.addi %[[MUL]]
+// CHECK:         arith.shrui %[[SUM]]
+// CHECK-NOT:     arith.select
+// CHECK:         %[[RES:.*]] = arith.trunci
+// CHECK-NEXT:    linalg.yield %[[RES]] : i32
+// CHECK:       } -> tensor<4xi32>
+// CHECK:       arith.select
+// CHECK:       return
+func.func @lower_negacyclic_mul(%poly0: !negacyclic_poly_ty, %poly1: !negacyclic_poly_ty) -> !negacyclic_poly_ty {
+  %poly2 = polynomial.mul %poly0, %poly1 : !negacyclic_poly_ty
+  return %poly2 : !negacyclic_poly_ty
+}
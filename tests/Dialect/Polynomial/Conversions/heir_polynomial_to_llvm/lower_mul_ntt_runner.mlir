@@ -0,0 +1,27 @@
+// RUN: heir-opt %s --convert-polynomial-mul-to-ntt --heir-polynomial-to-llvm \
+// RUN:   | mlir-cpu-runner -e test_poly_mul_ntt -entry-point-result=void \
+// RUN:      --shared-libs="%mlir_lib_dir/libmlir_c_runner_utils%shlibext,%mlir_runner_utils" > %t
+// RUN: FileCheck %s --check-prefix=CHECK_TEST_POLY_MUL_NTT < %t
+
+// 16 divides 7681 - 1, so the multiplication is computed with NTTs.
+#ideal = #polynomial.int_polynomial<1 + x**8>
+!coeff_ty = !mod_arith.int<7681:i32>
+#ring = #polynomial.ring<coefficientType=!coeff_ty, polynomialModulus=#ideal>
+!poly_ty = !polynomial.polynomial<ring=#ring>
+
+func.func private @printMemrefI32(memref<*xi32>) attributes { llvm.emit_c_interface }
+
+func.func @test_poly_mul_ntt() {
+  // 1 - x^5 + x^6 + x^7
+  %0 = polynomial.constant int<1 + x**6> : !poly_ty
+  %1 = polynomial.constant int<1 + x**7> : !poly_ty
+  %2 = polynomial.mul %0, %1 : !poly_ty
+
+  %3 = polynomial.to_tensor %2 : !poly_ty -> tensor<8x!coeff_ty>
+  %ext = mod_arith.extract %3 : tensor<8x!coeff_ty> -> tensor<8xi32>
+  %4 = bufferization.to_memref %ext : tensor<8xi32> to memref<8xi32>
+  %U = memref.cast %4 : memref<8xi32> to memref<*xi32>
+  func.call @printMemrefI32(%U) : (memref<*xi32>) -> ()
+  return
+}
+// CHECK_TEST_POLY_MUL_NTT: [1, 0, 0, 0, 0, 7680, 1, 1]
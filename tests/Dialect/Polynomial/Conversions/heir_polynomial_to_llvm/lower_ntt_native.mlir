@@ -0,0 +1,48 @@
+// RUN: heir-opt --polynomial-to-mod-arith=native-width=true --cse %s | FileCheck %s
+// RUN: heir-opt --polynomial-to-mod-arith="native-width=true shoup-twiddles=true" --cse %s | FileCheck %s --check-prefix=SHOUP
+
+#cycl = #polynomial.int_polynomial<1 + x**4>
+!coeff_ty = !mod_arith.int<7681:i32>
+#ring = #polynomial.ring<coefficientType=!coeff_ty, polynomialModulus=#cycl>
+#root = #polynomial.primitive_root<value=1925:i32, degree=8:i32>
+!poly_ty = !polynomial.polynomial<ring=#ring>
+
+// CHECK: func.func @lower_ntt
+// CHECK-DAG:  %[[CMOD:.*]] = arith.constant 7681 : i32
+// CHECK-DAG:  %[[ROOTS:.*]] = arith.constant dense<[1, 1925, 3383, 6468]> : tensor<4xi32>
+// CHECK-NOT:  tensor<4xi64>
+// CHECK:      affine.for
+// CHECK-SAME:   -> (tensor<4xi32>, index, index)
+// CHECK:            %[[B:.*]] = tensor.extract %{{.*}}[%{{.*}}] : tensor<4xi32>
+// CHECK:            %[[ROOT:.*]] = tensor.extract %[[ROOTS]]
+// CHECK:            %[[B_EXT:.*]] = arith.extui %[[B]] : i32 to i64
+// CHECK:            %[[ROOT_EXT:.*]] = arith.extui %[[ROOT]] : i32 to i64
+// CHECK:            %[[CMOD_EXT:.*]] = arith.extui %[[CMOD]] : i32 to i64
+// CHECK:            %[[PROD:.*]] = arith.muli %[[B_EXT]], %[[ROOT_EXT]] : i64
+// CHECK:            %[[REM:.*]] = arith.remui %[[PROD]], %[[CMOD_EXT]] : i64
+// CHECK:            %[[ROOTB:.*]] = arith.trunci %[[REM]] : i64 to i32
+// CHECK:            arith.addi %{{.*}}, %[[ROOTB]] : i32
+// CHECK-NOT:  arith.trunci
+// CHECK:      return
+
+// SHOUP: func.func @lower_ntt
+// SHOUP-DAG:  %[[CMOD:.*]] = arith.constant 7681 : i32
+// SHOUP-DAG:  %[[SHOUP_ROOTS:.*]] = arith.constant dense<[559167, 1076397870, 1891664413, 3616696845]> : tensor<4xi32>
+// SHOUP-NOT:  i64
+// SHOUP:            %[[B:.*]] = tensor.extract %{{.*}}[%{{.*}}] : tensor<4xi32>
+// SHOUP:            %[[ROOT:.*]] = tensor.extract
+// SHOUP:            %[[SHOUP_ROOT:.*]] = tensor.extract %[[SHOUP_ROOTS]]
+// SHOUP:            %[[LOW:.*]], %[[HIGH:.*]] = arith.mului_extended %[[B]], %[[SHOUP_ROOT]] : i32
+// SHOUP:            %[[PROD:.*]] = arith.muli %[[B]], %[[ROOT]] : i32
+// SHOUP:            %[[QMOD:.*]] = arith.muli %[[HIGH]], %[[CMOD]] : i32
+// SHOUP:            %[[REM:.*]] = arith.subi %[[PROD]], %[[QMOD]] : i32
+// SHOUP:            mod_arith.subifge %[[REM]], %[[CMOD]] : i32
+// SHOUP-NOT:  i64
+// SHOUP:      return
+func.func @lower_ntt() -> tensor<4xi32, #ring> {
+  %coeffsRaw = arith.constant dense<[1, 2, 3, 4]> : tensor<4xi32>
+  %coeffs = mod_arith.encapsulate %coeffsRaw : tensor<4xi32> -> tensor<4x!coeff_ty>
+  %poly = polynomial.from_tensor %coeffs : tensor<4x!coeff_ty> -> !poly_ty
+  %ret = polynomial.ntt %poly {root=#root} : !poly_ty -> tensor<4xi32, #ring>
+  return %ret : tensor<4xi32, #ring>
+}
@@ -0,0 +1,55 @@
+// RUN: heir-opt --polynomial-to-mod-arith=pool-twiddles=true %s | FileCheck %s
+
+#cycl = #polynomial.int_polynomial<1 + x**4>
+!coeff_ty = !mod_arith.int<7681:i32>
+#ring = #polynomial.ring<coefficientType=!coeff_ty, polynomialModulus=#cycl>
+#root = #polynomial.primitive_root<value=1925:i32, degree=8:i32>
+!poly_ty = !polynomial.polynomial<ring=#ring>
+
+// The NTTs share the table of powers of the root, and the INTT has its own
+// table of powers of the inverse root.
+// CHECK-DAG:  memref.global "private" constant @[[NTT_TABLE:.*]] : memref<4xi64> = dense<[1, 1925, 3383, 6468]>
+// CHECK-DAG:  memref.global "private" constant @[[INTT_TABLE:.*]] : memref<4xi64> = dense<[1, 1213, 4298, 5756]>
+// CHECK-NOT:  memref.global
+
+// CHECK: func.func @lower_ntt
+// CHECK-NOT:  arith.constant dense<[1, 1925, 3383, 6468]>
+// CHECK:      %[[GLOBAL:.*]] = memref.get_global @[[NTT_TABLE]] : memref<4xi64>
+// CHECK:      %[[ROOTS:.*]] = bufferization.to_tensor %[[GLOBAL]] restrict
+// CHECK:      affine.for
+// CHECK:        tensor.extract %[[ROOTS]]
+func.func @lower_ntt(%poly: !poly_ty) -> tensor<4xi32, #ring> {
+  %0 = polynomial.ntt %poly {root=#root} : !poly_ty -> tensor<4xi32, #ring>
+  return %0 : tensor<4xi32, #ring>
+}
+
+// CHECK: func.func @lower_ntt_again
+// CHECK:      memref.get_global @[[NTT_TABLE]] : memref<4xi64>
+func.func @lower_ntt_again(%poly: !poly_ty) -> tensor<4xi32, #ring> {
+  %0 = polynomial.ntt %poly {root=#root} : !poly_ty -> tensor<4xi32, #ring>
+  return %0 : tensor<4xi32, #ring>
+}
+
+// CHECK: func.func @lower_intt
+// CHECK:      memref.get_global @[[INTT_TABLE]] : memref<4xi64>
+func.func @lower_intt(%ntt: tensor<4xi32, #ring>) -> !poly_ty {
+  %0 = polynomial.intt %ntt {root=#root} : tensor<4xi32, #ring> -> !poly_ty
+  return %0 : !poly_ty
+}
+
+// Both NTTs read the table through the same restrict tensor, created at the
+// entry of the function.
+// CHECK: func.func @lower_two_ntts
+// CHECK-NEXT: %[[GLOBAL:.*]] = memref.get_global @[[NTT_TABLE]] : memref<4xi64>
+// CHECK-NEXT: %[[ROOTS:.*]] = bufferization.to_tensor %[[GLOBAL]] restrict
+// CHECK-NOT:  bufferization.to_tensor
+// CHECK:      tensor.extract %[[ROOTS]]
+// CHECK-NOT:  bufferization.to_tensor
+// CHECK:      tensor.extract %[[ROOTS]]
+// CHECK-NOT:  bufferization.to_tensor
+// CHECK:      return
+func.func @lower_two_ntts(%p0: !poly_ty, %p1: !poly_ty) -> (tensor<4xi32, #ring>, tensor<4xi32, #ring>) {
+  %0 = polynomial.ntt %p0 {root=#root} : !poly_ty -> tensor<4xi32, #ring>
+  %1 = polynomial.ntt %p1 {root=#root} : !poly_ty -> tensor<4xi32, #ring>
+  return %0, %1 : tensor<4xi32, #ring>, tensor<4xi32, #ring>
+}
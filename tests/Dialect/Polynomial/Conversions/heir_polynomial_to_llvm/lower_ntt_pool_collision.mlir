@@ -0,0 +1,20 @@
+// RUN: heir-opt --polynomial-to-mod-arith=pool-twiddles=true %s | FileCheck %s
+
+#cycl = #polynomial.int_polynomial<1 + x**4>
+!coeff_ty = !mod_arith.int<7681:i32>
+#ring = #polynomial.ring<coefficientType=!coeff_ty, polynomialModulus=#cycl>
+#root = #polynomial.primitive_root<value=1925:i32, degree=8:i32>
+!poly_ty = !polynomial.polynomial<ring=#ring>
+
+// The pooled table is renamed, since its name is already taken.
+// CHECK-DAG:  memref.global "private" constant @[[NTT_TABLE:__heir_ntt_table_0.+]] : memref<4xi64> = dense<[1, 1925, 3383, 6468]>
+// CHECK-DAG:  memref.global "private" constant @__heir_ntt_table_0 : memref<4xi64> = dense<0>
+memref.global "private" constant @__heir_ntt_table_0 : memref<4xi64> = dense<0>
+
+// CHECK: func.func @lower_ntt
+// CHECK:      memref.get_global @[[NTT_TABLE]] : memref<4xi64>
+// CHECK-NOT:  memref.get_global @__heir_ntt_table_0 :
+func.func @lower_ntt(%poly: !poly_ty) -> tensor<4xi32, #ring> {
+  %0 = polynomial.ntt %poly {root=#root} : !poly_ty -> tensor<4xi32, #ring>
+  return %0 : tensor<4xi32, #ring>
+}
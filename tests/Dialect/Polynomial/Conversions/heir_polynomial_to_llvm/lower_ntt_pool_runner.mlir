@@ -0,0 +1,37 @@
+// RUN: heir-opt %s --polynomial-to-mod-arith=pool-twiddles=true --heir-polynomial-to-llvm \
+// RUN:   | mlir-cpu-runner -e test_poly_ntt_pool -entry-point-result=void \
+// RUN:      --shared-libs="%mlir_lib_dir/libmlir_c_runner_utils%shlibext,%mlir_runner_utils" > %t
+// RUN: FileCheck %s --check-prefix=CHECK_TEST_POLY_NTT_POOL < %t
+
+// The same test vectors as lower_ntt_runner.mlir and lower_intt_runner.mlir,
+// computed with the roots of unity read from memref.global ops.
+
+func.func private @printMemrefI32(memref<*xi32>) attributes { llvm.emit_c_interface }
+
+#cycl = #polynomial.int_polynomial<1 + x**4>
+!coeff_ty = !mod_arith.int<7681:i32>
+#ring = #polynomial.ring<coefficientType=!coeff_ty, polynomialModulus=#cycl>
+#root = #polynomial.primitive_root<value=1925:i32, degree=8:i32>
+!poly_ty = !polynomial.polynomial<ring=#ring>
+
+func.func @test_poly_ntt_pool() {
+  %coeffsRaw = arith.constant dense<[1,2,3,4]> : tensor<4xi32>
+  %coeffs = mod_arith.encapsulate %coeffsRaw : tensor<4xi32> -> tensor<4x!coeff_ty>
+  %poly = polynomial.from_tensor %coeffs : tensor<4x!coeff_ty> -> !poly_ty
+  %0 = polynomial.ntt %poly {root=#root} : !poly_ty -> tensor<4xi32, #ring>
+
+  %1 = tensor.cast %0 : tensor<4xi32, #ring> to tensor<4xi32>
+  %2 = bufferization.to_memref %1 : tensor<4xi32> to memref<4xi32>
+  %U = memref.cast %2 : memref<4xi32> to memref<*xi32>
+  func.call @printMemrefI32(%U) : (memref<*xi32>) -> ()
+
+  %3 = polynomial.intt %0 {root=#root} : tensor<4xi32, #ring> -> !poly_ty
+  %4 = polynomial.to_tensor %3 : !poly_ty -> tensor<4x!coeff_ty>
+  %5 = mod_arith.extract %4 : tensor<4x!coeff_ty> -> tensor<4xi32>
+  %6 = bufferization.to_memref %5 : tensor<4xi32> to memref<4xi32>
+  %V = memref.cast %6 : memref<4xi32> to memref<*xi32>
+  func.call @printMemrefI32(%V) : (memref<*xi32>) -> ()
+  return
+}
+// CHECK_TEST_POLY_NTT_POOL: [1467, 2807, 3471, 7621]
+// CHECK_TEST_POLY_NTT_POOL: [1, 2, 3, 4]
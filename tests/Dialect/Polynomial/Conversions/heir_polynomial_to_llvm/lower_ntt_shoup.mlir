@@ -0,0 +1,68 @@
+// RUN: heir-opt --polynomial-to-mod-arith=shoup-twiddles=true --cse %s | FileCheck %s
+
+#cycl = #polynomial.int_polynomial<1 + x**4>
+!coeff_ty = !mod_arith.int<7681:i32>
+#ring = #polynomial.ring<coefficientType=!coeff_ty, polynomialModulus=#cycl>
+#root = #polynomial.primitive_root<value=1925:i32, degree=8:i32>
+!poly_ty = !polynomial.polynomial<ring=#ring>
+
+// CHECK: func.func @lower_ntt
+// CHECK-DAG:  %[[CMOD:.*]] = arith.constant 7681 : i64
+// CHECK-DAG:  %[[ROOTS:.*]] = arith.constant dense<[1, 1925, 3383, 6468]> : [[INTER_TYPE:tensor<4xi64>]]
+// The companions are floor(root * 2^32 / 7681)
+// CHECK-DAG:  %[[SHOUP_ROOTS:.*]] = arith.constant dense<[559167, 1076397870, 1891664413, 3616696845]> : [[INTER_TYPE]]
+// CHECK-DAG:  %[[SHIFT:.*]] = arith.constant 32 : i64
+// CHECK:      affine.for
+// CHECK:        affine.for
+// CHECK:          affine.for
+// CHECK:            %[[A:.*]] = tensor.extract
+// CHECK:            %[[B:.*]] = tensor.extract
+// CHECK:            %[[ROOT_INDEX:.*]] = affine.apply
+// CHECK:            %[[ROOT:.*]] = tensor.extract %[[ROOTS]][%[[ROOT_INDEX]]] : [[INTER_TYPE]]
+// CHECK:            %[[SHOUP_ROOT:.*]] = tensor.extract %[[SHOUP_ROOTS]][%[[ROOT_INDEX]]] : [[INTER_TYPE]]
+// CHECK:            %[[QT:.*]] = arith.muli %[[B]], %[[SHOUP_ROOT]] : i64
+// CHECK:            %[[Q:.*]] = arith.shrui %[[QT]], %[[SHIFT]] : i64
+// CHECK:            %[[PROD:.*]] = arith.muli %[[B]], %[[ROOT]] : i64
+// CHECK:            %[[QMOD:.*]] = arith.muli %[[Q]], %[[CMOD]] : i64
+// CHECK:            %[[REM:.*]] = arith.subi %[[PROD]], %[[QMOD]] : i64
+// CHECK:            %[[ROOTB:.*]] = mod_arith.subifge %[[REM]], %[[CMOD]] : i64
+// CHECK:            %[[PLUS:.*]] = arith.addi %[[A]], %[[ROOTB]] : i64
+// CHECK:            %[[PLUS_MOD:.*]] = mod_arith.subifge %[[PLUS]], %[[CMOD]] : i64
+// CHECK:            %[[MINUS:.*]] = arith.subi %[[A]], %[[ROOTB]] : i64
+// CHECK:            %[[MINUS_SHIFT:.*]] = arith.addi %[[MINUS]], %[[CMOD]] : i64
+// CHECK:            %[[MINUS_MOD:.*]] = mod_arith.subifge %[[MINUS_SHIFT]], %[[CMOD]] : i64
+// CHECK-NOT:        arith.remui
+// CHECK:            tensor.insert %[[PLUS_MOD]]
+// CHECK:            tensor.insert %[[MINUS_MOD]]
+func.func @lower_ntt() -> tensor<4xi32, #ring> {
+  %coeffsRaw = arith.constant dense<[1, 2, 3, 4]> : tensor<4xi32>
+  %coeffs = mod_arith.encapsulate %coeffsRaw : tensor<4xi32> -> tensor<4x!coeff_ty>
+  %poly = polynomial.from_tensor %coeffs : tensor<4x!coeff_ty> -> !poly_ty
+  %ret = polynomial.ntt %poly {root=#root} : !poly_ty -> tensor<4xi32, #ring>
+  return %ret : tensor<4xi32, #ring>
+}
+
+// CHECK: func.func @lower_intt
+// CHECK-DAG:  %[[ROOTS:.*]] = arith.constant dense<[1, 1213, 4298, 5756]> : [[INTER_TYPE:tensor<4xi64>]]
+// CHECK-DAG:  %[[SHOUP_ROOTS:.*]] = arith.constant dense<[559167, 678270450, 2403302882, 3218569425]> : [[INTER_TYPE]]
+// CHECK:      %[[RES:.*]]:3 = affine.for
+// CHECK:            %[[PLUS:.*]] = arith.addi
+// CHECK:            mod_arith.subifge %[[PLUS]]
+// CHECK:            %[[MINUS:.*]] = arith.subi
+// CHECK:            %[[MINUS_SHIFT:.*]] = arith.addi %[[MINUS]]
+// CHECK:            %[[MINUS_MOD:.*]] = mod_arith.subifge %[[MINUS_SHIFT]]
+// CHECK:            arith.muli %[[MINUS_MOD]]
+// CHECK:            arith.shrui
+// CHECK-NOT:        arith.remui
+// The final scaling by n^{-1} = 5761 uses the companion floor(5761 * 2^32 / 7681)
+// CHECK-DAG:  %[[N_INV:.*]] = arith.constant dense<5761> : [[INTER_TYPE]]
+// CHECK-DAG:  %[[N_INV_SHOUP:.*]] = arith.constant dense<3221365263> : [[INTER_TYPE]]
+// CHECK:      arith.muli %[[RES]]#0, %[[N_INV_SHOUP]] : [[INTER_TYPE]]
+// CHECK-NOT:  arith.remui
+// CHECK:      return
+func.func @lower_intt() -> !poly_ty {
+  %coeffs = arith.constant dense<[1, 2, 3, 4]> : tensor<4xi32>
+  %ntt_coeffs = tensor.cast %coeffs : tensor<4xi32> to tensor<4xi32, #ring>
+  %ret = polynomial.intt %ntt_coeffs {root=#root} : tensor<4xi32, #ring> -> !poly_ty
+  return %ret : !poly_ty
+}
@@ -0,0 +1,81 @@
+// RUN: heir-opt --polynomial-to-mod-arith=vectorize-stages=true --cse %s | FileCheck %s --enable-var-scope
+
+#cycl = #polynomial.int_polynomial<1 + x**4>
+!coeff_ty = !mod_arith.int<7681:i32>
+#ring = #polynomial.ring<coefficientType=!coeff_ty, polynomialModulus=#cycl>
+#root = #polynomial.primitive_root<value=1925:i32, degree=8:i32>
+!poly_ty = !polynomial.polynomial<ring=#ring>
+
+// CHECK-DAG: #[[BLOCK_MAP:.*]] = affine_map<(d0, d1) -> (d0, d1)>
+// CHECK-DAG: #[[ROOT_MAP:.*]] = affine_map<(d0, d1) -> (d1)>
+
+// CHECK: func.func @lower_ntt
+// CHECK-NOT:  affine.for
+// CHECK-DAG:  %[[CMOD:.*]] = arith.constant 7681 : i64
+// CHECK-DAG:  %[[INITIAL_VALUE:.*]] = arith.extui %{{.*}} : tensor<4xi32> to tensor<4xi64>
+
+// The first stage has two batches of one butterfly, which use roots[2].
+// CHECK:      %[[BLOCKS0:.*]] = tensor.expand_shape %[[INITIAL_VALUE]] {{\[\[}}0, 1, 2]] output_shape [2, 2, 1] : tensor<4xi64> into tensor<2x2x1xi64>
+// CHECK:      %[[A0:.*]] = tensor.extract_slice %[[BLOCKS0]][0, 0, 0] [2, 1, 1] [1, 1, 1] : tensor<2x2x1xi64> to tensor<2x1xi64>
+// CHECK:      %[[B0:.*]] = tensor.extract_slice %[[BLOCKS0]][0, 1, 0] [2, 1, 1] [1, 1, 1] : tensor<2x2x1xi64> to tensor<2x1xi64>
+// CHECK:      %[[ROOTS0:.*]] = arith.constant dense<3383> : tensor<1xi64>
+// CHECK:      %[[DEST0:.*]] = tensor.empty() : tensor<2x2x1xi64>
+// CHECK:      %[[PLUS_INIT0:.*]] = tensor.extract_slice %[[DEST0]][0, 0, 0]
+// CHECK:      %[[MINUS_INIT0:.*]] = tensor.extract_slice %[[DEST0]][0, 1, 0]
+// CHECK:      %[[STAGE0:.*]]:2 = linalg.generic
+// CHECK-SAME:   indexing_maps = [#[[BLOCK_MAP]], #[[BLOCK_MAP]], #[[ROOT_MAP]], #[[BLOCK_MAP]], #[[BLOCK_MAP]]]
+// CHECK-SAME:   iterator_types = ["parallel", "parallel"]
+// CHECK-SAME:   ins(%[[A0]], %[[B0]], %[[ROOTS0]] : tensor<2x1xi64>, tensor<2x1xi64>, tensor<1xi64>)
+// CHECK-SAME:   outs(%[[PLUS_INIT0]], %[[MINUS_INIT0]] : tensor<2x1xi64>, tensor<2x1xi64>)
+// CHECK:      ^bb0(%[[A:.*]]: i64, %[[B:.*]]: i64, %[[ROOT:.*]]: i64, %{{.*}}: i64, %{{.*}}: i64):
+// CHECK:        %[[ROOTB:.*]] = arith.muli %[[B]], %[[ROOT]] : i64
+// CHECK:        %[[ROOTB_MOD:.*]] = arith.remui %[[ROOTB]], %[[CMOD]] : i64
+// CHECK:        %[[PLUS:.*]] = arith.addi %[[A]], %[[ROOTB_MOD]] : i64
+// CHECK:        %[[PLUS_MOD:.*]] = arith.remui %[[PLUS]], %[[CMOD]] : i64
+// CHECK:        %[[MINUS:.*]] = arith.subi %[[A]], %[[ROOTB_MOD]] : i64
+// CHECK:        %[[MINUS_SHIFT:.*]] = arith.addi %[[MINUS]], %[[CMOD]] : i64
+// CHECK:        %[[MINUS_MOD:.*]] = arith.remui %[[MINUS_SHIFT]], %[[CMOD]] : i64
+// CHECK:        linalg.yield %[[PLUS_MOD]], %[[MINUS_MOD]] : i64, i64
+// CHECK:      %[[INSERT_PLUS0:.*]] = tensor.insert_slice %[[STAGE0]]#0 into %[[DEST0]][0, 0, 0] [2, 1, 1] [1, 1, 1]
+// CHECK:      %[[INSERT_MINUS0:.*]] = tensor.insert_slice %[[STAGE0]]#1 into %[[INSERT_PLUS0]][0, 1, 0] [2, 1, 1] [1, 1, 1]
+// CHECK:      %[[COEFFS0:.*]] = tensor.collapse_shape %[[INSERT_MINUS0]] {{\[\[}}0, 1, 2]] : tensor<2x2x1xi64> into tensor<4xi64>
+
+// The second stage has one batch of two butterflies, which use roots[1] and
+// roots[3].
+// CHECK:      %[[BLOCKS1:.*]] = tensor.expand_shape %[[COEFFS0]] {{\[\[}}0, 1, 2]] output_shape [1, 2, 2] : tensor<4xi64> into tensor<1x2x2xi64>
+// CHECK:      %[[ROOTS1:.*]] = arith.constant dense<[1925, 6468]> : tensor<2xi64>
+// CHECK:      %[[STAGE1:.*]]:2 = linalg.generic
+// CHECK-SAME:   tensor<1x2xi64>, tensor<1x2xi64>, tensor<2xi64>
+// CHECK:      %[[COEFFS1:.*]] = tensor.collapse_shape %{{.*}} {{\[\[}}0, 1, 2]] : tensor<1x2x2xi64> into tensor<4xi64>
+// CHECK:      arith.trunci %[[COEFFS1]] : tensor<4xi64> to tensor<4xi32>
+// CHECK-NOT:  affine.for
+// CHECK:      return
+func.func @lower_ntt() -> tensor<4xi32, #ring> {
+  %coeffsRaw = arith.constant dense<[1, 2, 3, 4]> : tensor<4xi32>
+  %coeffs = mod_arith.encapsulate %coeffsRaw : tensor<4xi32> -> tensor<4x!coeff_ty>
+  %poly = polynomial.from_tensor %coeffs : tensor<4x!coeff_ty> -> !poly_ty
+  %ret = polynomial.ntt %poly {root=#root} : !poly_ty -> tensor<4xi32, #ring>
+  return %ret : tensor<4xi32, #ring>
+}
+
+// The inverse stages run from the largest batch to the smallest.
+// CHECK: func.func @lower_intt
+// CHECK-NOT:  affine.for
+// CHECK:      tensor.expand_shape %{{.*}} {{\[\[}}0, 1, 2]] output_shape [1, 2, 2] : tensor<4xi64> into tensor<1x2x2xi64>
+// CHECK:      arith.constant dense<[1213, 5756]> : tensor<2xi64>
+// CHECK:      linalg.generic
+// CHECK:        %[[PLUS:.*]] = arith.addi
+// CHECK:        arith.remui %[[PLUS]]
+// CHECK:        %[[MINUS:.*]] = arith.subi
+// CHECK:        %[[MINUS_SHIFT:.*]] = arith.addi %[[MINUS]]
+// CHECK:        %[[MINUS_MOD:.*]] = arith.remui %[[MINUS_SHIFT]]
+// CHECK:        arith.muli %[[MINUS_MOD]]
+// CHECK:      tensor.expand_shape %{{.*}} {{\[\[}}0, 1, 2]] output_shape [2, 2, 1] : tensor<4xi64> into tensor<2x2x1xi64>
+// CHECK:      arith.constant dense<4298> : tensor<1xi64>
+// CHECK:      linalg.generic
+// CHECK-NOT:  affine.for
+// CHECK:      return
+func.func @lower_intt(%ntt : tensor<4xi32, #ring>) -> !poly_ty {
+  %ret = polynomial.intt %ntt {root=#root} : tensor<4xi32, #ring> -> !poly_ty
+  return %ret : !poly_ty
+}
@@ -0,0 +1,61 @@
+// RUN: heir-opt %s --heir-polynomial-to-llvm=parallelize=true | FileCheck %s
+
+!coeff_ty = !mod_arith.int<17:i32>
+#ideal = #polynomial.int_polynomial<1 + x**4>
+#ring = #polynomial.ring<coefficientType=!coeff_ty, polynomialModulus=#ideal>
+!poly_ty = !polynomial.polynomial<ring=#ring>
+
+// The outputs of the coefficient convolution are computed by an OpenMP
+// worksharing loop.
+// CHECK: llvm.func @test_parallel_mul
+// CHECK:      omp.parallel
+// CHECK:      omp.wsloop
+// CHECK:      omp.loop_nest
+// CHECK:      omp.yield
+// CHECK:      omp.terminator
+// CHECK-NOT:  builtin.unrealized_conversion_cast
+func.func @test_parallel_mul(%p0: !poly_ty, %p1: !poly_ty) -> !poly_ty {
+  %0 = polynomial.mul %p0, %p1 : !poly_ty
+  return %0 : !poly_ty
+}
+
+// The products of the elements of a tensor of polynomials are computed by the
+// iterations of an outer worksharing loop, each of which runs the coefficient
+// convolution in a nested one.
+// CHECK: llvm.func @test_parallel_tensor_of_polys
+// CHECK:      omp.parallel
+// CHECK:      omp.wsloop
+// CHECK:      omp.loop_nest
+// CHECK:      omp.parallel
+// CHECK:      omp.wsloop
+// CHECK:      omp.loop_nest
+// CHECK-NOT:  builtin.unrealized_conversion_cast
+func.func @test_parallel_tensor_of_polys(%p0: tensor<2x!poly_ty>, %p1: tensor<2x!poly_ty>) -> tensor<2x!poly_ty> {
+  %0 = polynomial.mul %p0, %p1 : tensor<2x!poly_ty>
+  return %0 : tensor<2x!poly_ty>
+}
+
+!limb0_coeff_ty = !mod_arith.int<65537:i32>
+!limb1_coeff_ty = !mod_arith.int<114689:i32>
+#ring0 = #polynomial.ring<coefficientType=!limb0_coeff_ty, polynomialModulus=#ideal>
+#ring1 = #polynomial.ring<coefficientType=!limb1_coeff_ty, polynomialModulus=#ideal>
+!limb0_ty = !polynomial.polynomial<ring=#ring0>
+!limb1_ty = !polynomial.polynomial<ring=#ring1>
+!rns_ty = !rns.rns<!limb0_ty, !limb1_ty>
+
+// Each iteration of the worksharing loop over the limbs of an RNS value
+// branches to the arithmetic modulo its own prime.
+// CHECK: llvm.func @test_parallel_rns
+// CHECK:      omp.parallel
+// CHECK:      omp.wsloop
+// CHECK:      omp.loop_nest
+// CHECK:      llvm.switch
+// CHECK:      omp.yield
+// CHECK-NOT:  builtin.unrealized_conversion_cast
+func.func @test_parallel_rns(%x: !rns_ty) -> !rns_ty {
+  %0:2 = rns.unpack %x : !rns_ty -> (!limb0_ty, !limb1_ty)
+  %1 = polynomial.mul %0#0, %0#0 : !limb0_ty
+  %2 = polynomial.mul %0#1, %0#1 : !limb1_ty
+  %3 = rns.pack %1, %2 : (!limb0_ty, !limb1_ty) -> !rns_ty
+  return %3 : !rns_ty
+}
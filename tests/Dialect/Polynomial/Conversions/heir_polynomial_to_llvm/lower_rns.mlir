@@ -0,0 +1,79 @@
+// RUN: heir-opt --polynomial-to-mod-arith %s | FileCheck %s
+
+#ideal = #polynomial.int_polynomial<1 + x**4>
+!limb0_coeff_ty = !mod_arith.int<65537:i32>
+!limb1_coeff_ty = !mod_arith.int<114689:i32>
+#ring0 = #polynomial.ring<coefficientType=!limb0_coeff_ty, polynomialModulus=#ideal>
+#ring1 = #polynomial.ring<coefficientType=!limb1_coeff_ty, polynomialModulus=#ideal>
+!limb0_ty = !polynomial.polynomial<ring=#ring0>
+!limb1_ty = !polynomial.polynomial<ring=#ring1>
+!rns_ty = !rns.rns<!limb0_ty, !limb1_ty>
+
+// The limbs are stored as the rows of a single tensor of storage integers.
+// CHECK: func.func @lower_rns(%[[ARG:.*]]: tensor<2x4xi32>) -> tensor<2x4xi32> {
+// CHECK:      %[[ROW0:.*]] = tensor.extract_slice %[[ARG]][0, 0] [1, 4] [1, 1] : tensor<2x4xi32> to tensor<4xi32>
+// CHECK:      %[[LIMB0:.*]] = mod_arith.encapsulate %[[ROW0]] : tensor<4xi32> -> tensor<4x!mod_arith.int<65537 : i32>>
+// CHECK:      %[[ROW1:.*]] = tensor.extract_slice %[[ARG]][1, 0] [1, 4] [1, 1] : tensor<2x4xi32> to tensor<4xi32>
+// CHECK:      %[[LIMB1:.*]] = mod_arith.encapsulate %[[ROW1]] : tensor<4xi32> -> tensor<4x!mod_arith.int<114689 : i32>>
+// CHECK:      %[[SUM0:.*]] = mod_arith.add %[[LIMB0]], %[[LIMB0]]
+// CHECK:      %[[SUM1:.*]] = mod_arith.add %[[LIMB1]], %[[LIMB1]]
+// CHECK:      %[[EMPTY:.*]] = tensor.empty() : tensor<2x4xi32>
+// CHECK:      %[[STORAGE0:.*]] = mod_arith.extract %[[SUM0]]
+// CHECK:      %[[INSERTED0:.*]] = tensor.insert_slice %[[STORAGE0]] into %[[EMPTY]][0, 0] [1, 4] [1, 1]
+// CHECK:      %[[STORAGE1:.*]] = mod_arith.extract %[[SUM1]]
+// CHECK:      %[[INSERTED1:.*]] = tensor.insert_slice %[[STORAGE1]] into %[[INSERTED0]][1, 0] [1, 4] [1, 1]
+// CHECK:      return %[[INSERTED1]]
+func.func @lower_rns(%x: !rns_ty) -> !rns_ty {
+  %0:2 = rns.unpack %x : !rns_ty -> (!limb0_ty, !limb1_ty)
+  %1 = polynomial.add %0#0, %0#0 : !limb0_ty
+  %2 = polynomial.add %0#1, %0#1 : !limb1_ty
+  %3 = rns.pack %1, %2 : (!limb0_ty, !limb1_ty) -> !rns_ty
+  return %3 : !rns_ty
+}
+
+!limb2_coeff_ty = !mod_arith.int<40961:i32>
+#ring2 = #polynomial.ring<coefficientType=!limb2_coeff_ty, polynomialModulus=#ideal>
+!limb2_ty = !polynomial.polynomial<ring=#ring2>
+!ext_rns_ty = !rns.rns<!limb0_ty, !limb1_ty, !limb2_ty>
+
+// The input limbs are copied, and the new limb is the sum of the scaled input
+// limbs reduced modulo 40961.
+// CHECK: func.func @lower_extend_basis(%[[ARG:.*]]: tensor<2x4xi32>) -> tensor<3x4xi32> {
+// CHECK:      %[[EMPTY:.*]] = tensor.empty() : tensor<3x4xi32>
+// CHECK:      %[[COPY:.*]] = tensor.insert_slice %[[ARG]] into %[[EMPTY]][0, 0] [2, 4] [1, 1]
+// CHECK:      mod_arith.mul
+// CHECK:      mod_arith.mul
+// CHECK:      arith.constant dense<40961> : tensor<4xi32>
+// CHECK:      arith.remui
+// CHECK:      mod_arith.mul
+// CHECK:      arith.remui
+// CHECK:      mod_arith.mul
+// CHECK:      %[[SUM:.*]] = mod_arith.add
+// CHECK:      %[[STORAGE:.*]] = mod_arith.extract %[[SUM]]
+// CHECK:      %[[RES:.*]] = tensor.insert_slice %[[STORAGE]] into %[[COPY]][2, 0] [1, 4] [1, 1]
+// CHECK:      return %[[RES]]
+func.func @lower_extend_basis(%x: !rns_ty) -> !ext_rns_ty {
+  %0 = rns.extend_basis %x : !rns_ty -> !ext_rns_ty
+  return %0 : !ext_rns_ty
+}
+
+// CHECK: func.func @lower_rescale(%[[ARG:.*]]: tensor<3x4xi32>) -> tensor<2x4xi32> {
+// CHECK:      %[[LAST_ROW:.*]] = tensor.extract_slice %[[ARG]][2, 0] [1, 4] [1, 1]
+// CHECK:      %[[LAST:.*]] = mod_arith.extract
+// CHECK:      %[[HALF:.*]] = arith.constant dense<20480> : tensor<4xi32>
+// CHECK:      %[[NEGATIVE:.*]] = arith.cmpi ugt, %[[LAST]], %[[HALF]]
+// CHECK:      arith.remui %[[LAST]]
+// CHECK:      arith.select %[[NEGATIVE]]
+// CHECK:      mod_arith.sub
+// CHECK:      mod_arith.mul
+// CHECK:      tensor.insert_slice {{.*}}[0, 0] [1, 4] [1, 1]
+// CHECK:      arith.remui %[[LAST]]
+// CHECK:      arith.select %[[NEGATIVE]]
+// CHECK:      mod_arith.sub
+// CHECK:      mod_arith.mul
+// CHECK:      %[[RES:.*]] = tensor.insert_slice {{.*}}[1, 0] [1, 4] [1, 1]
+// CHECK:      return %[[RES]]
+func.func @lower_rescale(%x: !ext_rns_ty) -> !rns_ty {
+  %0 = rns.rescale %x : !ext_rns_ty -> !rns_ty
+  return %0 : !rns_ty
+}
@@ -0,0 +1,78 @@
+// RUN: heir-opt %s --heir-polynomial-to-llvm \
+// RUN:   | mlir-cpu-runner -e test_rns -entry-point-result=void \
+// RUN:      --shared-libs="%mlir_lib_dir/libmlir_c_runner_utils%shlibext,%mlir_runner_utils" > %t
+// RUN: FileCheck %s --check-prefix=CHECK_TEST_RNS < %t
+
+#ideal = #polynomial.int_polynomial<1 + x**4>
+#ring0 = #polynomial.ring<coefficientType=!mod_arith.int<17:i32>, polynomialModulus=#ideal>
+#ring1 = #polynomial.ring<coefficientType=!mod_arith.int<97:i32>, polynomialModulus=#ideal>
+#ring2 = #polynomial.ring<coefficientType=!mod_arith.int<113:i32>, polynomialModulus=#ideal>
+!limb0_ty = !polynomial.polynomial<ring=#ring0>
+!limb1_ty = !polynomial.polynomial<ring=#ring1>
+!limb2_ty = !polynomial.polynomial<ring=#ring2>
+!rns_ty = !rns.rns<!limb0_ty, !limb1_ty>
+!ext_rns_ty = !rns.rns<!limb0_ty, !limb1_ty, !limb2_ty>
+
+func.func private @printMemrefI32(memref<*xi32>) attributes { llvm.emit_c_interface }
+
+func.func @print_limbs(%x: !rns_ty) {
+  %0:2 = rns.unpack %x : !rns_ty -> (!limb0_ty, !limb1_ty)
+  %1 = polynomial.to_tensor %0#0 : !limb0_ty -> tensor<4x!mod_arith.int<17:i32>>
+  %2 = mod_arith.extract %1 : tensor<4x!mod_arith.int<17:i32>> -> tensor<4xi32>
+  %3 = bufferization.to_memref %2 : tensor<4xi32> to memref<4xi32>
+  %4 = memref.cast %3 : memref<4xi32> to memref<*xi32>
+  func.call @printMemrefI32(%4) : (memref<*xi32>) -> ()
+  %5 = polynomial.to_tensor %0#1 : !limb1_ty -> tensor<4x!mod_arith.int<97:i32>>
+  %6 = mod_arith.extract %5 : tensor<4x!mod_arith.int<97:i32>> -> tensor<4xi32>
+  %7 = bufferization.to_memref %6 : tensor<4xi32> to memref<4xi32>
+  %8 = memref.cast %7 : memref<4xi32> to memref<*xi32>
+  func.call @printMemrefI32(%8) : (memref<*xi32>) -> ()
+  return
+}
+
+func.func @print_new_limb(%x: !ext_rns_ty) {
+  %0:3 = rns.unpack %x : !ext_rns_ty -> (!limb0_ty, !limb1_ty, !limb2_ty)
+  %1 = polynomial.to_tensor %0#2 : !limb2_ty -> tensor<4x!mod_arith.int<113:i32>>
+  %2 = mod_arith.extract %1 : tensor<4x!mod_arith.int<113:i32>> -> tensor<4xi32>
+  %3 = bufferization.to_memref %2 : tensor<4xi32> to memref<4xi32>
+  %4 = memref.cast %3 : memref<4xi32> to memref<*xi32>
+  func.call @printMemrefI32(%4) : (memref<*xi32>) -> ()
+  return
+}
+
+func.func @test_rns() {
+  // The residues of 1000 + 56x + 12345x**2 + 5x**3 modulo 17, 97 and 113.
+  %0 = polynomial.constant int<14 + 5x + 3x**2 + 5x**3> : !limb0_ty
+  %1 = polynomial.constant int<30 + 56x + 26x**2 + 5x**3> : !limb1_ty
+  %2 = polynomial.constant int<96 + 56x + 28x**2 + 5x**3> : !limb2_ty
+  %x = rns.pack %0, %1, %2 : (!limb0_ty, !limb1_ty, !limb2_ty) -> !ext_rns_ty
+
+  // 9 + 109x**2 is the rounded quotient by 113.
+  %rescaled = rns.rescale %x : !ext_rns_ty -> !rns_ty
+  func.call @print_limbs(%rescaled) : (!rns_ty) -> ()
+
+  // 6 + 109x**2 - 2x**3 is congruent to x / 113 modulo 7.
+  %switched = rns.rescale %x {plaintext_modulus = 7 : i64} : !ext_rns_ty -> !rns_ty
+  func.call @print_limbs(%switched) : (!rns_ty) -> ()
+
+  // The residues of 9 + 109x**2 modulo 113, up to a multiple of
+  // 17 * 97 = 1649. Without a correction, the lift of each coefficient
+  // overshoots by 1649, giving 1658 + 1758x**2.
+  %extended = rns.extend_basis %rescaled : !rns_ty -> !ext_rns_ty
+  func.call @print_new_limb(%extended) : (!ext_rns_ty) -> ()
+
+  // The residues of 1000 + 56x + 1600x**2 + 5x**3 modulo 113, up to a
+  // multiple of 17 * 97 = 1649.
+  %3 = polynomial.constant int<14 + 5x + 2x**2 + 5x**3> : !limb0_ty
+  %4 = polynomial.constant int<30 + 56x + 48x**2 + 5x**3> : !limb1_ty
+  %y = rns.pack %3, %4 : (!limb0_ty, !limb1_ty) -> !rns_ty
+  %y_extended = rns.extend_basis %y : !rns_ty -> !ext_rns_ty
+  func.call @print_new_limb(%y_extended) : (!ext_rns_ty) -> ()
+  return
+}
+// CHECK_TEST_RNS: [9, 0, 7, 0]
+// CHECK_TEST_RNS: [9, 0, 12, 0]
+// CHECK_TEST_RNS: [6, 0, 7, 15]
+// CHECK_TEST_RNS: [6, 0, 12, 95]
+// CHECK_TEST_RNS: [76, 0, 63, 0]
+// CHECK_TEST_RNS: [96, 10, 18, 72]
@@ -0,0 +1,80 @@
+// RUN: heir-opt --polynomial-to-rns=moduli=65537,114689 %s | FileCheck %s
+
+// 7516372993 = 65537 * 114689
+!coeff_ty = !mod_arith.int<7516372993:i64>
+#ideal = #polynomial.int_polynomial<1 + x**4>
+#ring = #polynomial.ring<coefficientType=!coeff_ty, polynomialModulus=#ideal>
+!poly_ty = !polynomial.polynomial<ring=#ring>
+
+!small_coeff_ty = !mod_arith.int<65537:i64>
+#small_ring = #polynomial.ring<coefficientType=!small_coeff_ty, polynomialModulus=#ideal>
+!small_poly_ty = !polynomial.polynomial<ring=#small_ring>
+
+// CHECK-DAG: ![[Q0:.*]] = !mod_arith.int<65537 : i32>
+// CHECK-DAG: ![[Q1:.*]] = !mod_arith.int<114689 : i32>
+// CHECK-DAG: #[[RING0:.*]] = #polynomial.ring<coefficientType = ![[Q0]], polynomialModulus = #{{.*}}>
+// CHECK-DAG: #[[RING1:.*]] = #polynomial.ring<coefficientType = ![[Q1]], polynomialModulus = #{{.*}}>
+// CHECK-DAG: ![[LIMB0:.*]] = !polynomial.polynomial<ring = #[[RING0]]>
+// CHECK-DAG: ![[LIMB1:.*]] = !polynomial.polynomial<ring = #[[RING1]]>
+// CHECK-DAG: ![[RNS:.*]] = !rns.rns<![[LIMB0]], ![[LIMB1]]>
+
+// CHECK: func.func @rns_arithmetic(%[[P0:.*]]: [[POLY_TY:.*]], %[[P1:.*]]: [[POLY_TY]], %[[S:.*]]: [[COEFF_TY:.*]]) -> [[POLY_TY]] {
+// The inputs are decomposed by their remainders modulo the limb moduli.
+// CHECK:      polynomial.to_tensor %[[P0]]
+// CHECK:      arith.remui
+// CHECK:      arith.trunci
+// CHECK:      polynomial.from_tensor
+// CHECK:      arith.remui
+// CHECK:      arith.trunci
+// CHECK:      polynomial.from_tensor
+// CHECK:      rns.pack
+// CHECK:      polynomial.to_tensor %[[P1]]
+// CHECK:      rns.pack
+// The arithmetic is carried out per limb.
+// CHECK:      %[[SUM0:.*]] = polynomial.add %{{.*}}, %{{.*}} : ![[LIMB0]]
+// CHECK:      %[[SUM1:.*]] = polynomial.add %{{.*}}, %{{.*}} : ![[LIMB1]]
+// CHECK:      rns.pack %[[SUM0]], %[[SUM1]]
+// CHECK:      polynomial.mul %{{.*}}, %{{.*}} : ![[LIMB0]]
+// CHECK:      polynomial.mul %{{.*}}, %{{.*}} : ![[LIMB1]]
+// CHECK:      mod_arith.extract %[[S]]
+// CHECK:      polynomial.mul_scalar %{{.*}}, %{{.*}} : ![[LIMB0]], ![[Q0]]
+// CHECK:      mod_arith.extract %[[S]]
+// CHECK:      polynomial.mul_scalar %{{.*}}, %{{.*}} : ![[LIMB1]], ![[Q1]]
+// CHECK:      polynomial.constant int<65534 + 7x**2> : ![[LIMB0]]
+// CHECK:      polynomial.constant int<114686 + 7x**2> : ![[LIMB1]]
+// CHECK:      polynomial.sub %{{.*}}, %{{.*}} : ![[LIMB0]]
+// CHECK:      polynomial.sub %{{.*}}, %{{.*}} : ![[LIMB1]]
+// CHECK:      %[[RESULT:.*]] = rns.pack
+// The result is reconstructed with the CRT.
+// CHECK:      rns.unpack %[[RESULT]]
+// CHECK:      arith.constant dense<43690> : tensor<4xi32>
+// CHECK:      mod_arith.mul
+// CHECK:      arith.extui
+// CHECK:      arith.constant dense<114689> : tensor<4xi64>
+// CHECK:      mod_arith.mul
+// CHECK:      arith.constant dense<38232> : tensor<4xi32>
+// CHECK:      mod_arith.mul
+// CHECK:      arith.extui
+// CHECK:      arith.constant dense<65537> : tensor<4xi64>
+// CHECK:      mod_arith.mul
+// CHECK:      mod_arith.add
+// CHECK:      %[[RES:.*]] = polynomial.from_tensor
+// CHECK:      return %[[RES]]
+func.func @rns_arithmetic(%p0: !poly_ty, %p1: !poly_ty, %s: !coeff_ty) -> !poly_ty {
+  %0 = polynomial.add %p0, %p1 : !poly_ty
+  %1 = polynomial.mul %0, %p1 : !poly_ty
+  %2 = polynomial.mul_scalar %1, %s : !poly_ty, !coeff_ty
+  %3 = polynomial.constant int<-3 + 7x**2> : !poly_ty
+  %4 = polynomial.sub %2, %3 : !poly_ty
+  return %4 : !poly_ty
+}
+
+// Rings whose coefficient modulus is not a product of the moduli are kept.
+// CHECK: func.func @no_decomposition
+// CHECK-NOT:  rns.pack
+// CHECK:      polynomial.add %{{.*}}, %{{.*}} : !polynomial.polynomial
+// CHECK-NOT:  rns.pack
+func.func @no_decomposition(%p0: !small_poly_ty, %p1: !small_poly_ty) -> !small_poly_ty {
+  %0 = polynomial.add %p0, %p1 : !small_poly_ty
+  return %0 : !small_poly_ty
+}
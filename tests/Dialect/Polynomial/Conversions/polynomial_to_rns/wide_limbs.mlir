@@ -0,0 +1,22 @@
+// RUN: heir-opt --polynomial-to-rns=moduli=4294967291,65537 %s | FileCheck %s
+
+// 281479271350267 = 4294967291 * 65537, where 4294967291 has 32 active bits
+// and needs a 64-bit storage type.
+!coeff_ty = !mod_arith.int<281479271350267:i64>
+#ideal = #polynomial.int_polynomial<1 + x**4>
+#ring = #polynomial.ring<coefficientType=!coeff_ty, polynomialModulus=#ideal>
+!poly_ty = !polynomial.polynomial<ring=#ring>
+
+// CHECK-DAG: ![[Q0:.*]] = !mod_arith.int<4294967291 : i64>
+// CHECK-DAG: ![[Q1:.*]] = !mod_arith.int<65537 : i64>
+// CHECK-DAG: #[[RING0:.*]] = #polynomial.ring<coefficientType = ![[Q0]], polynomialModulus = #{{.*}}>
+// CHECK-DAG: ![[LIMB0:.*]] = !polynomial.polynomial<ring = #[[RING0]]>
+
+// CHECK: func.func @wide_limbs
+// CHECK:      polynomial.to_tensor
+// CHECK-NOT:  arith.trunci
+// CHECK:      polynomial.add %{{.*}}, %{{.*}} : ![[LIMB0]]
+func.func @wide_limbs(%p0: !poly_ty, %p1: !poly_ty) -> !poly_ty {
+  %0 = polynomial.add %p0, %p1 : !poly_ty
+  return %0 : !poly_ty
+}
@@ -0,0 +1,23 @@
+// RUN: heir-opt --convert-polynomial-mul-to-ntt --cse %s | FileCheck %s
+// RUN: heir-opt --propagate-ntt-form --cse %s | FileCheck %s
+
+!coeff_ty = !mod_arith.int<17:i32>
+#ideal = #polynomial.int_polynomial<1 + x**4>
+#ring = #polynomial.ring<coefficientType=!coeff_ty, polynomialModulus=#ideal>
+!poly_ty = !polynomial.polynomial<ring=#ring>
+
+// The NTT of the constant is computed at compile time with the root 9, so
+// only the variable operand is transformed.
+// CHECK: func.func @fold_constant_ntt(%[[P:.*]]: [[POLY_TY:.*]]) -> [[POLY_TY]] {
+// CHECK-DAG:  %[[TABLE:.*]] = arith.constant dense<[15, 7, 14, 2]> : tensor<4xi32>
+// CHECK-DAG:  polynomial.ntt %[[P]] {root = #polynomial.primitive_root<value = 9 : i32, degree = 8 : i32>}
+// CHECK-NOT:  polynomial.ntt
+// CHECK:      mod_arith.mul
+// CHECK-NOT:  polynomial.ntt
+// CHECK:      %[[RES:.*]] = polynomial.intt
+// CHECK:      return %[[RES]]
+func.func @fold_constant_ntt(%p: !poly_ty) -> !poly_ty {
+  %c = polynomial.constant int<1 + 2x + 3x**2 - 4x**3> : !poly_ty
+  %0 = polynomial.mul %p, %c : !poly_ty
+  return %0 : !poly_ty
+}
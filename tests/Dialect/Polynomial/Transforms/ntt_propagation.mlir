@@ -0,0 +1,60 @@
+// RUN: heir-opt --propagate-ntt-form --cse %s | FileCheck %s
+
+!coeff_ty = !mod_arith.int<17:i32>
+#ideal = #polynomial.int_polynomial<1 + x**4>
+#ring = #polynomial.ring<coefficientType=!coeff_ty, polynomialModulus=#ideal>
+!poly_ty = !polynomial.polynomial<ring=#ring>
+
+// Each input is transformed once, and the whole chain is computed pointwise
+// before a single inverse transform.
+// CHECK: func.func @propagate_chain(%[[P0:.*]]: [[POLY_TY:.*]], %[[P1:.*]]: [[POLY_TY]], %[[P2:.*]]: [[POLY_TY]], %[[P3:.*]]: [[POLY_TY]], %[[S:.*]]: [[COEFF_TY:.*]]) -> [[POLY_TY]] {
+// CHECK-COUNT-4:  polynomial.ntt
+// CHECK-NOT:      polynomial.ntt
+// CHECK-NOT:      polynomial.intt
+// CHECK:          mod_arith.add
+// CHECK-NOT:      polynomial.ntt
+// CHECK-NOT:      polynomial.intt
+// CHECK:          tensor.splat
+// CHECK-NOT:      polynomial.ntt
+// CHECK-NOT:      polynomial.intt
+// CHECK:          mod_arith.sub
+// CHECK-NOT:      polynomial.ntt
+// CHECK-NOT:      polynomial.intt
+// CHECK:          mod_arith.mul
+// CHECK-NOT:      polynomial.ntt
+// CHECK:          %[[RES:.*]] = polynomial.intt
+// CHECK-NOT:      polynomial.intt
+// CHECK:          return %[[RES]]
+func.func @propagate_chain(%p0: !poly_ty, %p1: !poly_ty, %p2: !poly_ty, %p3: !poly_ty, %s: !coeff_ty) -> !poly_ty {
+  %0 = polynomial.mul %p0, %p1 : !poly_ty
+  %1 = polynomial.mul %p2, %p3 : !poly_ty
+  %2 = polynomial.add %0, %1 : !poly_ty
+  %3 = polynomial.mul_scalar %2, %s : !poly_ty, !coeff_ty
+  %4 = polynomial.sub %3, %0 : !poly_ty
+  %5 = polynomial.mul %4, %p0 : !poly_ty
+  return %5 : !poly_ty
+}
+
+// The coefficient representation is required by leading_term, so the inverse
+// transform stays in front of it.
+// CHECK: func.func @propagate_to_leading_term
+// CHECK:      mod_arith.mul
+// CHECK:      mod_arith.add
+// CHECK:      %[[RES:.*]] = polynomial.intt
+// CHECK:      polynomial.leading_term %[[RES]]
+func.func @propagate_to_leading_term(%p0: !poly_ty, %p1: !poly_ty) -> (index, !coeff_ty) {
+  %0 = polynomial.mul %p0, %p1 : !poly_ty
+  %1 = polynomial.add %0, %0 : !poly_ty
+  %2:2 = polynomial.leading_term %1 : !poly_ty -> (index, !coeff_ty)
+  return %2#0, %2#1 : index, !coeff_ty
+}
+
+// Operands in coefficient form stay in coefficient form.
+// CHECK: func.func @no_propagation
+// CHECK-NOT:  polynomial.ntt
+// CHECK:      polynomial.add
+// CHECK-NOT:  polynomial.ntt
+func.func @no_propagation(%p0: !poly_ty, %p1: !poly_ty) -> !poly_ty {
+  %0 = polynomial.add %p0, %p1 : !poly_ty
+  return %0 : !poly_ty
+}
@@ -1,32 +1,74 @@
-// RUN: heir-opt --convert-polynomial-mul-to-ntt --mod-arith-to-arith %s | FileCheck --check-prefix=ARITH --check-prefix=CHECK %s
+// RUN: heir-opt --convert-polynomial-mul-to-ntt --mod-arith-to-arith=reduction=remui %s | FileCheck --check-prefix=ARITH --check-prefix=CHECK %s
 // RUN: heir-opt --convert-polynomial-mul-to-ntt %s | FileCheck --check-prefix=EXT --check-prefix=CHECK %s
 
+!coeff_ty = !mod_arith.int<17:i32>
 #ideal = #polynomial.int_polynomial<1 + x**4>
-#ring = #polynomial.ring<coefficientType=!modarith.modarith<17:i32:i32>, polynomialModulus=#ideal>
+#ring = #polynomial.ring<coefficientType=!coeff_ty, polynomialModulus=#ideal>
 !poly_ty = !polynomial.polynomial<ring=#ring>
 
+// 9 is the first primitive 8-th root of unity modulo 17 found from the
+// generators 2, 3, ...
 // CHECK: func.func @rewrite_poly_mul(%[[poly0:.*]]: [[POLY_TY:.*]], %[[poly1:.*]]: [[POLY_TY]]) -> [[POLY_TY]] {
-// CHECK:      %[[NTT_POLY0:.*]] = polynomial.ntt %[[poly0]] : [[POLY_TY]] -> [[INPUT_TENSOR_TYPE:.*]]
-// CHECK:      %[[NTT_POLY1:.*]] = polynomial.ntt %[[poly1]] : [[POLY_TY]] -> [[INPUT_TENSOR_TYPE]]
-// EXT:        %[[NTT_RES:.*]] = mod_arith.mul %[[NTT_POLY0]], %[[NTT_POLY1]] {modulus = 17 : i32} : [[INPUT_TENSOR_TYPE]]
-// ARITH:      %[[NTT_MUL:.*]] = arith.muli %[[NTT_POLY0]], %[[NTT_POLY1]] : [[INPUT_TENSOR_TYPE]]
-// ARITH:      %[[CMOD:.*]] = arith.constant dense<17> : [[INPUT_TENSOR_TYPE:.*]]
-// ARITH:      %[[NTT_RES:.*]] = arith.remui %[[NTT_MUL]], %[[CMOD]] : [[INPUT_TENSOR_TYPE]]
-// CHECK:      %[[RES:.*]] = polynomial.intt %[[NTT_RES]] : [[INPUT_TENSOR_TYPE]] -> {{.*}}
+// CHECK:      %[[NTT_POLY0:.*]] = polynomial.ntt %[[poly0]] {root = #polynomial.primitive_root<value = 9 : i32, degree = 8 : i32>} : [[POLY_TY]] -> [[NTT_TENSOR_TYPE:.*]]
+// CHECK:      %[[NTT_POLY1:.*]] = polynomial.ntt %[[poly1]] {root = #polynomial.primitive_root<value = 9 : i32, degree = 8 : i32>} : [[POLY_TY]] -> [[NTT_TENSOR_TYPE]]
+// CHECK:      %[[CAST0:.*]] = tensor.cast %[[NTT_POLY0]] : [[NTT_TENSOR_TYPE]] to tensor<4xi32>
+// CHECK:      %[[CAST1:.*]] = tensor.cast %[[NTT_POLY1]] : [[NTT_TENSOR_TYPE]] to tensor<4xi32>
+// EXT:        %[[ENC0:.*]] = mod_arith.encapsulate %[[CAST0]] : tensor<4xi32> -> [[MOD_TENSOR_TYPE:.*]]
+// EXT:        %[[ENC1:.*]] = mod_arith.encapsulate %[[CAST1]] : tensor<4xi32> -> [[MOD_TENSOR_TYPE]]
+// EXT:        %[[MUL:.*]] = mod_arith.mul %[[ENC0]], %[[ENC1]] : [[MOD_TENSOR_TYPE]]
+// EXT:        %[[NTT_RES:.*]] = mod_arith.extract %[[MUL]] : [[MOD_TENSOR_TYPE]] -> tensor<4xi32>
+// ARITH:      %[[CMOD:.*]] = arith.constant dense<17> : tensor<4xi64>
+// ARITH:      %[[EXT0:.*]] = arith.extui %[[CAST0]] : tensor<4xi32> to tensor<4xi64>
+// ARITH:      %[[EXT1:.*]] = arith.extui %[[CAST1]] : tensor<4xi32> to tensor<4xi64>
+// ARITH:      %[[NTT_MUL:.*]] = arith.muli %[[EXT0]], %[[EXT1]] : tensor<4xi64>
+// ARITH:      %[[NTT_REM:.*]] = arith.remui %[[NTT_MUL]], %[[CMOD]] : tensor<4xi64>
+// ARITH:      %[[NTT_RES:.*]] = arith.trunci %[[NTT_REM]] : tensor<4xi64> to tensor<4xi32>
+// CHECK:      %[[NTT_RES_RING:.*]] = tensor.cast %[[NTT_RES]] : tensor<4xi32> to [[NTT_TENSOR_TYPE]]
+// CHECK:      %[[RES:.*]] = polynomial.intt %[[NTT_RES_RING]] {root = #polynomial.primitive_root<value = 9 : i32, degree = 8 : i32>} : [[NTT_TENSOR_TYPE]] -> [[POLY_TY]]
 // CHECK:      return %[[RES]] : [[POLY_TY]]
 func.func @rewrite_poly_mul(%poly0: !poly_ty, %poly1: !poly_ty) -> !poly_ty {
   %poly = polynomial.mul %poly0, %poly1 : !poly_ty
   return %poly : !poly_ty
 }
 
+// The degree of the polynomial modulus is not a power of two.
 #bad_ideal = #polynomial.int_polynomial<1 + x**6>
-#bad_ring = #polynomial.ring<coefficientType=!modarith.modarith<17 : i32:i32>, polynomialModulus=#bad_ideal>
+#bad_ring = #polynomial.ring<coefficientType=!coeff_ty, polynomialModulus=#bad_ideal>
 !bad_poly_ty = !polynomial.polynomial<ring=#bad_ring>
 
 // CHECK: func.func @rewrite_bad_poly_mul
+// CHECK-NOT:  polynomial.ntt
 // CHECK:      %[[POLYMUL:.*]] = polynomial.mul
 // CHECK:      return %[[POLYMUL]]
 func.func @rewrite_bad_poly_mul(%poly0: !bad_poly_ty, %poly1: !bad_poly_ty) -> !bad_poly_ty {
   %poly = polynomial.mul %poly0, %poly1 : !bad_poly_ty
   return %poly : !bad_poly_ty
 }
+
+// 8 does not divide 19 - 1, so there is no primitive 8-th root of unity.
+!no_root_coeff_ty = !mod_arith.int<19:i32>
+#no_root_ring = #polynomial.ring<coefficientType=!no_root_coeff_ty, polynomialModulus=#ideal>
+!no_root_poly_ty = !polynomial.polynomial<ring=#no_root_ring>
+
+// CHECK: func.func @rewrite_no_root_poly_mul
+// CHECK-NOT:  polynomial.ntt
+// CHECK:      %[[POLYMUL:.*]] = polynomial.mul
+// CHECK:      return %[[POLYMUL]]
+func.func @rewrite_no_root_poly_mul(%poly0: !no_root_poly_ty, %poly1: !no_root_poly_ty) -> !no_root_poly_ty {
+  %poly = polynomial.mul %poly0, %poly1 : !no_root_poly_ty
+  return %poly : !no_root_poly_ty
+}
+
+// The polynomial modulus is not of the form x^n + 1.
+#cyclic_ideal = #polynomial.int_polynomial<-1 + x**4>
+#cyclic_ring = #polynomial.ring<coefficientType=!coeff_ty, polynomialModulus=#cyclic_ideal>
+!cyclic_poly_ty = !polynomial.polynomial<ring=#cyclic_ring>
+
+// CHECK: func.func @rewrite_cyclic_poly_mul
+// CHECK-NOT:  polynomial.ntt
+// CHECK:      %[[POLYMUL:.*]] = polynomial.mul
+// CHECK:      return %[[POLYMUL]]
+func.func @rewrite_cyclic_poly_mul(%poly0: !cyclic_poly_ty, %poly1: !cyclic_poly_ty) -> !cyclic_poly_ty {
+  %poly = polynomial.mul %poly0, %poly1 : !cyclic_poly_ty
+  return %poly : !cyclic_poly_ty
+}
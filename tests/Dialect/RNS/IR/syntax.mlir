@@ -58,3 +58,49 @@ func.func @test_syntax_modarith(%arg0: !ty_modarith) -> !ty_modarith {
 
 // expected-error@+1 {{does not have RNSBasisTypeInterface}}
 !ty_int_bad = !rns.rns<i32, i64>
+
+// -----
+
+#ideal = #polynomial.int_polynomial<1 + x**1024>
+#ring_1 = #polynomial.ring<coefficientType=!mod_arith.int<3721063133:i32>, polynomialModulus=#ideal>
+#ring_2 = #polynomial.ring<coefficientType=!mod_arith.int<2737228591:i32>, polynomialModulus=#ideal>
+!poly_ty_1 = !polynomial.polynomial<ring=#ring_1>
+!poly_ty_2 = !polynomial.polynomial<ring=#ring_2>
+!ty = !rns.rns<!poly_ty_1, !poly_ty_2>
+
+func.func @test_pack_unpack(%arg0: !ty) -> !ty {
+  %0:2 = rns.unpack %arg0 : !ty -> (!poly_ty_1, !poly_ty_2)
+  %1 = rns.pack %0#0, %0#1 : (!poly_ty_1, !poly_ty_2) -> !ty
+  return %1 : !ty
+}
+
+func.func @test_pack_bad(%arg0: !poly_ty_1, %arg1: !poly_ty_2) -> !ty {
+  // expected-error@+1 {{expected limb types to match the basis types}}
+  %0 = rns.pack %arg1, %arg0 : (!poly_ty_2, !poly_ty_1) -> !ty
+  return %0 : !ty
+}
+
+// -----
+
+#ideal = #polynomial.int_polynomial<1 + x**1024>
+#ring_1 = #polynomial.ring<coefficientType=!mod_arith.int<3721063133:i64>, polynomialModulus=#ideal>
+#ring_2 = #polynomial.ring<coefficientType=!mod_arith.int<2737228591:i64>, polynomialModulus=#ideal>
+#ring_3 = #polynomial.ring<coefficientType=!mod_arith.int<3180146689:i64>, polynomialModulus=#ideal>
+!poly_ty_1 = !polynomial.polynomial<ring=#ring_1>
+!poly_ty_2 = !polynomial.polynomial<ring=#ring_2>
+!poly_ty_3 = !polynomial.polynomial<ring=#ring_3>
+!ty = !rns.rns<!poly_ty_1, !poly_ty_2>
+!ext_ty = !rns.rns<!poly_ty_1, !poly_ty_2, !poly_ty_3>
+
+func.func @test_extend_and_rescale(%arg0: !ty) -> !ty {
+  %0 = rns.extend_basis %arg0 : !ty -> !ext_ty
+  %1 = rns.rescale %0 : !ext_ty -> !ty
+  %2 = rns.rescale %0 {plaintext_modulus = 65537 : i64} : !ext_ty -> !ty
+  return %2 : !ty
+}
+
+func.func @test_rescale_bad(%arg0: !ext_ty) -> !ext_ty {
+  // expected-error@+1 {{expected the output basis types to be the input basis types without the last one}}
+  %0 = rns.rescale %arg0 : !ext_ty -> !ext_ty
+  return %0 : !ext_ty
+}
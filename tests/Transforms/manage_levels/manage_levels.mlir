@@ -0,0 +1,143 @@
+// RUN: heir-opt --manage-levels="moduli=17,41,97 strategy=eager" %s | FileCheck %s --check-prefix=EAGER
+// RUN: heir-opt --manage-levels="moduli=17,41,97 strategy=lazy" %s | FileCheck %s --check-prefix=LAZY
+
+#encoding = #lwe.polynomial_evaluation_encoding<cleartext_start=30, cleartext_bitwidth=3>
+#my_poly = #polynomial.int_polynomial<1 + x**1024>
+// 67609 = 17 * 41 * 97
+#ring = #polynomial.ring<coefficientType=!mod_arith.int<67609:i32>, polynomialModulus=#my_poly>
+#params = #lwe.rlwe_params<dimension=2, ring=#ring>
+#params1 = #lwe.rlwe_params<dimension=3, ring=#ring>
+
+!pt = !lwe.rlwe_plaintext<encoding=#encoding, ring=#ring, underlying_type=i3>
+!ct = !lwe.rlwe_ciphertext<encoding=#encoding, rlwe_params=#params, underlying_type=i3>
+!ct1 = !lwe.rlwe_ciphertext<encoding=#encoding, rlwe_params=#params1, underlying_type=i3>
+
+// Each product is switched after its relinearization, and %x is switched to
+// the level of the sum before the last multiplication.
+// EAGER-LABEL: func.func @sum_of_products
+// EAGER-SAME:    %[[X:[^:]*]]: !lwe.rlwe_ciphertext
+// EAGER-SAME:    %[[Y:[^:]*]]: !lwe.rlwe_ciphertext
+// EAGER-SAME:    %[[Z:[^:]*]]: !lwe.rlwe_ciphertext
+// EAGER-SAME:    -> !lwe.rlwe_ciphertext<{{.*}}mod_arith.int<17 : i32>
+// EAGER-NEXT:    %[[X1:.*]] = bgv.modulus_switch %[[X]] {{.*}}mod_arith.int<697 : i32>
+// EAGER-NEXT:    %[[MUL0:.*]] = bgv.mul %[[X]], %[[Y]]
+// EAGER-NEXT:    %[[RELIN0:.*]] = bgv.relinearize %[[MUL0]]
+// EAGER-NEXT:    %[[SWITCH0:.*]] = bgv.modulus_switch %[[RELIN0]] {{.*}}mod_arith.int<697 : i32>
+// EAGER-NEXT:    %[[MUL1:.*]] = bgv.mul %[[Z]], %[[Z]]
+// EAGER-NEXT:    %[[RELIN1:.*]] = bgv.relinearize %[[MUL1]]
+// EAGER-NEXT:    %[[SWITCH1:.*]] = bgv.modulus_switch %[[RELIN1]] {{.*}}mod_arith.int<697 : i32>
+// EAGER-NEXT:    %[[ADD:.*]] = bgv.add %[[SWITCH0]], %[[SWITCH1]]
+// EAGER-NEXT:    %[[MUL2:.*]] = bgv.mul %[[ADD]], %[[X1]]
+// EAGER-NEXT:    %[[RELIN2:.*]] = bgv.relinearize %[[MUL2]]
+// EAGER-NEXT:    %[[SWITCH2:.*]] = bgv.modulus_switch %[[RELIN2]] {{.*}}mod_arith.int<17 : i32>
+// EAGER-NEXT:    return %[[SWITCH2]]
+
+// The products are summed at the top level, and only the sum is switched
+// before it is multiplied again.
+// LAZY-LABEL: func.func @sum_of_products
+// LAZY-SAME:    %[[X:[^:]*]]: !lwe.rlwe_ciphertext
+// LAZY-SAME:    %[[Y:[^:]*]]: !lwe.rlwe_ciphertext
+// LAZY-SAME:    %[[Z:[^:]*]]: !lwe.rlwe_ciphertext
+// LAZY-SAME:    -> !lwe.rlwe_ciphertext<{{.*}}mod_arith.int<697 : i32>
+// LAZY-NEXT:    %[[X1:.*]] = bgv.modulus_switch %[[X]] {{.*}}mod_arith.int<697 : i32>
+// LAZY-NEXT:    %[[MUL0:.*]] = bgv.mul %[[X]], %[[Y]]
+// LAZY-NEXT:    %[[RELIN0:.*]] = bgv.relinearize %[[MUL0]]
+// LAZY-NEXT:    %[[MUL1:.*]] = bgv.mul %[[Z]], %[[Z]]
+// LAZY-NEXT:    %[[RELIN1:.*]] = bgv.relinearize %[[MUL1]]
+// LAZY-NEXT:    %[[ADD:.*]] = bgv.add %[[RELIN0]], %[[RELIN1]]
+// LAZY-NEXT:    %[[SWITCH:.*]] = bgv.modulus_switch %[[ADD]] {{.*}}mod_arith.int<697 : i32>
+// LAZY-NEXT:    %[[MUL2:.*]] = bgv.mul %[[SWITCH]], %[[X1]]
+// LAZY-NEXT:    %[[RELIN2:.*]] = bgv.relinearize %[[MUL2]]
+// LAZY-NEXT:    return %[[RELIN2]]
+func.func @sum_of_products(%x: !ct, %y: !ct, %z: !ct) -> !ct {
+  %0 = bgv.mul %x, %y : (!ct, !ct) -> !ct1
+  %1 = bgv.relinearize %0 {from_basis = array<i32: 0, 1, 2>, to_basis = array<i32: 0, 1>} : !ct1 -> !ct
+  %2 = bgv.mul %z, %z : (!ct, !ct) -> !ct1
+  %3 = bgv.relinearize %2 {from_basis = array<i32: 0, 1, 2>, to_basis = array<i32: 0, 1>} : !ct1 -> !ct
+  %4 = bgv.add %1, %3 : !ct
+  %5 = bgv.mul %4, %x : (!ct, !ct) -> !ct1
+  %6 = bgv.relinearize %5 {from_basis = array<i32: 0, 1, 2>, to_basis = array<i32: 0, 1>} : !ct1 -> !ct
+  return %6 : !ct
+}
+
+// The plaintext is re-encoded at the level of the product.
+// EAGER-LABEL: func.func @mul_plain_after_mul
+// EAGER:         %[[PT:.*]] = lwe.rlwe_encode
+// EAGER-NEXT:    %[[PT1:.*]] = lwe.rlwe_encode {{.*}}mod_arith.int<697 : i32>
+// EAGER:         %[[SWITCH:.*]] = bgv.modulus_switch
+// EAGER-NEXT:    bgv.mul_plain %[[SWITCH]], %[[PT1]]
+func.func @mul_plain_after_mul(%x: !ct, %arg: i3) -> !ct {
+  %pt = lwe.rlwe_encode %arg {encoding = #encoding, ring = #ring} : i3 -> !pt
+  %0 = bgv.mul %x, %x : (!ct, !ct) -> !ct1
+  %1 = bgv.relinearize %0 {from_basis = array<i32: 0, 1, 2>, to_basis = array<i32: 0, 1>} : !ct1 -> !ct
+  %2 = bgv.mul_plain %1, %pt : (!ct, !pt) -> !ct
+  return %2 : !ct
+}
+
+// The callee is managed first, and the call gets the level of its result.
+// EAGER-LABEL: func.func @call_square
+// EAGER-SAME:    %[[X:[^:]*]]: !lwe.rlwe_ciphertext
+// EAGER-SAME:    %[[Y:[^:]*]]: !lwe.rlwe_ciphertext
+// EAGER-SAME:    -> !lwe.rlwe_ciphertext<{{.*}}mod_arith.int<697 : i32>
+// EAGER-NEXT:    %[[Y1:.*]] = bgv.modulus_switch %[[Y]] {{.*}}mod_arith.int<697 : i32>
+// EAGER-NEXT:    %[[SQUARE:.*]] = call @square(%[[X]]) {{.*}}-> !lwe.rlwe_ciphertext<{{.*}}mod_arith.int<697 : i32>
+// EAGER-NEXT:    %[[ADD:.*]] = bgv.add %[[SQUARE]], %[[Y1]]
+// EAGER-NEXT:    return %[[ADD]]
+// EAGER-LABEL: func.func @square
+// EAGER-SAME:    -> !lwe.rlwe_ciphertext<{{.*}}mod_arith.int<697 : i32>
+
+// LAZY-LABEL: func.func @call_square
+// LAZY-SAME:    -> !lwe.rlwe_ciphertext<{{.*}}mod_arith.int<67609 : i32>
+// LAZY-NEXT:    %[[SQUARE:.*]] = call @square
+// LAZY-NEXT:    %[[ADD:.*]] = bgv.add %[[SQUARE]]
+// LAZY-NEXT:    return %[[ADD]]
+func.func @call_square(%x: !ct, %y: !ct) -> !ct {
+  %0 = func.call @square(%x) : (!ct) -> !ct
+  %1 = bgv.add %0, %y : !ct
+  return %1 : !ct
+}
+
+func.func @square(%x: !ct) -> !ct {
+  %0 = bgv.mul %x, %x : (!ct, !ct) -> !ct1
+  %1 = bgv.relinearize %0 {from_basis = array<i32: 0, 1, 2>, to_basis = array<i32: 0, 1>} : !ct1 -> !ct
+  return %1 : !ct
+}
+
+// Only the products are rescaled, and the fresh %x is aligned to their levels
+// without changing its scale.
+// EAGER-LABEL: func.func @ckks_fresh_and_product
+// EAGER-SAME:    %[[X:[^:]*]]: !lwe.rlwe_ciphertext
+// EAGER-SAME:    %[[Y:[^:]*]]: !lwe.rlwe_ciphertext
+// EAGER-NEXT:    %[[X1:.*]] = ckks.level_reduce %[[X]] {{.*}}mod_arith.int<697 : i32>
+// EAGER-NEXT:    %[[X0:.*]] = ckks.level_reduce %[[X1]] {{.*}}mod_arith.int<17 : i32>
+// EAGER-NEXT:    %[[MUL0:.*]] = ckks.mul %[[X]], %[[Y]]
+// EAGER-NEXT:    %[[RELIN0:.*]] = ckks.relinearize %[[MUL0]]
+// EAGER-NEXT:    %[[RESCALE0:.*]] = ckks.rescale %[[RELIN0]] {{.*}}mod_arith.int<697 : i32>
+// EAGER-NEXT:    %[[MUL1:.*]] = ckks.mul %[[RESCALE0]], %[[X1]]
+// EAGER-NEXT:    %[[RELIN1:.*]] = ckks.relinearize %[[MUL1]]
+// EAGER-NEXT:    %[[RESCALE1:.*]] = ckks.rescale %[[RELIN1]] {{.*}}mod_arith.int<17 : i32>
+// EAGER-NEXT:    %[[ADD:.*]] = ckks.add %[[RESCALE1]], %[[X0]]
+// EAGER-NEXT:    return %[[ADD]]
+
+// The last product is rescaled before it is added to the fresh %x.
+// LAZY-LABEL: func.func @ckks_fresh_and_product
+// LAZY-SAME:    %[[X:[^:]*]]: !lwe.rlwe_ciphertext
+// LAZY-SAME:    %[[Y:[^:]*]]: !lwe.rlwe_ciphertext
+// LAZY-NEXT:    %[[X1:.*]] = ckks.level_reduce %[[X]] {{.*}}mod_arith.int<697 : i32>
+// LAZY-NEXT:    %[[X0:.*]] = ckks.level_reduce %[[X1]] {{.*}}mod_arith.int<17 : i32>
+// LAZY-NEXT:    %[[MUL0:.*]] = ckks.mul %[[X]], %[[Y]]
+// LAZY-NEXT:    %[[RELIN0:.*]] = ckks.relinearize %[[MUL0]]
+// LAZY-NEXT:    %[[RESCALE0:.*]] = ckks.rescale %[[RELIN0]] {{.*}}mod_arith.int<697 : i32>
+// LAZY-NEXT:    %[[MUL1:.*]] = ckks.mul %[[RESCALE0]], %[[X1]]
+// LAZY-NEXT:    %[[RELIN1:.*]] = ckks.relinearize %[[MUL1]]
+// LAZY-NEXT:    %[[RESCALE1:.*]] = ckks.rescale %[[RELIN1]] {{.*}}mod_arith.int<17 : i32>
+// LAZY-NEXT:    %[[ADD:.*]] = ckks.add %[[RESCALE1]], %[[X0]]
+// LAZY-NEXT:    return %[[ADD]]
+func.func @ckks_fresh_and_product(%x: !ct, %y: !ct) -> !ct {
+  %0 = ckks.mul %x, %y : (!ct, !ct) -> !ct1
+  %1 = ckks.relinearize %0 {from_basis = array<i32: 0, 1, 2>, to_basis = array<i32: 0, 1>} : !ct1 -> !ct
+  %2 = ckks.mul %1, %x : (!ct, !ct) -> !ct1
+  %3 = ckks.relinearize %2 {from_basis = array<i32: 0, 1, 2>, to_basis = array<i32: 0, 1>} : !ct1 -> !ct
+  %4 = ckks.add %3, %x : !ct
+  return %4 : !ct
+}
@@ -1,4 +1,5 @@
 // RUN: heir-opt --optimize-relinearization %s | FileCheck %s
+// RUN: heir-opt --optimize-relinearization=max-ilp-size=0 %s | FileCheck %s
 
 #encoding = #lwe.polynomial_evaluation_encoding<cleartext_start=30, cleartext_bitwidth=3>
 #my_poly = #polynomial.int_polynomial<1 + x**1024>
@@ -160,3 +161,27 @@ func.func @rotation_needs_linear_inputs(%arg0: !ct, %arg1: !ct) -> !ct {
   %7 = bgv.add %1, %6 : !ct
   func.return %7 : !ct
 }
+
+// 67609 = 17 * 41 * 97
+#ring_l2 = #polynomial.ring<coefficientType=!mod_arith.int<67609:i32>, polynomialModulus=#my_poly>
+#ring_l0 = #polynomial.ring<coefficientType=!mod_arith.int<17:i32>, polynomialModulus=#my_poly>
+#params_l2 = #lwe.rlwe_params<dimension=2, ring=#ring_l2>
+#params1_l2 = #lwe.rlwe_params<dimension=3, ring=#ring_l2>
+#params_l0 = #lwe.rlwe_params<dimension=2, ring=#ring_l0>
+!ct_l2 = !lwe.rlwe_ciphertext<encoding=#encoding, rlwe_params=#params_l2, underlying_type=i3>
+!ct1_l2 = !lwe.rlwe_ciphertext<encoding=#encoding, rlwe_params=#params1_l2, underlying_type=i3>
+!ct_l0 = !lwe.rlwe_ciphertext<encoding=#encoding, rlwe_params=#params_l0, underlying_type=i3>
+
+// Relinearizing after the modulus switch key switches a ciphertext with a
+// smaller coefficient modulus, which is cheaper than relinearizing before it.
+// CHECK-LABEL: func.func @relinearize_at_lower_level
+// CHECK-NEXT: bgv.mul
+// CHECK-NEXT: bgv.modulus_switch
+// CHECK-NEXT: bgv.relinearize
+// CHECK-NEXT: return
+func.func @relinearize_at_lower_level(%arg0: !ct_l2, %arg1: !ct_l2) -> !ct_l0 {
+  %0 = bgv.mul %arg0, %arg1 : (!ct_l2, !ct_l2) -> !ct1_l2
+  %1 = bgv.relinearize %0  {from_basis = array<i32: 0, 1, 2>, to_basis = array<i32: 0, 1> } : !ct1_l2 -> !ct_l2
+  %2 = bgv.modulus_switch %1 {to_ring = #ring_l0} : !ct_l2 -> !ct_l0
+  func.return %2 : !ct_l0
+}
@@ -0,0 +1,44 @@
+// RUN: heir-opt --optimize-relinearization="max-ilp-size=0 report-optimality-gap=true" --verify-diagnostics %s | FileCheck %s
+
+#encoding = #lwe.polynomial_evaluation_encoding<cleartext_start=30, cleartext_bitwidth=3>
+#my_poly = #polynomial.int_polynomial<1 + x**1024>
+#ring = #polynomial.ring<coefficientType=!mod_arith.int<161729713:i32>, polynomialModulus=#my_poly>
+#params = #lwe.rlwe_params<dimension=2, ring=#ring>
+#params1 = #lwe.rlwe_params<dimension=3, ring=#ring>
+
+!ct = !lwe.rlwe_ciphertext<encoding=#encoding, rlwe_params=#params, underlying_type=i3>
+!ct1 = !lwe.rlwe_ciphertext<encoding=#encoding, rlwe_params=#params1, underlying_type=i3>
+
+// The greedy heuristic relinearizes the products before they are returned.
+// CHECK-LABEL: func.func @independent_products
+// CHECK-NEXT: bgv.mul
+// CHECK-NEXT: bgv.relinearize
+// CHECK-NEXT: bgv.mul
+// CHECK-NEXT: bgv.relinearize
+// CHECK-NEXT: return
+// expected-remark@below {{modeled cost 3612.0, lower bound 3612.0, optimality gap 0.00%}}
+func.func @independent_products(%arg0: !ct, %arg1: !ct) -> (!ct, !ct) {
+  %0 = bgv.mul %arg0, %arg0 : (!ct, !ct) -> !ct1
+  %1 = bgv.relinearize %0  {from_basis = array<i32: 0, 1, 2>, to_basis = array<i32: 0, 1> } : !ct1 -> !ct
+  %2 = bgv.mul %arg1, %arg1 : (!ct, !ct) -> !ct1
+  %3 = bgv.relinearize %2  {from_basis = array<i32: 0, 1, 2>, to_basis = array<i32: 0, 1> } : !ct1 -> !ct
+  func.return %1, %3 : !ct, !ct
+}
+
+// The greedy heuristic relinearizes the sum where it is returned, while the
+// optimal placement relinearizes the product so that the addition processes
+// one polynomial fewer. With a 28-bit modulus, the product costs 112, each
+// relinearization 14 + 1680, and the addition 21 on a quadratic ciphertext
+// and 14 on a linear one.
+// CHECK-LABEL: func.func @relinearize_late
+// CHECK-NEXT: bgv.mul
+// CHECK-NEXT: bgv.add
+// CHECK-NEXT: bgv.relinearize
+// CHECK-NEXT: return
+// expected-remark@below {{modeled cost 1827.0, lower bound 1820.0, optimality gap 0.38%}}
+func.func @relinearize_late(%arg0: !ct) -> !ct {
+  %0 = bgv.mul %arg0, %arg0 : (!ct, !ct) -> !ct1
+  %1 = bgv.relinearize %0  {from_basis = array<i32: 0, 1, 2>, to_basis = array<i32: 0, 1> } : !ct1 -> !ct
+  %2 = bgv.add %1, %1 : !ct
+  func.return %2 : !ct
+}
@@ -0,0 +1,84 @@
+// RUN: heir-opt --slice-writes-to-forall %s | FileCheck %s
+
+// CHECK: func.func @loop_over_rows(%[[ARG:.*]]: tensor<2x4xi32>)
+// CHECK:      %[[EMPTY:.*]] = tensor.empty() : tensor<2x4xi32>
+// CHECK:      scf.forall (%[[I:.*]]) in (2) shared_outs(%[[OUT:.*]] = %[[EMPTY]]) -> (tensor<2x4xi32>) {
+// CHECK-NEXT:   %[[ROW:.*]] = tensor.extract_slice %[[ARG]][%[[I]], 0] [1, 4] [1, 1]
+// CHECK-NEXT:   %[[SQ:.*]] = arith.muli %[[ROW]], %[[ROW]]
+// CHECK-NEXT:   scf.forall.in_parallel {
+// CHECK-NEXT:     tensor.parallel_insert_slice %[[SQ]] into %[[OUT]][%[[I]], 0] [1, 4] [1, 1]
+// CHECK-NOT:  scf.for
+func.func @loop_over_rows(%x: tensor<2x4xi32>) -> tensor<2x4xi32> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c2 = arith.constant 2 : index
+  %empty = tensor.empty() : tensor<2x4xi32>
+  %0 = scf.for %i = %c0 to %c2 step %c1 iter_args(%acc = %empty) -> (tensor<2x4xi32>) {
+    %row = tensor.extract_slice %x[%i, 0] [1, 4] [1, 1] : tensor<2x4xi32> to tensor<4xi32>
+    %sq = arith.muli %row, %row : tensor<4xi32>
+    %1 = tensor.insert_slice %sq into %acc[%i, 0] [1, 4] [1, 1] : tensor<4xi32> into tensor<2x4xi32>
+    scf.yield %1 : tensor<2x4xi32>
+  }
+  return %0 : tensor<2x4xi32>
+}
+
+// Each iteration reads the row written by the previous one.
+// CHECK: func.func @loop_carried_row
+// CHECK:      scf.for
+// CHECK-NOT:  scf.forall
+func.func @loop_carried_row(%x: tensor<2x4xi32>) -> tensor<2x4xi32> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c2 = arith.constant 2 : index
+  %0 = scf.for %i = %c1 to %c2 step %c1 iter_args(%acc = %x) -> (tensor<2x4xi32>) {
+    %prev = arith.subi %i, %c1 : index
+    %row = tensor.extract_slice %acc[%prev, 0] [1, 4] [1, 1] : tensor<2x4xi32> to tensor<4xi32>
+    %sq = arith.muli %row, %row : tensor<4xi32>
+    %1 = tensor.insert_slice %sq into %acc[%i, 0] [1, 4] [1, 1] : tensor<4xi32> into tensor<2x4xi32>
+    scf.yield %1 : tensor<2x4xi32>
+  }
+  return %0 : tensor<2x4xi32>
+}
+
+// The limbs are reduced modulo different primes, so each iteration selects
+// the ops of its row.
+// CHECK: func.func @limbs(%[[ARG:.*]]: tensor<2x4xi32>)
+// CHECK:      %[[EMPTY:.*]] = tensor.empty() : tensor<2x4xi32>
+// CHECK:      scf.forall (%[[I:.*]]) in (2) shared_outs(%[[OUT:.*]] = %[[EMPTY]]) -> (tensor<2x4xi32>) {
+// CHECK-NEXT:   %[[LIMB:.*]] = scf.index_switch %[[I]] -> tensor<4xi32>
+// CHECK-NEXT:   case 0 {
+// CHECK:          %[[ROW0:.*]] = tensor.extract_slice %[[ARG]][0, 0] [1, 4] [1, 1]
+// CHECK-NEXT:     %[[REM0:.*]] = arith.remui %[[ROW0]]
+// CHECK-NEXT:     scf.yield %[[REM0]]
+// CHECK:        default {
+// CHECK:          %[[ROW1:.*]] = tensor.extract_slice %[[ARG]][1, 0] [1, 4] [1, 1]
+// CHECK-NEXT:     %[[REM1:.*]] = arith.remui %[[ROW1]]
+// CHECK-NEXT:     scf.yield %[[REM1]]
+// CHECK:        scf.forall.in_parallel {
+// CHECK-NEXT:     tensor.parallel_insert_slice %[[LIMB]] into %[[OUT]][%[[I]], 0] [1, 4] [1, 1]
+// CHECK-NOT:  tensor.insert_slice
+func.func @limbs(%x: tensor<2x4xi32>) -> tensor<2x4xi32> {
+  %q0 = arith.constant dense<17> : tensor<4xi32>
+  %q1 = arith.constant dense<19> : tensor<4xi32>
+  %row0 = tensor.extract_slice %x[0, 0] [1, 4] [1, 1] : tensor<2x4xi32> to tensor<4xi32>
+  %rem0 = arith.remui %row0, %q0 : tensor<4xi32>
+  %row1 = tensor.extract_slice %x[1, 0] [1, 4] [1, 1] : tensor<2x4xi32> to tensor<4xi32>
+  %rem1 = arith.remui %row1, %q1 : tensor<4xi32>
+  %empty = tensor.empty() : tensor<2x4xi32>
+  %0 = tensor.insert_slice %rem0 into %empty[0, 0] [1, 4] [1, 1] : tensor<4xi32> into tensor<2x4xi32>
+  %1 = tensor.insert_slice %rem1 into %0[1, 0] [1, 4] [1, 1] : tensor<4xi32> into tensor<2x4xi32>
+  return %1 : tensor<2x4xi32>
+}
+
+// The rows are copied without any computation, so there is nothing to run in
+// parallel.
+// CHECK: func.func @copied_limbs
+// CHECK:      tensor.insert_slice
+// CHECK:      tensor.insert_slice
+// CHECK-NOT:  scf.forall
+func.func @copied_limbs(%a: tensor<4xi32>, %b: tensor<4xi32>) -> tensor<2x4xi32> {
+  %empty = tensor.empty() : tensor<2x4xi32>
+  %0 = tensor.insert_slice %a into %empty[0, 0] [1, 4] [1, 1] : tensor<4xi32> into tensor<2x4xi32>
+  %1 = tensor.insert_slice %b into %0[1, 0] [1, 4] [1, 1] : tensor<4xi32> into tensor<2x4xi32>
+  return %1 : tensor<2x4xi32>
+}
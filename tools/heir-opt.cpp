@@ -24,6 +24,7 @@
 #include "lib/Dialect/Openfhe/IR/OpenfheDialect.h"
 #include "lib/Dialect/Openfhe/Transforms/Passes.h"
 #include "lib/Dialect/Polynomial/Conversions/PolynomialToModArith/PolynomialToModArith.h"
+#include "lib/Dialect/Polynomial/Conversions/PolynomialToRNS/PolynomialToRNS.h"
 #include "lib/Dialect/Polynomial/IR/PolynomialDialect.h"
 #include "lib/Dialect/Polynomial/Transforms/Passes.h"
 #include "lib/Dialect/RNS/IR/RNSDialect.h"
@@ -53,9 +54,11 @@
 #include "lib/Transforms/ForwardStoreToLoad/ForwardStoreToLoad.h"
 #include "lib/Transforms/FullLoopUnroll/FullLoopUnroll.h"
 #include "lib/Transforms/LinalgCanonicalizations/LinalgCanonicalizations.h"
+#include "lib/Transforms/ManageLevels/ManageLevels.h"
 #include "lib/Transforms/OperationBalancer/OperationBalancer.h"
 #include "lib/Transforms/OptimizeRelinearization/OptimizeRelinearization.h"
 #include "lib/Transforms/Secretize/Passes.h"
+#include "lib/Transforms/SliceWritesToForall/SliceWritesToForall.h"
 #include "lib/Transforms/StraightLineVectorizer/StraightLineVectorizer.h"
 #include "lib/Transforms/TensorToScalars/TensorToScalars.h"
 #include "lib/Transforms/UnusedMemRef/UnusedMemRef.h"
@@ -205,6 +208,7 @@ int main(int argc, char **argv) {
   openfhe::registerOpenfhePasses();
   registerElementwiseToAffinePasses();
   registerSecretizePasses();
+  registerSliceWritesToForallPasses();
   registerFullLoopUnrollPasses();
   registerConvertIfToSelectPasses();
   registerConvertSecretForToStaticForPasses();
@@ -218,6 +222,7 @@ int main(int argc, char **argv) {
   registerStraightLineVectorizerPasses();
   registerUnusedMemRefPasses();
   registerOptimizeRelinearizationPasses();
+  registerManageLevelsPasses();
   registerLinalgCanonicalizationsPasses();
   registerTensorToScalarsPasses();
   // Register yosys optimizer pipeline if configured.
@@ -254,6 +259,7 @@ int main(int argc, char **argv) {
   lwe::registerLWEToPolynomialPasses();
   ::mlir::heir::linalg::registerLinalgToTensorExtPasses();
   ::mlir::heir::polynomial::registerPolynomialToModArithPasses();
+  ::mlir::heir::polynomial::registerPolynomialToRNSPasses();
   registerCGGIToJaxitePasses();
   registerCGGIToTfheRustPasses();
   registerCGGIToTfheRustBoolPasses();
@@ -270,7 +276,7 @@ int main(int argc, char **argv) {
                              "quant types to arithmetic",
                              ::mlir::heir::tosaPipelineBuilder);
 
-  PassPipelineRegistration<>(
+  PassPipelineRegistration<mlir::heir::PolynomialToLLVMPipelineOptions>(
       "heir-polynomial-to-llvm",
       "Run passes to lower the polynomial dialect to LLVM",
       ::mlir::heir::polynomialToLLVMPipelineBuilder);